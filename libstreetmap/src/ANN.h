@@ -30,6 +30,9 @@
 //		Added fixed-radius k-NN searching
 //	Revision 1.1.2  01/27/10
 //		Fixed minor compilation bugs for new versions of gcc
+//	Local modification
+//		Moved the kd- and bd-tree search state from globals into
+//		ANNsearchContext, so that searches are reentrant
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
@@ -701,6 +704,45 @@ const int ANN_N_SHRINK_RULES	= 4;	// number of shrink rules
 class ANNkdStats;				// stats on kd-tree
 class ANNkd_node;				// generic node in a kd-tree
 typedef ANNkd_node*	ANNkd_ptr;	// pointer to a kd-tree node
+class ANNmin_k;					// k smallest keys (see src/pr_queue_k.h)
+class ANNpr_queue;				// priority queue (see src/pr_queue.h)
+
+//----------------------------------------------------------------------
+//	ANNsearchContext
+//		The state of a kd- or bd-tree search, shared by the recursive
+//		search procedures.  A search only touches the context it is
+//		given, so any number of threads may search the same tree at
+//		once, each with its own context.  The context keeps its buffers
+//		between searches, so searching again with at most the same k
+//		(and tree size, for priority search) allocates nothing.  The
+//		searches without a context argument use a temporary one.
+//----------------------------------------------------------------------
+
+class DLL_API ANNsearchContext {
+public:
+	ANNsearchContext();
+	~ANNsearchContext();
+
+	int				dim;				// dimension of space
+	ANNpoint		q;					// query point
+	double			maxErr;				// max tolerable squared error
+	ANNpointArray	pts;				// the points
+	ANNmin_k		*pointMK;			// set of k closest points
+	ANNpr_queue		*boxPQ;				// priority queue for boxes
+	ANNdist			sqRad;				// squared radius (fixed-radius)
+	int				ptsVisited;			// number of points visited
+	int				ptsInRange;			// points in range (fixed-radius)
+
+	ANNmin_k *closestSet(int k);		// empty set for k closest points
+	ANNpr_queue *boxQueue(int max);		// empty queue for max boxes
+
+private:
+	ANNmin_k		*closest;			// buffers reused between searches
+	ANNpr_queue		*boxes;
+
+	ANNsearchContext(const ANNsearchContext&);		// not copyable
+	void operator=(const ANNsearchContext&);
+};
 
 class DLL_API ANNkd_tree: public ANNpointSet {
 protected:
@@ -753,6 +795,32 @@ public:
 		double			eps=0.0);		// error bound
 
 	int annkFRSearch(					// approx fixed-radius kNN search
+		ANNpoint		q,				// the query point
+		ANNdist			sqRad,			// squared radius of query ball
+		int				k,				// number of neighbors to return
+		ANNidxArray		nn_idx = NULL,	// nearest neighbor array (modified)
+		ANNdistArray	dd = NULL,		// dist to near neighbors (modified)
+		double			eps=0.0);		// error bound
+
+										// reentrant versions of the above
+	void annkSearch(					// approx k near neighbor search
+		ANNsearchContext &ctx,			// search state (modified)
+		ANNpoint		q,				// query point
+		int				k,				// number of near neighbors to return
+		ANNidxArray		nn_idx,			// nearest neighbor array (modified)
+		ANNdistArray	dd,				// dist to near neighbors (modified)
+		double			eps=0.0);		// error bound
+
+	void annkPriSearch( 				// priority k near neighbor search
+		ANNsearchContext &ctx,			// search state (modified)
+		ANNpoint		q,				// query point
+		int				k,				// number of near neighbors to return
+		ANNidxArray		nn_idx,			// nearest neighbor array (modified)
+		ANNdistArray	dd,				// dist to near neighbors (modified)
+		double			eps=0.0);		// error bound
+
+	int annkFRSearch(					// approx fixed-radius kNN search
+		ANNsearchContext &ctx,			// search state (modified)
 		ANNpoint		q,				// the query point
 		ANNdist			sqRad,			// squared radius of query ball
 		int				k,				// number of neighbors to return
@@ -0,0 +1,151 @@
+/*
+ * File:   BoxIndex.cpp
+ */
+
+// Boost 1.74's R-tree includes headers of its own that boost deprecated
+#define BOOST_ALLOW_DEPRECATED_HEADERS
+
+// Before the headers with a using namespace std, after which boost.geometry
+// doesn't compile. Not the whole of boost/geometry.hpp, whose point_xy.hpp
+// doesn't compile after one either.
+#include <boost/geometry/geometries/box.hpp>
+#include <boost/geometry/geometries/point.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
+#include "BoxIndex.h"
+#include "MapContext.h"
+#include "StreetsDatabaseAPI.h"
+
+#include <algorithm>
+#include <utility>
+
+// (lon, lat) in degrees
+typedef boost::geometry::model::point<double, 2,
+        boost::geometry::cs::cartesian> Point;
+typedef boost::geometry::model::box<Point> Box;
+typedef pair<Box, unsigned> Entry;
+typedef boost::geometry::index::rtree<Entry,
+        boost::geometry::index::quadratic<16> > Tree;
+
+struct BoxIndex::Trees {
+    Tree intersectionTree;
+    Tree segmentTree;
+    Tree featureTree;
+    Tree poiTree;
+};
+
+static Box boxOf(const LatLon* points, unsigned count);
+static Box boxOf(LatLon corner1, LatLon corner2);
+static vector<unsigned> query(const Tree& tree, const Box& box);
+
+BoxIndex::BoxIndex() :
+    trees(new Trees()) {
+}
+
+BoxIndex::~BoxIndex() {
+}
+
+// Function to access the instance of the current map context
+BoxIndex& BoxIndex::getInstance() {
+    return MapContext::current().getBoxIndex();
+}
+
+void BoxIndex::build() {
+    clear();
+
+    // The range constructor bulk loads the trees
+    unsigned numberOfIntersections = getNumberOfIntersections();
+    vector<Entry> entries(numberOfIntersections);
+    for (unsigned intersectionID = 0;
+            intersectionID < numberOfIntersections;
+            intersectionID++) {
+        LatLon position = getIntersectionPosition(intersectionID);
+        entries[intersectionID] = Entry(boxOf(&position, 1), intersectionID);
+    }
+    trees->intersectionTree = Tree(entries);
+
+    unsigned numberOfSegments = getNumberOfStreetSegments();
+    entries.resize(numberOfSegments);
+    vector<LatLon> points;
+    for (unsigned segmentID = 0; segmentID < numberOfSegments; segmentID++) {
+        StreetSegmentInfo segmentInfo = getStreetSegmentInfo(segmentID);
+        const LatLon* curvePoints = getStreetSegmentCurvePoints(segmentID);
+        points.assign(curvePoints, curvePoints + segmentInfo.curvePointCount);
+        points.push_back(getIntersectionPosition(segmentInfo.from));
+        points.push_back(getIntersectionPosition(segmentInfo.to));
+        entries[segmentID] = Entry(boxOf(points.data(), points.size()), segmentID);
+    }
+    trees->segmentTree = Tree(entries);
+
+    // Features without points have no box, and are never found
+    unsigned numberOfFeatures = getNumberOfFeatures();
+    entries.clear();
+    for (unsigned featureID = 0; featureID < numberOfFeatures; featureID++) {
+        unsigned numberOfPoints = getFeaturePointCount(featureID);
+        if (numberOfPoints == 0)
+            continue;
+        entries.push_back(Entry(boxOf(getFeaturePoints(featureID), numberOfPoints),
+                featureID));
+    }
+    trees->featureTree = Tree(entries);
+
+    unsigned numberOfPOIs = getNumberOfPointsOfInterest();
+    entries.resize(numberOfPOIs);
+    for (unsigned poiID = 0; poiID < numberOfPOIs; poiID++) {
+        LatLon position = getPointOfInterestPosition(poiID);
+        entries[poiID] = Entry(boxOf(&position, 1), poiID);
+    }
+    trees->poiTree = Tree(entries);
+}
+
+void BoxIndex::clear() {
+    trees->intersectionTree.clear();
+    trees->segmentTree.clear();
+    trees->featureTree.clear();
+    trees->poiTree.clear();
+}
+
+vector<unsigned> BoxIndex::intersections(LatLon corner1, LatLon corner2) const {
+    return query(trees->intersectionTree, boxOf(corner1, corner2));
+}
+
+vector<unsigned> BoxIndex::streetSegments(LatLon corner1, LatLon corner2) const {
+    return query(trees->segmentTree, boxOf(corner1, corner2));
+}
+
+vector<unsigned> BoxIndex::features(LatLon corner1, LatLon corner2) const {
+    return query(trees->featureTree, boxOf(corner1, corner2));
+}
+
+vector<unsigned> BoxIndex::pointsOfInterest(LatLon corner1, LatLon corner2) const {
+    return query(trees->poiTree, boxOf(corner1, corner2));
+}
+
+// The bounding box of count (at least one) points
+static Box boxOf(const LatLon* points, unsigned count) {
+    double minLat = points[0].lat, maxLat = points[0].lat;
+    double minLon = points[0].lon, maxLon = points[0].lon;
+    for (unsigned i = 1; i < count; i++) {
+        minLat = min(minLat, (double) points[i].lat);
+        maxLat = max(maxLat, (double) points[i].lat);
+        minLon = min(minLon, (double) points[i].lon);
+        maxLon = max(maxLon, (double) points[i].lon);
+    }
+    return Box(Point(minLon, minLat), Point(maxLon, maxLat));
+}
+
+static Box boxOf(LatLon corner1, LatLon corner2) {
+    LatLon corners[2] = {corner1, corner2};
+    return boxOf(corners, 2);
+}
+
+static vector<unsigned> query(const Tree& tree, const Box& box) {
+    vector<unsigned> ids;
+    for (auto entryIter = tree.qbegin(boost::geometry::index::intersects(box));
+            entryIter != tree.qend();
+            entryIter++) {
+        ids.push_back(entryIter->second);
+    }
+    sort(ids.begin(), ids.end());
+    return ids;
+}
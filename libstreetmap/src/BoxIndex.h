@@ -0,0 +1,59 @@
+/*
+ * File:   BoxIndex.h
+ */
+
+/* R-trees over the bounding boxes of the intersections, street segments
+ * (with their curve points), features and points of interest, built at
+ * load_map so that finding what lies in a rectangle of the map (the visible
+ * part of the map, a region to export) visits the few tree nodes overlapping
+ * it instead of every item.
+ *
+ * The trees are bulk loaded, which packs them (sort-tile-recursive), and
+ * are over latitude and longitude in degrees, so a box is given by two
+ * opposite corners and doesn't cross the antimeridian. An item is found if
+ * its bounding box touches the query box, so a segment or feature passing
+ * by a corner of the box can be found without actually entering it.
+ *
+ * Threads may query at once. */
+
+#ifndef BOXINDEX_H
+#define BOXINDEX_H
+
+#include <memory>
+#include <vector>
+
+#include "LatLon.h"
+
+using namespace std;
+
+class BoxIndex {
+public:
+    // The one of the current MapContext
+    static BoxIndex& getInstance();
+
+    // Builds the trees from the loaded streets database
+    void build();
+    void clear();
+
+    // The ids of the items whose bounding boxes touch the box with opposite
+    // corners corner1 and corner2, ascending
+    vector<unsigned> intersections(LatLon corner1, LatLon corner2) const;
+    vector<unsigned> streetSegments(LatLon corner1, LatLon corner2) const;
+    vector<unsigned> features(LatLon corner1, LatLon corner2) const;
+    vector<unsigned> pointsOfInterest(LatLon corner1, LatLon corner2) const;
+
+private:
+    // Owned by MapContext; getInstance returns the current context's
+    friend class MapContext;
+    BoxIndex();
+    ~BoxIndex();
+    BoxIndex(const BoxIndex&) = delete;
+    void operator=(const BoxIndex&) = delete;
+
+    // The trees, defined with the boost.geometry types in BoxIndex.cpp so
+    // that including this header doesn't include boost.geometry
+    struct Trees;
+    unique_ptr<Trees> trees;
+};
+
+#endif /* BOXINDEX_H */
@@ -20,13 +20,23 @@
 #include <unordered_map>
 #include <vector>
 
-#include "ANN.h"
+// unordered_map.hpp uses library_version_type without including it (boost 1.74)
+#include <boost/serialization/library_version_type.hpp>
+#include <boost/serialization/bitset.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/unordered_map.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include "ProjectedTree.h"
+#include "IdRange.h"
+#include "POIClassifier.h"
 #include "StreetsDatabaseAPI.h"
 
 using namespace std;
 
 class FastStructs {
 public:
+    // The one of the current MapContext
     static FastStructs& getInstance();
     
     virtual ~FastStructs();
@@ -35,27 +45,34 @@ public:
      following getters and setters will return */
     
     vector<unsigned> getStreetIDsFromName(string name);
+    IdRange getStreetIDRangeFromName(const string& name);
     void setStreets(const unordered_map<string, vector<unsigned>>& streetsCopy);
     
-    vector<unsigned>& getSegmentsAtIntersection(unsigned intersectionID);
-    vector<unsigned>& getAdjacentIntersections(unsigned intersectionID);
+    // The ranges point into the structures below, so they stay valid
+    // until the setters are called again
+    IdRange getSegmentsAtIntersection(unsigned intersectionID);
+    IdRange getAdjacentIntersections(unsigned intersectionID);
+    
+    // Binary search of the sorted adjacent intersections
+    bool isAdjacentIntersection(unsigned intersectionID, unsigned otherID);
     
     void setIntersectionSegments(const vector< vector<unsigned> >& intersectionSegmentsCopy);
     void setAdjacentIntersections(const vector< vector<unsigned> >& adjacentIntersectionsCopy);
     
-    vector<unsigned>& getSegmentsOnStreet(unsigned streetID);
-    vector<unsigned>& getIntersectionsOnStreet(unsigned streetID);
+    IdRange getSegmentsOnStreet(unsigned streetID);
+    IdRange getIntersectionsOnStreet(unsigned streetID);
     
     void setStreetStreetSegments(const vector< vector<unsigned> >& segmentsCopy);
     void setStreetIntersections(const vector< vector<unsigned> >& intersectionsCopy);
     
-    // Takes in a point (which is equivalent to an array of doubles),
-    // the numberOfNearest intersections to the point desired,
-    // and returns an array of intersectionIDs by populating
-    // the array nearIntersectionIDs.
-    void getClosestIntersectionIDs(ANNpoint point, 
-        ANNidxArray nearIntersectionIDs, unsigned numOfNearest);
-    void setIntersectionskdTree();
+    // Returns the intersection nearest to position and its distance,
+    // exactly as find_distance_between_two_points measures it (id 0 at an
+    // infinite distance if there are no intersections).
+    // Threads can search at once, each with its own searchContext.
+    ProjectedTree::Match getClosestIntersection(ANNsearchContext& searchContext,
+        LatLon position) const;
+    // Builds the kd tree, projected at latitude latRad (radians)
+    void setIntersectionskdTree(double latRad);
     
     // Getters and setters for street segment classifications
     vector<unsigned>& getLocalRoads();
@@ -91,16 +108,37 @@ public:
     vector<unsigned> getPOIiDsFromName(string name);
     void setPOIs(const unordered_map<string, vector<unsigned>>& poisCopy);
     
-    // Functions associated to poi types
-    void setpoiTags(const vector< vector<string> >& poiTagsCopy);
-    bool poiContainsTag(unsigned poiID, string tag);
-    string poiType(unsigned poiID);
-    string tagForAlias(string alias);
+    // Functions associated to poi types (see POIClassifier)
+    void setpoiClassifications(const vector<unsigned char>& poiCategoriesCopy,
+            const vector<POITagSet>& poiTagsCopy);
+    bool poiContainsTag(unsigned poiID, POITag tag) const {
+        return poiTags[poiID][tag];
+    }
+    POICategory poiCategory(unsigned poiID) const {
+        return (POICategory) poiCategories[poiID];
+    }
+    
+    // Distinct names of all streets and points of interest, sorted
+    const vector<string>& getSortedNames();
+    // The range [first, second) of the sorted names starting with prefix
+    pair<unsigned, unsigned> getNamesWithPrefix(const string& prefix);
+    void setAllNames(const vector<string>& allNamesCopy);
+    
+    // Persistent cache of everything above except the kd tree (which is
+    // quick to rebuild from the intersection positions). The file is tagged
+    // with cacheVersion and a key identifying the map files the structures
+    // were built from, and loadCache rejects it if either doesn't match.
+    // Bump cacheVersion whenever the serialized members change.
+    static const unsigned cacheVersion = 5;
+    bool saveCache(string fileName, unsigned long long mapKey);
+    bool loadCache(string fileName, unsigned long long mapKey);
     
 private:
-    // Can only be created by requesting the instance using
-    // getInstance, so constructor is private.
+    // Each MapContext owns one; everything else gets the current
+    // context's by requesting the instance using getInstance, so
+    // constructor is private.
     // Cannot be copy constructed. Cannot be copied.
+    friend class MapContext;
     FastStructs();                  
     FastStructs(const FastStructs& orig) = delete;
     void operator=(FastStructs const& rhs) = delete;
@@ -112,19 +150,22 @@ private:
     
     // Stores the street segments and adjacent intersections
     // at every intersection in the map.
-    // Outer vector is ordered by intersectionID
-    // (e.g. intersectionSegments[78] returns a vector
+    // Lists are ordered by intersectionID
+    // (e.g. intersectionSegments[78] returns the range
     // of street segments connected to intersectionID 78).
-    vector< vector<unsigned> > intersectionSegments;
-    vector< vector<unsigned> > adjacentIntersections;
+    // sortedAdjacentIntersections has the same lists as
+    // adjacentIntersections, each sorted by intersectionID.
+    IdLists intersectionSegments;
+    IdLists adjacentIntersections;
+    IdLists sortedAdjacentIntersections;
     
     // Stores the street segments and intersections
     // on every street in the map.
-    // Outer vector is ordered by streetID
-    // (e.g. streetStreetSegments[78] returns a vector
+    // Lists are ordered by streetID
+    // (e.g. streetStreetSegments[78] returns the range
     // of street segments on streetID 78).
-    vector< vector<unsigned> > streetStreetSegments;
-    vector< vector<unsigned> > streetIntersections;
+    IdLists streetStreetSegments;
+    IdLists streetIntersections;
     
     // Data for the kd tree, which allows for O(logn) lookups 
     // for nearest intersection to a point as opposed to O(n) 
@@ -132,9 +173,7 @@ private:
     // https://en.wikipedia.org/wiki/K-d_tree
     // The external library used is documented at:
     // https://www.cs.umd.edu/~mount/ANN/
-    ANNpointArray intersectionLocations;    // A list of intersection locations
-    ANNkd_tree *intersectionskdTree;        // required to build and maintain
-                                            // kd tree
+    ProjectedTree *intersectionskdTree;
     
     // Street segments separated by road class
     vector<unsigned> localRoads;
@@ -157,16 +196,24 @@ private:
     // name to its id(s)
     unordered_map<string, vector<unsigned>> pois; 
     
-    // Points of interest tags.
-    // Indices are poiID's and inner vectors
-    // are all tags associated with that poi
-    vector< vector<string> > poiTags;
-    
-    // Aliases for point of interest tags.
-    // Used in searching to map various different
-    // strings to tags used in the program.
-    unordered_map<string, string> tagAliases;
-    void setAliases();
+    // Points of interest categories (POICategory) and tags,
+    // indexed by poiID
+    vector<unsigned char> poiCategories;
+    vector<POITagSet> poiTags;
+    
+    // Distinct names of all streets and points of interest, sorted
+    // so that the names completing a prefix are contiguous. Used for
+    // tab completion of searches.
+    vector<string> allNames;
+    
+    template<class Archive>void serialize(Archive& ar, const unsigned ver) {
+        ar & streets & intersectionSegments & adjacentIntersections & sortedAdjacentIntersections;
+        ar & streetStreetSegments & streetIntersections;
+        ar & localRoads & commercialRoads & serviceRoads & motorways & highways;
+        ar & lakes & ponds & islands & greens & sands & rivers & buildings & unknowns;
+        ar & pois & poiCategories & poiTags & allNames;
+    }
+    friend class boost::serialization::access;
 };
 
 #endif /* FASTSTRUCTS_H */
@@ -0,0 +1,104 @@
+/*
+ * File:   IdRange.h
+ */
+
+/* IdRange is a read-only view of a run of ids (street segments,
+ * intersections or streets) stored by the loaded map, so that queries can
+ * hand out their results without copying them into a new vector. A range
+ * stays valid until the map it came from is closed or reloaded.
+ *
+ * IdLists stores one list of ids per index (e.g. the street segments of
+ * every intersection) in compressed sparse row form: all the lists back to
+ * back in one array, plus the offset at which each list starts. */
+
+#ifndef IDRANGE_H
+#define IDRANGE_H
+
+#include <algorithm>
+#include <vector>
+
+#include <boost/serialization/vector.hpp>
+
+using namespace std;
+
+class IdRange {
+public:
+    typedef const unsigned* const_iterator;
+    typedef const unsigned* iterator;
+
+    IdRange() : first(nullptr), last(nullptr) {}
+    IdRange(const unsigned* _first, const unsigned* _last) : first(_first), last(_last) {}
+
+    const unsigned* begin() const {
+        return first;
+    }
+
+    const unsigned* end() const {
+        return last;
+    }
+
+    unsigned size() const {
+        return last - first;
+    }
+
+    bool empty() const {
+        return first == last;
+    }
+
+    // Not range checked
+    unsigned operator[](unsigned idx) const {
+        return first[idx];
+    }
+
+    vector<unsigned> toVector() const {
+        return vector<unsigned>(first, last);
+    }
+
+private:
+    const unsigned* first;
+    const unsigned* last;
+};
+
+class IdLists {
+public:
+    // Replaces the lists with a copy of lists
+    void assign(const vector< vector<unsigned> >& lists) {
+        offsets.resize(lists.size() + 1);
+        offsets[0] = 0;
+        for (unsigned i = 0; i < lists.size(); i++)
+            offsets[i + 1] = offsets[i] + lists[i].size();
+
+        ids.clear();
+        ids.reserve(offsets.back());
+        for (const vector<unsigned>& list : lists)
+            ids.insert(ids.end(), list.begin(), list.end());
+    }
+
+    // Sorts the ids within each list
+    void sortEach() {
+        for (unsigned i = 0; i + 1 < offsets.size(); i++)
+            sort(ids.begin() + offsets[i], ids.begin() + offsets[i + 1]);
+    }
+
+    // Number of lists
+    unsigned size() const {
+        return offsets.empty() ? 0 : offsets.size() - 1;
+    }
+
+    // The list at idx, which is not range checked
+    IdRange operator[](unsigned idx) const {
+        const unsigned* base = ids.data();
+        return IdRange(base + offsets[idx], base + offsets[idx + 1]);
+    }
+
+private:
+    vector<unsigned> offsets;   // list i is ids[offsets[i], offsets[i+1])
+    vector<unsigned> ids;
+
+    template<class Archive>void serialize(Archive& ar, const unsigned ver) {
+        ar & offsets & ids;
+    }
+    friend class boost::serialization::access;
+};
+
+#endif /* IDRANGE_H */
@@ -0,0 +1,143 @@
+/*
+ * File:   MapContext.cpp
+ */
+
+#include "MapContext.h"
+#include "m1.h"
+
+#include <atomic>
+
+// The context bound to each thread, and the one selected for the process
+// (nullptr for none)
+static thread_local MapContext* boundContext = nullptr;
+static atomic<MapContext*> selectedContext(nullptr);
+
+MapContext::MapContext() :
+    streets(createStreetsDatabaseContext()),
+    osm(createOSMDatabaseContext()),
+    averageLatRad(0.0) {
+}
+
+MapContext::MapContext(StreetsDatabaseContext* streetsContext, OSMDatabaseContext* osmContext) :
+    streets(streetsContext),
+    osm(osmContext),
+    averageLatRad(0.0) {
+}
+
+MapContext::~MapContext() {
+    // The defaults are left alone by these
+    destroyStreetsDatabaseContext(streets);
+    destroyOSMDatabaseContext(osm);
+}
+
+MapContext& MapContext::current() {
+    if (boundContext != nullptr)
+        return *boundContext;
+
+    MapContext* selected = selectedContext.load(memory_order_acquire);
+    if (selected != nullptr)
+        return *selected;
+
+    return getDefault();
+}
+
+MapContext& MapContext::getDefault() {
+    static MapContext instance(getDefaultStreetsDatabaseContext(),
+            getDefaultOSMDatabaseContext());
+    return instance;
+}
+
+void MapContext::select(MapContext& context) {
+    // Unbound threads find the databases through selectedContext too, so
+    // the store below switches everything at once
+    setStreetsDatabaseContextSelector(&MapContext::currentStreets);
+    setOSMDatabaseContextSelector(&MapContext::currentOSM);
+    selectedContext.store(&context, memory_order_release);
+}
+
+StreetsDatabaseContext* MapContext::currentStreets() {
+    return current().streets;
+}
+
+OSMDatabaseContext* MapContext::currentOSM() {
+    return current().osm;
+}
+
+MapContext* MapContext::bindThread(MapContext* context) {
+    bindStreetsDatabaseContext(context != nullptr ? context->streets : nullptr);
+    bindOSMDatabaseContext(context != nullptr ? context->osm : nullptr);
+
+    MapContext* previous = boundContext;
+    boundContext = context;
+    return previous;
+}
+
+MapContext::Binding::Binding(MapContext& context) {
+    previous = bindThread(&context);
+}
+
+MapContext::Binding::~Binding() {
+    bindThread(previous);
+}
+
+bool MapContext::load(string mapName) {
+    Binding binding(*this);
+    return load_map(mapName);
+}
+
+void MapContext::close() {
+    Binding binding(*this);
+    close_map();
+}
+
+FastStructs& MapContext::getFastStructs() {
+    return fastStructs;
+}
+
+SegmentTable& MapContext::getSegmentTable() {
+    return segmentTable;
+}
+
+RoutingGraph& MapContext::getRoutingGraph() {
+    return routingGraph;
+}
+
+POIIndex& MapContext::getPOIIndex() {
+    return poiIndex;
+}
+
+NameTokenIndex& MapContext::getStreetNameIndex() {
+    return streetNameIndex;
+}
+
+NameTokenIndex& MapContext::getPOINameIndex() {
+    return poiNameIndex;
+}
+
+StreetPairIndex& MapContext::getStreetPairIndex() {
+    return streetPairIndex;
+}
+
+BoxIndex& MapContext::getBoxIndex() {
+    return boxIndex;
+}
+
+SegmentIndex& MapContext::getSegmentIndex() {
+    return segmentIndex;
+}
+
+double MapContext::getAverageLatRad() const {
+    return averageLatRad;
+}
+
+void MapContext::setAverageLatRad(double latRad) {
+    averageLatRad = latRad;
+}
+
+const vector< pair<string, double> >& MapContext::getLoadMapTimings() const {
+    return loadMapTimings;
+}
+
+void MapContext::setLoadMapTimings(const vector< pair<string, double> >& timings) {
+    loadMapTimings = timings;
+}
@@ -0,0 +1,124 @@
+/*
+ * File:   MapContext.h
+ */
+
+/* One loaded map: its streets and OSM databases and every structure
+ * load_map derives from them (FastStructs, the segment table, the routing
+ * graph, the POI index, the name search indexes, the street pair index, the
+ * box index and the segment index). Any number of contexts can be loaded at
+ * once.
+ *
+ * The free functions (load_map, close_map, the m1-m4 API and the database
+ * APIs underneath) act on the current context, so switching between loaded
+ * maps is a matter of selecting another context instead of reloading. The
+ * current context of a thread is the one bound to that thread by a Binding,
+ * otherwise the one chosen for the whole process with select, otherwise the
+ * default context, which is what the free functions use if no other context
+ * is ever made. Threads start unbound, so code that hands map queries to
+ * other threads binds them to its own context first.
+ *
+ * A context must not be destroyed while it is selected or bound. */
+
+#ifndef MAPCONTEXT_H
+#define MAPCONTEXT_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BoxIndex.h"
+#include "FastStructs.h"
+#include "NameTokenIndex.h"
+#include "OSMDatabaseAPI.h"
+#include "POIIndex.h"
+#include "RoutingGraph.h"
+#include "SegmentIndex.h"
+#include "SegmentTable.h"
+#include "StreetPairIndex.h"
+#include "StreetsDatabaseAPI.h"
+
+using namespace std;
+
+class MapContext {
+public:
+    MapContext();
+    ~MapContext();
+
+    static MapContext& current();
+    static MapContext& getDefault();
+
+    // Makes context current for every thread that has no binding. The map
+    // structures and the databases under them are published together by one
+    // store, so a single lookup never pairs one map's database with another's
+    // structures. A query made of several lookups can still straddle a
+    // switch, though, so threads that query while another thread may select
+    // must hold a Binding instead of relying on the selection.
+    static void select(MapContext& context);
+
+    // Binds context (or nothing, if nullptr) to the calling thread and
+    // returns the previous binding. Prefer Binding, which restores it.
+    static MapContext* bindThread(MapContext* context);
+
+    // Makes a context current for the calling thread while it exists
+    class Binding {
+    public:
+        explicit Binding(MapContext& context);
+        ~Binding();
+
+    private:
+        MapContext* previous;
+
+        Binding(const Binding&) = delete;
+        void operator=(const Binding&) = delete;
+    };
+
+    // load_map and close_map on this context, whichever one is current
+    bool load(string mapName);
+    void close();
+
+    FastStructs& getFastStructs();
+    SegmentTable& getSegmentTable();
+    RoutingGraph& getRoutingGraph();
+    POIIndex& getPOIIndex();
+    NameTokenIndex& getStreetNameIndex();
+    NameTokenIndex& getPOINameIndex();
+    StreetPairIndex& getStreetPairIndex();
+    BoxIndex& getBoxIndex();
+    SegmentIndex& getSegmentIndex();
+
+    // Latitude (in radians) at the middle of the map, set by load_map
+    double getAverageLatRad() const;
+    void setAverageLatRad(double latRad);
+
+    // Name and wall-clock seconds of each stage of the last load_map
+    const vector< pair<string, double> >& getLoadMapTimings() const;
+    void setLoadMapTimings(const vector< pair<string, double> >& timings);
+
+private:
+    // The default context, which uses the databases' default contexts
+    MapContext(StreetsDatabaseContext* streetsContext, OSMDatabaseContext* osmContext);
+    MapContext(const MapContext&) = delete;
+    void operator=(const MapContext&) = delete;
+
+    // The database selectors installed by select
+    static StreetsDatabaseContext* currentStreets();
+    static OSMDatabaseContext* currentOSM();
+
+    StreetsDatabaseContext* streets;
+    OSMDatabaseContext* osm;
+
+    FastStructs fastStructs;
+    SegmentTable segmentTable;
+    RoutingGraph routingGraph;
+    POIIndex poiIndex;
+    NameTokenIndex streetNameIndex;
+    NameTokenIndex poiNameIndex;
+    StreetPairIndex streetPairIndex;
+    BoxIndex boxIndex;
+    SegmentIndex segmentIndex;
+
+    double averageLatRad;
+    vector< pair<string, double> > loadMapTimings;
+};
+
+#endif /* MAPCONTEXT_H */
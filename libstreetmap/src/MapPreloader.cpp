@@ -0,0 +1,76 @@
+/*
+ * File:   MapPreloader.cpp
+ */
+
+#include "MapPreloader.h"
+
+MapPreloader::MapPreloader() :
+    loading(false),
+    loaded(false),
+    standbySuccess(false) {
+}
+
+MapPreloader::~MapPreloader() {
+    clear();
+}
+
+void MapPreloader::preload(string mapName) {
+    if (standby && standbyName == mapName)
+        return;
+
+    // Never wait on the worker here; preload is called from the UI
+    if (loading && !loaded.load(memory_order_acquire))
+        return;
+    finishLoad();
+
+    standby.reset(new MapContext);
+    standbyName = mapName;
+    standbySuccess = false;
+    standbyException = nullptr;
+    loaded.store(false, memory_order_relaxed);
+    loading = true;
+
+    // MapContext::load binds the worker to the standby context
+    MapContext* context = standby.get();
+    worker = thread([this, context, mapName] {
+        try {
+            standbySuccess = context->load(mapName);
+        } catch (...) {
+            standbyException = current_exception();
+        }
+        loaded.store(true, memory_order_release);
+    });
+}
+
+unique_ptr<MapContext> MapPreloader::take(string mapName) {
+    if (!standby || standbyName != mapName)
+        return unique_ptr<MapContext>();
+
+    finishLoad();
+    unique_ptr<MapContext> context = move(standby);
+    standbyName.clear();
+
+    if (standbyException) {
+        exception_ptr exception = standbyException;
+        standbyException = nullptr;
+        rethrow_exception(exception);
+    }
+
+    if (!standbySuccess)
+        return unique_ptr<MapContext>();
+    return context;
+}
+
+void MapPreloader::clear() {
+    finishLoad();
+    standby.reset();
+    standbyName.clear();
+}
+
+// Joins the worker, if there is one
+void MapPreloader::finishLoad() {
+    if (loading) {
+        worker.join();
+        loading = false;
+    }
+}
@@ -0,0 +1,60 @@
+/*
+ * File:   MapPreloader.h
+ */
+
+/* Loads a map on a worker thread into a standby MapContext while another
+ * map is in use, so that switching to it later is a matter of taking the
+ * already loaded context. Only one map is preloaded at a time.
+ *
+ * The worker binds itself (and load_map's threads) to the standby context,
+ * so the map in use can still be queried from other threads meanwhile. */
+
+#ifndef MAPPRELOADER_H
+#define MAPPRELOADER_H
+
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "MapContext.h"
+
+using namespace std;
+
+class MapPreloader {
+public:
+    MapPreloader();
+    ~MapPreloader();
+
+    // Starts loading mapName into the standby context, unless a load is
+    // still running (it then does nothing, rather than wait for it) or
+    // mapName is already the standby map. A finished standby of another
+    // map is dropped.
+    void preload(string mapName);
+
+    // If mapName is the standby map, waits for its load to finish and
+    // hands over the context. Returns nullptr if mapName isn't the standby
+    // map or failed to load. Rethrows anything load_map threw.
+    unique_ptr<MapContext> take(string mapName);
+
+    // Waits for any running load and drops the standby context
+    void clear();
+
+private:
+    MapPreloader(const MapPreloader&) = delete;
+    void operator=(const MapPreloader&) = delete;
+
+    void finishLoad();
+
+    thread worker;
+    bool loading;               // worker is set and not yet joined
+    atomic<bool> loaded;        // set by the worker once load_map returns
+
+    string standbyName;
+    unique_ptr<MapContext> standby;
+    bool standbySuccess;
+    exception_ptr standbyException;
+};
+
+#endif /* MAPPRELOADER_H */
@@ -0,0 +1,122 @@
+/*
+ * File:   NameTokenIndex.cpp
+ */
+
+#include "NameTokenIndex.h"
+#include "StreetsDatabaseAPI.h"
+#include "m1.h"
+
+#include <algorithm>
+
+void NameTokenIndex::build(const vector<unsigned>& itemNameIDs) {
+    clear();
+
+    // Number the distinct names and group their items
+    unordered_map<unsigned, unsigned> nameIndices;
+    vector<unsigned> nameIDs;
+    vector< vector<unsigned> > items;
+    for (unsigned item = 0; item < itemNameIDs.size(); item++) {
+        auto inserted = nameIndices.insert(make_pair(itemNameIDs[item],
+                (unsigned) nameIDs.size()));
+        if (inserted.second) {
+            nameIDs.push_back(itemNameIDs[item]);
+            items.push_back(vector<unsigned>());
+        }
+        items[inserted.first->second].push_back(item);
+    }
+
+    // Split each name once
+    vector< vector<unsigned> > tokens(nameIDs.size());
+    vector< vector<unsigned> > names, positions;
+    for (unsigned name = 0; name < nameIDs.size(); name++) {
+        vector<string> words = separateString(getNameView(nameIDs[name]).to_string());
+        for (unsigned position = 0; position < words.size(); position++) {
+            auto inserted = tokenIDs.insert(make_pair(words[position],
+                    (unsigned) names.size()));
+            unsigned token = inserted.first->second;
+            if (inserted.second) {
+                names.push_back(vector<unsigned>());
+                positions.push_back(vector<unsigned>());
+            }
+            tokens[name].push_back(token);
+            names[token].push_back(name);
+            positions[token].push_back(position);
+        }
+    }
+
+    nameTokens.assign(tokens);
+    nameItems.assign(items);
+    postingNames.assign(names);
+    postingPositions.assign(positions);
+}
+
+void NameTokenIndex::clear() {
+    tokenIDs.clear();
+    nameTokens = IdLists();
+    nameItems = IdLists();
+    postingNames = IdLists();
+    postingPositions = IdLists();
+}
+
+vector<unsigned> NameTokenIndex::search(const vector<string>& words) const {
+    vector<unsigned> names;
+    matchNames(words, names);
+    return itemsOf(names);
+}
+
+vector<unsigned> NameTokenIndex::search(const vector<string>& words,
+        const vector<string>& otherWords) const {
+    vector<unsigned> names;
+    matchNames(words, names);
+    if (otherWords != words)
+        matchNames(otherWords, names);
+    return itemsOf(names);
+}
+
+void NameTokenIndex::matchNames(const vector<string>& words,
+        vector<unsigned>& names) const {
+    if (words.empty())
+        return;
+
+    // Every word must occur somewhere; start from the rarest
+    vector<unsigned> tokens(words.size());
+    unsigned rarest = 0;
+    for (unsigned i = 0; i < words.size(); i++) {
+        auto tokenIter = tokenIDs.find(words[i]);
+        if (tokenIter == tokenIDs.end())
+            return;
+        tokens[i] = tokenIter->second;
+        if (postingNames[tokens[i]].size() < postingNames[tokens[rarest]].size())
+            rarest = i;
+    }
+
+    IdRange occurrenceNames = postingNames[tokens[rarest]];
+    IdRange occurrencePositions = postingPositions[tokens[rarest]];
+    for (unsigned i = 0; i < occurrenceNames.size(); i++) {
+        // The words would start at first in the name
+        unsigned name = occurrenceNames[i];
+        if (occurrencePositions[i] < rarest)
+            continue;
+        unsigned first = occurrencePositions[i] - rarest;
+        IdRange nameWords = nameTokens[name];
+        if (first + tokens.size() > nameWords.size())
+            continue;
+
+        if (equal(tokens.begin(), tokens.end(), nameWords.begin() + first))
+            names.push_back(name);
+    }
+}
+
+// The items of names (which may repeat), ascending
+vector<unsigned> NameTokenIndex::itemsOf(vector<unsigned>& names) const {
+    sort(names.begin(), names.end());
+    names.erase(unique(names.begin(), names.end()), names.end());
+
+    vector<unsigned> items;
+    for (unsigned name : names) {
+        IdRange range = nameItems[name];
+        items.insert(items.end(), range.begin(), range.end());
+    }
+    sort(items.begin(), items.end());
+    return items;
+}
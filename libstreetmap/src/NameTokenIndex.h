@@ -0,0 +1,56 @@
+/*
+ * File:   NameTokenIndex.h
+ */
+
+/* Inverted index from the words of names to the items (streets or POIs)
+ * with those names, built at load_map so that searching by part of a name
+ * doesn't split every name on every search.
+ *
+ * A name's words are as separateString splits it, and a search matches the
+ * names containing its words as consecutive words, compared exactly. Each
+ * word lists the places (name, word position) it occurs at, so a search
+ * walks the list of its rarest word and checks the words around each place.
+ * Items sharing a name are indexed once, by the interned name id. */
+
+#ifndef NAMETOKENINDEX_H
+#define NAMETOKENINDEX_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "IdRange.h"
+
+using namespace std;
+
+class NameTokenIndex {
+public:
+    // The items are 0 to itemNameIDs.size() - 1, item i having the
+    // interned name itemNameIDs[i]
+    void build(const vector<unsigned>& itemNameIDs);
+    void clear();
+
+    // The items whose names contain words as consecutive words, ascending
+    vector<unsigned> search(const vector<string>& words) const;
+
+    // The items matching either words or otherWords, ascending
+    vector<unsigned> search(const vector<string>& words,
+            const vector<string>& otherWords) const;
+
+private:
+    // Appends the (local) names matching words to names
+    void matchNames(const vector<string>& words, vector<unsigned>& names) const;
+    vector<unsigned> itemsOf(vector<unsigned>& names) const;
+
+    unordered_map<string, unsigned> tokenIDs;
+
+    // Per name (numbered in order of first appearance)
+    IdLists nameTokens;         // token ids of its words, in order
+    IdLists nameItems;          // its items, ascending
+
+    // Per token: the names it occurs in and its word position in each
+    IdLists postingNames;
+    IdLists postingPositions;
+};
+
+#endif /* NAMETOKENINDEX_H */
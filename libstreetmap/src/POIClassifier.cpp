@@ -0,0 +1,733 @@
+/*
+ * File:   POIClassifier.cpp
+ */
+
+#include "POIClassifier.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+// An OSM type, its category and its tags other than the category
+struct TypeRule {
+    const char* type;
+    POICategory category;
+    POITag tags[3];             // unused entries are TAG_NONE
+};
+
+struct Alias {
+    const char* alias;
+    POITag tag;
+};
+
+// Indexed by tag
+const char* const tagNames[POI_TAG_COUNT] = {
+    "<unknown>",
+    "automotive",
+    "religious",
+    "education",
+    "public place",
+    "arts",
+    "food",
+    "ferry",
+    "hospital",
+    "pharmacy",
+    "recreation",
+    "entertainment",
+    "bank",
+    "tourism",
+    "emergency",
+    "casino",
+    "parking",
+    "lodging",
+    "shop",
+    "bus station",
+    "gas station",
+    "charging station",
+    "mosque",
+    "temple",
+    "grave yard",
+    "church",
+    "parish hall",
+    "wedding chapel",
+    "school",
+    "university",
+    "college",
+    "kindergarten",
+    "preschool",
+    "embassy",
+    "courthouse",
+    "townhall",
+    "post office",
+    "library",
+    "government office",
+    "arts centre",
+    "movie theatre",
+    "music venue",
+    "cafe",
+    "restaurant",
+    "fast food",
+    "food court",
+    "internet cafe",
+    "pool",
+    "fitness centre",
+    "ice rink",
+    "gym",
+    "gymnasium",
+    "bar",
+    "pub",
+    "bowling",
+    "club",
+    "nightclub",
+    "stripclub",
+    "billiards",
+    "karaoke",
+    "comedy club",
+    "atm",
+    "observatory",
+    "fountain",
+    "police station",
+    "fire station",
+    "ambulance station",
+    "hotel",
+    "motel",
+    "marketplace",
+};
+
+// Sorted by type (as strcmp orders them) for binary search
+const TypeRule typeRules[] = {
+    {"Coffee Shop", POI_FOOD, {TAG_CAFE}},
+    {"Mosque", POI_RELIGIOUS, {TAG_MOSQUE}},
+    {"ambulance", POI_EMERGENCY, {TAG_AMBULANCE_STATION}},
+    {"arts_centre", POI_ARTS, {TAG_ARTS_CENTRE}},
+    {"atm", POI_BANK, {TAG_ATM}},
+    {"bank", POI_BANK, {}},
+    {"bar", POI_ENTERTAINMENT, {TAG_BAR}},
+    {"billiards", POI_ENTERTAINMENT, {TAG_BILLIARDS}},
+    {"bowling", POI_ENTERTAINMENT, {TAG_BOWLING}},
+    {"bus_station", POI_BUS_STATION, {}},
+    {"cafe", POI_FOOD, {TAG_CAFE}},
+    {"casino", POI_CASINO, {}},
+    {"charging_station", POI_AUTOMOTIVE, {TAG_CHARGING_STATION}},
+    {"cinema", POI_ARTS, {TAG_MOVIE_THEATRE}},
+    {"college", POI_EDUCATION, {TAG_COLLEGE}},
+    {"comedy_club", POI_ENTERTAINMENT, {TAG_CLUB, TAG_COMEDY_CLUB}},
+    {"courthouse", POI_PUBLIC_PLACE, {TAG_COURTHOUSE}},
+    {"education", POI_EDUCATION, {}},
+    {"embassy", POI_PUBLIC_PLACE, {TAG_EMBASSY}},
+    {"fast_food", POI_FOOD, {TAG_FAST_FOOD}},
+    {"ferry_terminal", POI_FERRY, {}},
+    {"fire_station", POI_EMERGENCY, {TAG_FIRE_STATION}},
+    {"fitness centre", POI_RECREATION, {TAG_FITNESS_CENTRE}},
+    {"fitness_center", POI_RECREATION, {TAG_FITNESS_CENTRE}},
+    {"food", POI_FOOD, {}},
+    {"food_court", POI_FOOD, {TAG_FOOD_COURT}},
+    {"fountain", POI_TOURISM, {TAG_FOUNTAIN}},
+    {"fuel", POI_AUTOMOTIVE, {TAG_GAS_STATION}},
+    {"government_office", POI_PUBLIC_PLACE, {TAG_GOVERNMENT_OFFICE}},
+    {"grave_yard", POI_RELIGIOUS, {TAG_GRAVE_YARD}},
+    {"gym", POI_RECREATION, {TAG_FITNESS_CENTRE, TAG_GYM}},
+    {"gymnasium", POI_RECREATION, {TAG_FITNESS_CENTRE, TAG_GYM, TAG_GYMNASIUM}},
+    {"hospital", POI_HOSPITAL, {}},
+    {"hotel", POI_LODGING, {TAG_HOTEL}},
+    {"ice_rink", POI_RECREATION, {TAG_ICE_RINK}},
+    {"internet_cafe", POI_FOOD, {TAG_CAFE, TAG_INTERNET_CAFE}},
+    {"karaoke", POI_ENTERTAINMENT, {TAG_KARAOKE}},
+    {"kindergarten", POI_EDUCATION, {TAG_KINDERGARTEN}},
+    {"library", POI_PUBLIC_PLACE, {TAG_LIBRARY}},
+    {"marketplace", POI_SHOP, {TAG_MARKETPLACE}},
+    {"motel", POI_LODGING, {TAG_MOTEL}},
+    {"music_venue", POI_ARTS, {TAG_MUSIC_VENUE}},
+    {"nightclub", POI_ENTERTAINMENT, {TAG_CLUB, TAG_NIGHTCLUB}},
+    {"observatory", POI_TOURISM, {TAG_OBSERVATORY}},
+    {"parish_hall", POI_RELIGIOUS, {TAG_CHURCH, TAG_PARISH_HALL}},
+    {"parking", POI_PARKING, {}},
+    {"pharmacy", POI_PHARMACY, {}},
+    {"place_of_worship", POI_RELIGIOUS, {TAG_TEMPLE}},
+    {"police", POI_EMERGENCY, {TAG_POLICE_STATION}},
+    {"pool; fitness centre; ice rinks", POI_RECREATION, {TAG_POOL, TAG_FITNESS_CENTRE, TAG_ICE_RINK}},
+    {"post_office", POI_PUBLIC_PLACE, {TAG_POST_OFFICE}},
+    {"preschool", POI_EDUCATION, {TAG_PRESCHOOL}},
+    {"pub", POI_ENTERTAINMENT, {TAG_BAR, TAG_PUB}},
+    {"public_building", POI_PUBLIC_PLACE, {}},
+    {"restaurant", POI_FOOD, {TAG_RESTAURANT}},
+    {"school", POI_EDUCATION, {TAG_SCHOOL}},
+    {"shop", POI_SHOP, {}},
+    {"stripclub", POI_ENTERTAINMENT, {TAG_CLUB, TAG_STRIPCLUB}},
+    {"swimming_pool", POI_RECREATION, {TAG_POOL}},
+    {"theatre", POI_ARTS, {TAG_MOVIE_THEATRE}},
+    {"townhall", POI_PUBLIC_PLACE, {TAG_TOWNHALL}},
+    {"university", POI_EDUCATION, {TAG_UNIVERSITY}},
+    {"wedding_chapel", POI_RELIGIOUS, {TAG_CHURCH, TAG_WEDDING_CHAPEL}},
+};
+
+// Sorted by alias (as strcmp orders them) for binary search
+const Alias aliases[] = {
+    {"ATM", TAG_ATM},
+    {"ATM'S", TAG_ATM},
+    {"ATM's", TAG_ATM},
+    {"ATMS", TAG_ATM},
+    {"Ambulance", TAG_AMBULANCE_STATION},
+    {"Ambulance Station", TAG_AMBULANCE_STATION},
+    {"Ambulance Stations", TAG_AMBULANCE_STATION},
+    {"Ambulances", TAG_AMBULANCE_STATION},
+    {"Art", TAG_ARTS},
+    {"Arts", TAG_ARTS},
+    {"Arts Center", TAG_ARTS_CENTRE},
+    {"Arts Centers", TAG_ARTS_CENTRE},
+    {"Arts Centre", TAG_ARTS_CENTRE},
+    {"Arts Centres", TAG_ARTS_CENTRE},
+    {"Auto", TAG_AUTOMOTIVE},
+    {"Automotive", TAG_AUTOMOTIVE},
+    {"Bank", TAG_BANK},
+    {"Banks", TAG_BANK},
+    {"Bar", TAG_BAR},
+    {"Bars", TAG_BAR},
+    {"Billiards", TAG_BILLIARDS},
+    {"Bowling", TAG_BOWLING},
+    {"Bowling Alley", TAG_BOWLING},
+    {"Bowling Alleys", TAG_BOWLING},
+    {"Bus", TAG_BUS_STATION},
+    {"Bus Station", TAG_BUS_STATION},
+    {"Bus Stations", TAG_BUS_STATION},
+    {"Bus Stop", TAG_BUS_STATION},
+    {"Bus Stops", TAG_BUS_STATION},
+    {"Buses", TAG_BUS_STATION},
+    {"Cafe", TAG_CAFE},
+    {"Cafes", TAG_CAFE},
+    {"Car", TAG_AUTOMOTIVE},
+    {"Casino", TAG_CASINO},
+    {"Casinos", TAG_CASINO},
+    {"Cemeteries", TAG_GRAVE_YARD},
+    {"Cemetery", TAG_GRAVE_YARD},
+    {"Charge", TAG_CHARGING_STATION},
+    {"Charging", TAG_CHARGING_STATION},
+    {"Charging Station", TAG_CHARGING_STATION},
+    {"Charging Stations", TAG_CHARGING_STATION},
+    {"Church", TAG_CHURCH},
+    {"Churches", TAG_CHURCH},
+    {"Cinema", TAG_MOVIE_THEATRE},
+    {"Cinemas", TAG_MOVIE_THEATRE},
+    {"City Hall", TAG_TOWNHALL},
+    {"City Halls", TAG_TOWNHALL},
+    {"Cityhall", TAG_TOWNHALL},
+    {"Cityhalls", TAG_TOWNHALL},
+    {"Club", TAG_CLUB},
+    {"Clubs", TAG_CLUB},
+    {"Coffee", TAG_CAFE},
+    {"Coffee Shop", TAG_CAFE},
+    {"Coffee Shops", TAG_CAFE},
+    {"College", TAG_COLLEGE},
+    {"Colleges", TAG_COLLEGE},
+    {"Comedy", TAG_COMEDY_CLUB},
+    {"Comedy Clubs", TAG_COMEDY_CLUB},
+    {"Comedy club", TAG_COMEDY_CLUB},
+    {"Commute", TAG_BUS_STATION},
+    {"Concert Hall", TAG_MUSIC_VENUE},
+    {"Concert Halls", TAG_MUSIC_VENUE},
+    {"Cop", TAG_POLICE_STATION},
+    {"Cops", TAG_POLICE_STATION},
+    {"Court House", TAG_COURTHOUSE},
+    {"Court Houses", TAG_COURTHOUSE},
+    {"Courthouse", TAG_COURTHOUSE},
+    {"Courthouses", TAG_COURTHOUSE},
+    {"Dance Club", TAG_NIGHTCLUB},
+    {"Dance Clubs", TAG_NIGHTCLUB},
+    {"Drug Store", TAG_PHARMACY},
+    {"Drug Stores", TAG_PHARMACY},
+    {"Education", TAG_EDUCATION},
+    {"Embassies", TAG_EMBASSY},
+    {"Embassy", TAG_EMBASSY},
+    {"Emergencies", TAG_EMERGENCY},
+    {"Emergency", TAG_EMERGENCY},
+    {"Entertainment", TAG_ENTERTAINMENT},
+    {"Fast Food", TAG_FAST_FOOD},
+    {"Ferries", TAG_FERRY},
+    {"Ferry", TAG_FERRY},
+    {"Ferry Station", TAG_FERRY},
+    {"Ferry Stations", TAG_FERRY},
+    {"Ferry Terminal", TAG_FERRY},
+    {"Ferry Terminals", TAG_FERRY},
+    {"Fire", TAG_FIRE_STATION},
+    {"Fire Station", TAG_FIRE_STATION},
+    {"Fire Stations", TAG_FIRE_STATION},
+    {"Fires", TAG_FIRE_STATION},
+    {"Fitness", TAG_FITNESS_CENTRE},
+    {"Fitness Center", TAG_FITNESS_CENTRE},
+    {"Fitness Centers", TAG_FITNESS_CENTRE},
+    {"Fitness Centres", TAG_FITNESS_CENTRE},
+    {"Fitness centre", TAG_FITNESS_CENTRE},
+    {"Food", TAG_FOOD},
+    {"Food Court", TAG_FOOD_COURT},
+    {"Fountain", TAG_FOUNTAIN},
+    {"Fountains", TAG_FOUNTAIN},
+    {"Fuel", TAG_GAS_STATION},
+    {"Fun", TAG_ENTERTAINMENT},
+    {"Gamble", TAG_CASINO},
+    {"Gambling", TAG_CASINO},
+    {"Gas", TAG_GAS_STATION},
+    {"Gas Station", TAG_GAS_STATION},
+    {"Gas Stations", TAG_GAS_STATION},
+    {"Gentlemen Club", TAG_STRIPCLUB},
+    {"Gentlemen Clubs", TAG_STRIPCLUB},
+    {"Gentlemen's Club", TAG_STRIPCLUB},
+    {"Gentlemen's Clubs", TAG_STRIPCLUB},
+    {"Government", TAG_PUBLIC_PLACE},
+    {"Government Office", TAG_GOVERNMENT_OFFICE},
+    {"Government Offices", TAG_GOVERNMENT_OFFICE},
+    {"Grave Yard", TAG_GRAVE_YARD},
+    {"Grave Yards", TAG_GRAVE_YARD},
+    {"Gym", TAG_GYM},
+    {"Gymnasium", TAG_GYMNASIUM},
+    {"Gymnasiums", TAG_GYMNASIUM},
+    {"Gyms", TAG_GYM},
+    {"Higher Education", TAG_UNIVERSITY},
+    {"Hospital", TAG_HOSPITAL},
+    {"Hospitals", TAG_HOSPITAL},
+    {"Hotel", TAG_HOTEL},
+    {"Hotels", TAG_HOTEL},
+    {"Ice", TAG_ICE_RINK},
+    {"Ice Rink", TAG_ICE_RINK},
+    {"Ice Rinks", TAG_ICE_RINK},
+    {"Inter-net", TAG_INTERNET_CAFE},
+    {"Inter-net Cafe", TAG_INTERNET_CAFE},
+    {"Inter-net Cafes", TAG_INTERNET_CAFE},
+    {"Internet", TAG_INTERNET_CAFE},
+    {"Internet Cafe", TAG_INTERNET_CAFE},
+    {"Internet Cafes", TAG_INTERNET_CAFE},
+    {"Karaoke", TAG_KARAOKE},
+    {"Karaoke Bar", TAG_KARAOKE},
+    {"Karaoke Bars", TAG_KARAOKE},
+    {"Kindergarten", TAG_KINDERGARTEN},
+    {"Kindergartens", TAG_KINDERGARTEN},
+    {"Libraries", TAG_LIBRARY},
+    {"Library", TAG_LIBRARY},
+    {"Lodging", TAG_LODGING},
+    {"Lodgings", TAG_LODGING},
+    {"Market", TAG_MARKETPLACE},
+    {"Marketplace", TAG_MARKETPLACE},
+    {"Marketplaces", TAG_MARKETPLACE},
+    {"Markets", TAG_MARKETPLACE},
+    {"Medical", TAG_HOSPITAL},
+    {"Medical Center", TAG_HOSPITAL},
+    {"Medical Centers", TAG_HOSPITAL},
+    {"Medical Centre", TAG_HOSPITAL},
+    {"Medical Centres", TAG_HOSPITAL},
+    {"Mosque", TAG_MOSQUE},
+    {"Mosques", TAG_MOSQUE},
+    {"Motels", TAG_MOTEL},
+    {"Movie Theater", TAG_MOVIE_THEATRE},
+    {"Movie Theaters", TAG_MOVIE_THEATRE},
+    {"Movie Theatre", TAG_MOVIE_THEATRE},
+    {"Movie Theatres", TAG_MOVIE_THEATRE},
+    {"Music", TAG_MUSIC_VENUE},
+    {"Music Hall", TAG_MUSIC_VENUE},
+    {"Music Halls", TAG_MUSIC_VENUE},
+    {"Music Venue", TAG_MUSIC_VENUE},
+    {"Music Venues", TAG_MUSIC_VENUE},
+    {"Night Club", TAG_NIGHTCLUB},
+    {"Night Clubs", TAG_NIGHTCLUB},
+    {"Nightclub", TAG_NIGHTCLUB},
+    {"Nightclubs", TAG_NIGHTCLUB},
+    {"Observatories", TAG_OBSERVATORY},
+    {"Observatory", TAG_OBSERVATORY},
+    {"Oil", TAG_GAS_STATION},
+    {"Parish Hall", TAG_PARISH_HALL},
+    {"Parish Halls", TAG_PARISH_HALL},
+    {"Parking", TAG_PARKING},
+    {"Parking Spot", TAG_PARKING},
+    {"Parking Spots", TAG_PARKING},
+    {"Parkings", TAG_PARKING},
+    {"Pharmacies", TAG_PHARMACY},
+    {"Pharmacy", TAG_PHARMACY},
+    {"Place Of Worship", TAG_TEMPLE},
+    {"Place of Worship", TAG_TEMPLE},
+    {"Places Of Worship", TAG_TEMPLE},
+    {"Places of Worship", TAG_TEMPLE},
+    {"Police", TAG_POLICE_STATION},
+    {"Police Station", TAG_POLICE_STATION},
+    {"Police Stations", TAG_POLICE_STATION},
+    {"Pool", TAG_POOL},
+    {"Pool Bar", TAG_BILLIARDS},
+    {"Pool Bars", TAG_BILLIARDS},
+    {"Pools", TAG_POOL},
+    {"Post", TAG_POST_OFFICE},
+    {"Post Office", TAG_POST_OFFICE},
+    {"Post Offices", TAG_POST_OFFICE},
+    {"Pre-School", TAG_PRESCHOOL},
+    {"Pre-Schools", TAG_PRESCHOOL},
+    {"Preschool", TAG_PRESCHOOL},
+    {"Preschools", TAG_PRESCHOOL},
+    {"Pub", TAG_PUB},
+    {"Public", TAG_PUBLIC_PLACE},
+    {"Public Building", TAG_PUBLIC_PLACE},
+    {"Public Buildings", TAG_PUBLIC_PLACE},
+    {"Public Place", TAG_PUBLIC_PLACE},
+    {"Public Places", TAG_PUBLIC_PLACE},
+    {"Public Transit", TAG_BUS_STATION},
+    {"Pubs", TAG_PUB},
+    {"Recreation", TAG_RECREATION},
+    {"Recreation Center", TAG_RECREATION},
+    {"Recreation Centers", TAG_RECREATION},
+    {"Recreation Centre", TAG_RECREATION},
+    {"Recreation Centres", TAG_RECREATION},
+    {"Religion", TAG_RELIGIOUS},
+    {"Religious", TAG_RELIGIOUS},
+    {"Restaurant", TAG_RESTAURANT},
+    {"Restaurants", TAG_RESTAURANT},
+    {"Rink", TAG_ICE_RINK},
+    {"School", TAG_SCHOOL},
+    {"Schools", TAG_SCHOOL},
+    {"Shop", TAG_SHOP},
+    {"Shopping", TAG_SHOP},
+    {"Shops", TAG_SHOP},
+    {"Skating", TAG_ICE_RINK},
+    {"Skating Rink", TAG_ICE_RINK},
+    {"Skating Rinks", TAG_ICE_RINK},
+    {"Strip Club", TAG_STRIPCLUB},
+    {"Strip Clubs", TAG_STRIPCLUB},
+    {"Stripclub", TAG_STRIPCLUB},
+    {"Stripclubs", TAG_STRIPCLUB},
+    {"Stripper", TAG_STRIPCLUB},
+    {"Strippers", TAG_STRIPCLUB},
+    {"Swimming", TAG_POOL},
+    {"Swimming Pool", TAG_POOL},
+    {"Swimming Pools", TAG_POOL},
+    {"Temple", TAG_TEMPLE},
+    {"Temples", TAG_TEMPLE},
+    {"Theatre", TAG_MOVIE_THEATRE},
+    {"Theatres", TAG_MOVIE_THEATRE},
+    {"Tourism", TAG_TOURISM},
+    {"Tourist", TAG_TOURISM},
+    {"Tourist Attraction", TAG_TOURISM},
+    {"Tourist Attractions", TAG_TOURISM},
+    {"Tourists", TAG_TOURISM},
+    {"Town Hall", TAG_TOWNHALL},
+    {"Town Halls", TAG_TOWNHALL},
+    {"Townhall", TAG_TOWNHALL},
+    {"Townhalls", TAG_TOWNHALL},
+    {"Universities", TAG_UNIVERSITY},
+    {"University", TAG_UNIVERSITY},
+    {"Wedding Chapel", TAG_WEDDING_CHAPEL},
+    {"Wedding Chapels", TAG_WEDDING_CHAPEL},
+    {"Wedding Hall", TAG_WEDDING_CHAPEL},
+    {"Wedding Halls", TAG_WEDDING_CHAPEL},
+    {"Worship", TAG_TEMPLE},
+    {"ambulance", TAG_AMBULANCE_STATION},
+    {"ambulance station", TAG_AMBULANCE_STATION},
+    {"ambulance stations", TAG_AMBULANCE_STATION},
+    {"ambulances", TAG_AMBULANCE_STATION},
+    {"art", TAG_ARTS},
+    {"arts", TAG_ARTS},
+    {"arts center", TAG_ARTS_CENTRE},
+    {"arts centers", TAG_ARTS_CENTRE},
+    {"arts centre", TAG_ARTS_CENTRE},
+    {"arts centres", TAG_ARTS_CENTRE},
+    {"atm", TAG_ATM},
+    {"atm's", TAG_ATM},
+    {"atms", TAG_ATM},
+    {"auto", TAG_AUTOMOTIVE},
+    {"automotive", TAG_AUTOMOTIVE},
+    {"bank", TAG_BANK},
+    {"banks", TAG_BANK},
+    {"bar", TAG_BAR},
+    {"bars", TAG_BAR},
+    {"billiards", TAG_BILLIARDS},
+    {"bowling", TAG_BOWLING},
+    {"bowling alley", TAG_BOWLING},
+    {"bowling alleys", TAG_BOWLING},
+    {"bus", TAG_BUS_STATION},
+    {"bus station", TAG_BUS_STATION},
+    {"bus stations", TAG_BUS_STATION},
+    {"bus stop", TAG_BUS_STATION},
+    {"bus stops", TAG_BUS_STATION},
+    {"buses", TAG_BUS_STATION},
+    {"cafe", TAG_CAFE},
+    {"cafes", TAG_CAFE},
+    {"car", TAG_AUTOMOTIVE},
+    {"casino", TAG_CASINO},
+    {"casinos", TAG_CASINO},
+    {"cemeteries", TAG_GRAVE_YARD},
+    {"cemetery", TAG_GRAVE_YARD},
+    {"charge", TAG_CHARGING_STATION},
+    {"charging", TAG_CHARGING_STATION},
+    {"charging station", TAG_CHARGING_STATION},
+    {"charging stations", TAG_CHARGING_STATION},
+    {"church", TAG_CHURCH},
+    {"churches", TAG_CHURCH},
+    {"cinema", TAG_MOVIE_THEATRE},
+    {"cinemas", TAG_MOVIE_THEATRE},
+    {"city hall", TAG_TOWNHALL},
+    {"city halls", TAG_TOWNHALL},
+    {"cityhall", TAG_TOWNHALL},
+    {"cityhalls", TAG_TOWNHALL},
+    {"club", TAG_CLUB},
+    {"clubs", TAG_CLUB},
+    {"coffee", TAG_CAFE},
+    {"coffee shop", TAG_CAFE},
+    {"coffee shops", TAG_CAFE},
+    {"college", TAG_COLLEGE},
+    {"colleges", TAG_COLLEGE},
+    {"comedy", TAG_COMEDY_CLUB},
+    {"comedy club", TAG_COMEDY_CLUB},
+    {"comedy clubs", TAG_COMEDY_CLUB},
+    {"commute", TAG_BUS_STATION},
+    {"concert hall", TAG_MUSIC_VENUE},
+    {"concert halls", TAG_MUSIC_VENUE},
+    {"cop", TAG_POLICE_STATION},
+    {"cops", TAG_POLICE_STATION},
+    {"court house", TAG_COURTHOUSE},
+    {"court houses", TAG_COURTHOUSE},
+    {"courthouse", TAG_COURTHOUSE},
+    {"courthouses", TAG_COURTHOUSE},
+    {"dance club", TAG_NIGHTCLUB},
+    {"dance clubs", TAG_NIGHTCLUB},
+    {"drug store", TAG_PHARMACY},
+    {"drug stores", TAG_PHARMACY},
+    {"education", TAG_EDUCATION},
+    {"embassies", TAG_EMBASSY},
+    {"embassy", TAG_EMBASSY},
+    {"emergencies", TAG_EMERGENCY},
+    {"emergency", TAG_EMERGENCY},
+    {"entertainment", TAG_ENTERTAINMENT},
+    {"fast food", TAG_FAST_FOOD},
+    {"ferries", TAG_FERRY},
+    {"ferry", TAG_FERRY},
+    {"ferry station", TAG_FERRY},
+    {"ferry stations", TAG_FERRY},
+    {"ferry terminal", TAG_FERRY},
+    {"ferry terminals", TAG_FERRY},
+    {"fire", TAG_FIRE_STATION},
+    {"fire station", TAG_FIRE_STATION},
+    {"fire stations", TAG_FIRE_STATION},
+    {"fires", TAG_FIRE_STATION},
+    {"fitness", TAG_FITNESS_CENTRE},
+    {"fitness center", TAG_FITNESS_CENTRE},
+    {"fitness centers", TAG_FITNESS_CENTRE},
+    {"fitness centre", TAG_FITNESS_CENTRE},
+    {"fitness centres", TAG_FITNESS_CENTRE},
+    {"food", TAG_FOOD},
+    {"food court", TAG_FOOD_COURT},
+    {"fountain", TAG_FOUNTAIN},
+    {"fountains", TAG_FOUNTAIN},
+    {"fuel", TAG_GAS_STATION},
+    {"fun", TAG_ENTERTAINMENT},
+    {"gamble", TAG_CASINO},
+    {"gambling", TAG_CASINO},
+    {"gas", TAG_GAS_STATION},
+    {"gas station", TAG_GAS_STATION},
+    {"gas stations", TAG_GAS_STATION},
+    {"gentlemen club", TAG_STRIPCLUB},
+    {"gentlemen's club", TAG_STRIPCLUB},
+    {"gentlemen's clubs", TAG_STRIPCLUB},
+    {"gentlement clubs", TAG_STRIPCLUB},
+    {"government", TAG_PUBLIC_PLACE},
+    {"government office", TAG_GOVERNMENT_OFFICE},
+    {"government offices", TAG_GOVERNMENT_OFFICE},
+    {"grave yard", TAG_GRAVE_YARD},
+    {"grave yards", TAG_GRAVE_YARD},
+    {"gym", TAG_GYM},
+    {"gymnasium", TAG_GYMNASIUM},
+    {"gymnasiums", TAG_GYMNASIUM},
+    {"gyms", TAG_GYM},
+    {"higher education", TAG_UNIVERSITY},
+    {"hospital", TAG_HOSPITAL},
+    {"hospitals", TAG_HOSPITAL},
+    {"hotel", TAG_HOTEL},
+    {"hotels", TAG_HOTEL},
+    {"ice", TAG_ICE_RINK},
+    {"ice rink", TAG_ICE_RINK},
+    {"ice rinks", TAG_ICE_RINK},
+    {"inter-net", TAG_INTERNET_CAFE},
+    {"inter-net cafe", TAG_INTERNET_CAFE},
+    {"inter-net cafes", TAG_INTERNET_CAFE},
+    {"internet", TAG_INTERNET_CAFE},
+    {"internet cafe", TAG_INTERNET_CAFE},
+    {"internet cafes", TAG_INTERNET_CAFE},
+    {"japanese people", TAG_KARAOKE},
+    {"karaoke", TAG_KARAOKE},
+    {"karaoke bar", TAG_KARAOKE},
+    {"karaoke bars", TAG_KARAOKE},
+    {"kindergarten", TAG_KINDERGARTEN},
+    {"kindergartens", TAG_KINDERGARTEN},
+    {"libraries", TAG_LIBRARY},
+    {"library", TAG_LIBRARY},
+    {"lodging", TAG_LODGING},
+    {"lodgings", TAG_LODGING},
+    {"market", TAG_MARKETPLACE},
+    {"marketplace", TAG_MARKETPLACE},
+    {"marketplaces", TAG_MARKETPLACE},
+    {"markets", TAG_MARKETPLACE},
+    {"medical", TAG_HOSPITAL},
+    {"medical center", TAG_HOSPITAL},
+    {"medical centers", TAG_HOSPITAL},
+    {"medical centre", TAG_HOSPITAL},
+    {"medical centres", TAG_HOSPITAL},
+    {"mosque", TAG_MOSQUE},
+    {"mosques", TAG_MOSQUE},
+    {"motel", TAG_MOTEL},
+    {"motels", TAG_MOTEL},
+    {"movie theater", TAG_MOVIE_THEATRE},
+    {"movie theaters", TAG_MOVIE_THEATRE},
+    {"movie theatre", TAG_MOVIE_THEATRE},
+    {"movie theatres", TAG_MOVIE_THEATRE},
+    {"music", TAG_MUSIC_VENUE},
+    {"music hall", TAG_MUSIC_VENUE},
+    {"music halls", TAG_MUSIC_VENUE},
+    {"music venue", TAG_MUSIC_VENUE},
+    {"music venues", TAG_MUSIC_VENUE},
+    {"night club", TAG_NIGHTCLUB},
+    {"night clubs", TAG_NIGHTCLUB},
+    {"nightclub", TAG_NIGHTCLUB},
+    {"nightclubs", TAG_NIGHTCLUB},
+    {"observatories", TAG_OBSERVATORY},
+    {"observatory", TAG_OBSERVATORY},
+    {"oil", TAG_GAS_STATION},
+    {"parish hall", TAG_PARISH_HALL},
+    {"parish halls", TAG_PARISH_HALL},
+    {"parking", TAG_PARKING},
+    {"parking spot", TAG_PARKING},
+    {"parking spots", TAG_PARKING},
+    {"parkings", TAG_PARKING},
+    {"pharmacies", TAG_PHARMACY},
+    {"pharmacy", TAG_PHARMACY},
+    {"place of worship", TAG_TEMPLE},
+    {"places of worship", TAG_TEMPLE},
+    {"police", TAG_POLICE_STATION},
+    {"police station", TAG_POLICE_STATION},
+    {"police stations", TAG_POLICE_STATION},
+    {"pool", TAG_POOL},
+    {"pool bar", TAG_BILLIARDS},
+    {"pool bars", TAG_BILLIARDS},
+    {"pools", TAG_POOL},
+    {"post", TAG_POST_OFFICE},
+    {"post office", TAG_POST_OFFICE},
+    {"post offices", TAG_POST_OFFICE},
+    {"pre-school", TAG_PRESCHOOL},
+    {"pre-schools", TAG_PRESCHOOL},
+    {"preschool", TAG_PRESCHOOL},
+    {"preschools", TAG_PRESCHOOL},
+    {"pub", TAG_PUB},
+    {"public", TAG_PUBLIC_PLACE},
+    {"public building", TAG_PUBLIC_PLACE},
+    {"public buildings", TAG_PUBLIC_PLACE},
+    {"public place", TAG_PUBLIC_PLACE},
+    {"public places", TAG_PUBLIC_PLACE},
+    {"public transit", TAG_BUS_STATION},
+    {"pubs", TAG_PUB},
+    {"recreation", TAG_RECREATION},
+    {"recreation center", TAG_RECREATION},
+    {"recreation centers", TAG_RECREATION},
+    {"recreation centre", TAG_RECREATION},
+    {"recreation centres", TAG_RECREATION},
+    {"religion", TAG_RELIGIOUS},
+    {"religious", TAG_RELIGIOUS},
+    {"restaurant", TAG_RESTAURANT},
+    {"restaurants", TAG_RESTAURANT},
+    {"rink", TAG_ICE_RINK},
+    {"school", TAG_SCHOOL},
+    {"schools", TAG_SCHOOL},
+    {"shop", TAG_SHOP},
+    {"shopping", TAG_SHOP},
+    {"shops", TAG_SHOP},
+    {"skating", TAG_ICE_RINK},
+    {"skating rink", TAG_ICE_RINK},
+    {"skating rinks", TAG_ICE_RINK},
+    {"strip club", TAG_STRIPCLUB},
+    {"strip clubs", TAG_STRIPCLUB},
+    {"stripclub", TAG_STRIPCLUB},
+    {"stripclubs", TAG_STRIPCLUB},
+    {"stripper", TAG_STRIPCLUB},
+    {"strippers", TAG_STRIPCLUB},
+    {"swimming", TAG_POOL},
+    {"swimming pool", TAG_POOL},
+    {"swimming pools", TAG_POOL},
+    {"temple", TAG_TEMPLE},
+    {"temples", TAG_TEMPLE},
+    {"theater", TAG_MOVIE_THEATRE},
+    {"theaters", TAG_MOVIE_THEATRE},
+    {"theatre", TAG_MOVIE_THEATRE},
+    {"theatres", TAG_MOVIE_THEATRE},
+    {"tourism", TAG_TOURISM},
+    {"tourist", TAG_TOURISM},
+    {"tourist attraction", TAG_TOURISM},
+    {"tourist attractions", TAG_TOURISM},
+    {"tourists", TAG_TOURISM},
+    {"town hall", TAG_TOWNHALL},
+    {"town halls", TAG_TOWNHALL},
+    {"townhall", TAG_TOWNHALL},
+    {"townhalls", TAG_TOWNHALL},
+    {"universities", TAG_UNIVERSITY},
+    {"university", TAG_UNIVERSITY},
+    {"wedding chapel", TAG_WEDDING_CHAPEL},
+    {"wedding chapels", TAG_WEDDING_CHAPEL},
+    {"wedding hall", TAG_WEDDING_CHAPEL},
+    {"wedding halls", TAG_WEDDING_CHAPEL},
+    {"worship", TAG_TEMPLE},
+};
+
+bool typeBefore(const TypeRule& rule, boost::string_view type) {
+    return boost::string_view(rule.type) < type;
+}
+
+bool aliasBefore(const Alias& entry, boost::string_view alias) {
+    return boost::string_view(entry.alias) < alias;
+}
+
+bool typeRuleNotBefore(const TypeRule& rule, const TypeRule& next) {
+    return !typeBefore(rule, next.type);
+}
+
+bool aliasNotBefore(const Alias& entry, const Alias& next) {
+    return !aliasBefore(entry, next.alias);
+}
+
+}
+
+POICategory classifyPOIType(boost::string_view type, POITagSet& tags) {
+    tags.reset();
+    const TypeRule* rule = lower_bound(begin(typeRules), end(typeRules),
+            type, typeBefore);
+    if (rule == end(typeRules) || type != rule->type)
+        return POI_UNKNOWN;
+
+    tags.set(rule->category);
+    for (POITag tag : rule->tags)
+        if (tag != TAG_NONE)
+            tags.set(tag);
+    return rule->category;
+}
+
+const char* poiTagName(unsigned tag) {
+    if (tag >= POI_TAG_COUNT)
+        return tagNames[TAG_NONE];
+    return tagNames[tag];
+}
+
+// A walk over the few tag names; the searches look a tag up once and then
+// test it on every POI
+POITag poiTagFromName(boost::string_view name) {
+    for (unsigned tag = TAG_NONE + 1; tag < POI_TAG_COUNT; tag++)
+        if (name == tagNames[tag])
+            return (POITag) tag;
+    return TAG_NONE;
+}
+
+POITag poiTagForAlias(boost::string_view alias) {
+    const Alias* entry = lower_bound(begin(aliases), end(aliases),
+            alias, aliasBefore);
+    if (entry == end(aliases) || alias != entry->alias)
+        return TAG_NONE;
+    return entry->tag;
+}
+
+bool poiTypeRulesSorted() {
+    return adjacent_find(begin(typeRules), end(typeRules), typeRuleNotBefore)
+            == end(typeRules);
+}
+
+bool poiAliasesSorted() {
+    return adjacent_find(begin(aliases), end(aliases), aliasNotBefore)
+            == end(aliases);
+}
@@ -0,0 +1,147 @@
+/*
+ * File:   POIClassifier.h
+ */
+
+/* Classification of points of interest by their OSM type, driven by
+ * constant tables: each OSM type the map draws or searches maps to a
+ * category (the kind of place, which picks its symbol) and a set of tags
+ * (the category and the finer kinds of place it is, e.g. "food", "cafe",
+ * "internet cafe"), and each search alias maps to a tag.
+ *
+ * Tags are bits of a POITagSet, so testing whether a POI has a tag is a
+ * bit test. The categories are the first tags, with the same values. */
+
+#ifndef POICLASSIFIER_H
+#define POICLASSIFIER_H
+
+#include <bitset>
+#include <string>
+
+#include <boost/utility/string_view.hpp>
+
+using namespace std;
+
+enum POICategory {
+    POI_UNKNOWN = 0,
+    POI_AUTOMOTIVE,
+    POI_RELIGIOUS,
+    POI_EDUCATION,
+    POI_PUBLIC_PLACE,
+    POI_ARTS,
+    POI_FOOD,
+    POI_FERRY,
+    POI_HOSPITAL,
+    POI_PHARMACY,
+    POI_RECREATION,
+    POI_ENTERTAINMENT,
+    POI_BANK,
+    POI_TOURISM,
+    POI_EMERGENCY,
+    POI_CASINO,
+    POI_PARKING,
+    POI_LODGING,
+    POI_SHOP,
+    POI_BUS_STATION,
+    POI_CATEGORY_COUNT
+};
+
+enum POITag {
+    TAG_NONE = 0,
+    // The categories
+    TAG_AUTOMOTIVE = POI_AUTOMOTIVE,
+    TAG_RELIGIOUS = POI_RELIGIOUS,
+    TAG_EDUCATION = POI_EDUCATION,
+    TAG_PUBLIC_PLACE = POI_PUBLIC_PLACE,
+    TAG_ARTS = POI_ARTS,
+    TAG_FOOD = POI_FOOD,
+    TAG_FERRY = POI_FERRY,
+    TAG_HOSPITAL = POI_HOSPITAL,
+    TAG_PHARMACY = POI_PHARMACY,
+    TAG_RECREATION = POI_RECREATION,
+    TAG_ENTERTAINMENT = POI_ENTERTAINMENT,
+    TAG_BANK = POI_BANK,
+    TAG_TOURISM = POI_TOURISM,
+    TAG_EMERGENCY = POI_EMERGENCY,
+    TAG_CASINO = POI_CASINO,
+    TAG_PARKING = POI_PARKING,
+    TAG_LODGING = POI_LODGING,
+    TAG_SHOP = POI_SHOP,
+    TAG_BUS_STATION = POI_BUS_STATION,
+    // The finer kinds of place
+    TAG_GAS_STATION = POI_CATEGORY_COUNT,
+    TAG_CHARGING_STATION,
+    TAG_MOSQUE,
+    TAG_TEMPLE,
+    TAG_GRAVE_YARD,
+    TAG_CHURCH,
+    TAG_PARISH_HALL,
+    TAG_WEDDING_CHAPEL,
+    TAG_SCHOOL,
+    TAG_UNIVERSITY,
+    TAG_COLLEGE,
+    TAG_KINDERGARTEN,
+    TAG_PRESCHOOL,
+    TAG_EMBASSY,
+    TAG_COURTHOUSE,
+    TAG_TOWNHALL,
+    TAG_POST_OFFICE,
+    TAG_LIBRARY,
+    TAG_GOVERNMENT_OFFICE,
+    TAG_ARTS_CENTRE,
+    TAG_MOVIE_THEATRE,
+    TAG_MUSIC_VENUE,
+    TAG_CAFE,
+    TAG_RESTAURANT,
+    TAG_FAST_FOOD,
+    TAG_FOOD_COURT,
+    TAG_INTERNET_CAFE,
+    TAG_POOL,
+    TAG_FITNESS_CENTRE,
+    TAG_ICE_RINK,
+    TAG_GYM,
+    TAG_GYMNASIUM,
+    TAG_BAR,
+    TAG_PUB,
+    TAG_BOWLING,
+    TAG_CLUB,
+    TAG_NIGHTCLUB,
+    TAG_STRIPCLUB,
+    TAG_BILLIARDS,
+    TAG_KARAOKE,
+    TAG_COMEDY_CLUB,
+    TAG_ATM,
+    TAG_OBSERVATORY,
+    TAG_FOUNTAIN,
+    TAG_POLICE_STATION,
+    TAG_FIRE_STATION,
+    TAG_AMBULANCE_STATION,
+    TAG_HOTEL,
+    TAG_MOTEL,
+    TAG_MARKETPLACE,
+    POI_TAG_COUNT
+};
+
+typedef bitset<POI_TAG_COUNT> POITagSet;
+
+// The category of a POI of OSM type type, and its tags in tags (none, and
+// POI_UNKNOWN, for a type that isn't classified)
+POICategory classifyPOIType(boost::string_view type, POITagSet& tags);
+
+// The name of a tag (or category), as the searches and the map use it.
+// POI_UNKNOWN and TAG_NONE are "<unknown>".
+const char* poiTagName(unsigned tag);
+
+// The tag with a name, or TAG_NONE
+POITag poiTagFromName(boost::string_view name);
+
+// The tag a search alias (e.g. "Coffee", "gas stations") stands for, or
+// TAG_NONE
+POITag poiTagForAlias(boost::string_view alias);
+
+// Whether the type rule and alias tables are strictly ascending (sorted,
+// without duplicates), as the binary searches above need; an entry out of
+// order is silently never found. For the unit tests.
+bool poiTypeRulesSorted();
+bool poiAliasesSorted();
+
+#endif /* POICLASSIFIER_H */
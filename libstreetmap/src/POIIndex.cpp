@@ -0,0 +1,92 @@
+/*
+ * File:   POIIndex.cpp
+ */
+
+#include "POIIndex.h"
+#include "MapContext.h"
+#include "m1.h"
+
+#include <limits>
+
+// The searches' scratch state, kept by each thread so that threads can
+// query at once and repeated queries don't allocate
+static thread_local ANNsearchContext searchContext;
+
+// Function to access the instance of the current map context
+POIIndex& POIIndex::getInstance() {
+    return MapContext::current().getPOIIndex();
+}
+
+void POIIndex::build() {
+    clear();
+
+    double latRad = MapContext::current().getAverageLatRad();
+    unsigned numberOfPOIs = getNumberOfPointsOfInterest();
+    vector<unsigned> poiIDs(numberOfPOIs);
+    vector<LatLon> positions(numberOfPOIs);
+    unordered_map<string, vector<unsigned> > typePOIs;
+    for (unsigned poiID = 0; poiID < numberOfPOIs; poiID++) {
+        poiIDs[poiID] = poiID;
+        positions[poiID] = getPointOfInterestPosition(poiID);
+        typePOIs[getPointOfInterestType(poiID)].push_back(poiID);
+    }
+
+    allPOIs.reset(new ProjectedTree(poiIDs, positions, latRad));
+    for (auto typeIter = typePOIs.begin(); typeIter != typePOIs.end(); typeIter++) {
+        const vector<unsigned>& typeIDs = typeIter->second;
+        vector<LatLon> typePositions(typeIDs.size());
+        for (unsigned i = 0; i < typeIDs.size(); i++)
+            typePositions[i] = positions[typeIDs[i]];
+        typeTrees[typeIter->first].reset(
+                new ProjectedTree(typeIDs, typePositions, latRad));
+    }
+}
+
+void POIIndex::clear() {
+    allPOIs.reset();
+    typeTrees.clear();
+}
+
+POIIndex::Match POIIndex::closest(LatLon position) const {
+    if (!allPOIs) {
+        Match none = {0, numeric_limits<double>::infinity()};
+        return none;
+    }
+    return allPOIs->nearest(searchContext, position);
+}
+
+vector<POIIndex::Match> POIIndex::nearest(LatLon position, unsigned k) const {
+    if (!allPOIs)
+        return vector<Match>();
+    return allPOIs->nearest(searchContext, position, k);
+}
+
+vector<POIIndex::Match> POIIndex::nearest(LatLon position, unsigned k,
+        const string& type) const {
+    const ProjectedTree* tree = typeTree(type);
+    if (tree == nullptr)
+        return vector<Match>();
+    return tree->nearest(searchContext, position, k);
+}
+
+vector<POIIndex::Match> POIIndex::withinRadius(LatLon position, double radius) const {
+    if (!allPOIs)
+        return vector<Match>();
+    return allPOIs->withinRadius(searchContext, position, radius);
+}
+
+vector<POIIndex::Match> POIIndex::withinRadius(LatLon position, double radius,
+        const string& type) const {
+    const ProjectedTree* tree = typeTree(type);
+    if (tree == nullptr)
+        return vector<Match>();
+    return tree->withinRadius(searchContext, position, radius);
+}
+
+// nullptr if no POI has the type
+const ProjectedTree* POIIndex::typeTree(const string& type) const {
+    auto typeIter = typeTrees.find(type);
+    if (typeIter == typeTrees.end())
+        return nullptr;
+    return typeIter->second.get();
+}
@@ -0,0 +1,65 @@
+/*
+ * File:   POIIndex.h
+ */
+
+/* Spatial index of the points of interest, built at load_map: one
+ * ProjectedTree over every POI and one per POI type, so nearest and radius
+ * queries (optionally restricted to a type) visit a few tree leaves instead
+ * of measuring the distance to every POI. The results are exact: the same
+ * POIs, in the same order (by distance, then POI id), as measuring the
+ * distance to every POI.
+ *
+ * Threads may query at once. */
+
+#ifndef POIINDEX_H
+#define POIINDEX_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "LatLon.h"
+#include "ProjectedTree.h"
+
+using namespace std;
+
+class POIIndex {
+public:
+    // id is the POI id
+    typedef ProjectedTree::Match Match;
+
+    // The one of the current MapContext
+    static POIIndex& getInstance();
+
+    // Builds the trees from the loaded streets database, projected at the
+    // map's average latitude
+    void build();
+    void clear();
+
+    // The POI nearest to position, or id 0 at an infinite distance if there
+    // are none
+    Match closest(LatLon position) const;
+
+    // The (up to) k POIs nearest to position, nearest first
+    vector<Match> nearest(LatLon position, unsigned k) const;
+    vector<Match> nearest(LatLon position, unsigned k, const string& type) const;
+
+    // The POIs at most radius meters from position, nearest first
+    vector<Match> withinRadius(LatLon position, double radius) const;
+    vector<Match> withinRadius(LatLon position, double radius, const string& type) const;
+
+private:
+    // Owned by MapContext; getInstance returns the current context's
+    friend class MapContext;
+    POIIndex() {}
+    POIIndex(const POIIndex&) = delete;
+    void operator=(const POIIndex&) = delete;
+
+    const ProjectedTree* typeTree(const string& type) const;
+
+    unique_ptr<ProjectedTree> allPOIs;
+    unordered_map<string, unique_ptr<ProjectedTree> > typeTrees;
+};
+
+#endif /* POIINDEX_H */
@@ -0,0 +1,172 @@
+/*
+ * File:   ProjectedTree.cpp
+ */
+
+#include "ProjectedTree.h"
+#include "m1.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Widens the tree search radii so rounding can't drop a point at the boundary
+#define RADIUS_SLACK 1e-9
+
+// Candidates the nearest point guard fetches without allocating
+#define GUARD_CANDIDATES 8
+
+// Nearest first, then lowest id
+static bool closerMatch(const ProjectedTree::Match& a, const ProjectedTree::Match& b) {
+    if (a.distance != b.distance)
+        return a.distance < b.distance;
+    return a.id < b.id;
+}
+
+ProjectedTree::ProjectedTree(const vector<unsigned>& _ids,
+        const vector<LatLon>& _positions, double latRad) :
+    ids(_ids),
+    positions(_positions),
+    xScale(max(cos(latRad), 0.0)),
+    minCos(1.0),
+    points(NULL),
+    tree(NULL) {
+
+    for (const LatLon& position : positions)
+        minCos = min(minCos, cos(position.lat * DEG_TO_RAD));
+    minCos = max(minCos, 0.0);
+
+    if (ids.empty())
+        return;
+
+    int dimension = 2;
+    points = annAllocPts((int) ids.size(), dimension);
+    for (unsigned i = 0; i < ids.size(); i++)
+        project(positions[i], points[i]);
+    tree = new ANNkd_tree(points, (int) ids.size(), dimension);
+}
+
+ProjectedTree::~ProjectedTree() {
+    if (tree != NULL) delete tree;
+    if (points != NULL) annDeallocPts(points);
+}
+
+ProjectedTree::Match ProjectedTree::nearest(ANNsearchContext& searchContext,
+        LatLon position) const {
+    Match closest = {0, numeric_limits<double>::infinity()};
+    if (tree == NULL)
+        return closest;
+
+    ANNcoord point[2];
+    project(position, point);
+
+    ANNidx nearIndex;
+    ANNdist nearDistance;
+    tree->annkSearch(searchContext, point, 1, &nearIndex, &nearDistance, 0);
+    closest = {ids[nearIndex], find_distance_between_two_points(position,
+            positions[nearIndex])};
+
+    // Guard: every point that could be at most as far, which is usually
+    // just the one found
+    double radius = treeRadius(position, closest.distance);
+    ANNdist sqRadius = radius * radius;
+    ANNidx candidates[GUARD_CANDIDATES];
+    int numOfCandidates = tree->annkFRSearch(searchContext, point, sqRadius,
+            GUARD_CANDIDATES, candidates, NULL, 0);
+    if (numOfCandidates > GUARD_CANDIDATES) {
+        vector<Match> matches = searchRadius(searchContext, position, point,
+                closest.distance);
+        return matches.front();
+    }
+
+    for (int i = 0; i < numOfCandidates; i++) {
+        Match candidate = {ids[candidates[i]], find_distance_between_two_points(
+                position, positions[candidates[i]])};
+        if (closerMatch(candidate, closest))
+            closest = candidate;
+    }
+    return closest;
+}
+
+vector<ProjectedTree::Match> ProjectedTree::nearest(ANNsearchContext& searchContext,
+        LatLon position, unsigned k) const {
+    k = min(k, (unsigned) ids.size());
+    if (k == 0)
+        return vector<Match>();
+
+    ANNcoord point[2];
+    project(position, point);
+
+    // The k nearest in the tree are k points at most the farthest of them
+    // away, so the true k nearest are all within that distance
+    vector<ANNidx> nearIndices(k);
+    vector<ANNdist> nearDistances(k);
+    tree->annkSearch(searchContext, point, k, nearIndices.data(),
+            nearDistances.data(), 0);
+
+    double radius = 0;
+    for (unsigned i = 0; i < k; i++) {
+        radius = max(radius, find_distance_between_two_points(position,
+                positions[nearIndices[i]]));
+    }
+
+    vector<Match> matches = searchRadius(searchContext, position, point, radius);
+    if (matches.size() > k)
+        matches.resize(k);
+    return matches;
+}
+
+vector<ProjectedTree::Match> ProjectedTree::withinRadius(ANNsearchContext& searchContext,
+        LatLon position, double radius) const {
+    if (tree == NULL || !(radius >= 0))
+        return vector<Match>();
+
+    ANNcoord point[2];
+    project(position, point);
+    return searchRadius(searchContext, position, point, radius);
+}
+
+// The equirectangular projection (in radians) the tree indexes
+void ProjectedTree::project(LatLon position, ANNpoint point) const {
+    point[0] = position.lon * DEG_TO_RAD * xScale;
+    point[1] = position.lat * DEG_TO_RAD;
+}
+
+// The tree radius holding every point at most radius meters from position.
+// The latitude midway between position and a point is between theirs, so
+// its cosine is at least the smaller of the two cosines. Where that is below
+// xScale, the true distance can fall short of the tree distance by (at
+// most) their ratio.
+double ProjectedTree::treeRadius(LatLon position, double radius) const {
+    double scale = 1.0;
+    if (xScale > 0) {
+        double lowCos = min(cos(position.lat * DEG_TO_RAD), minCos);
+        scale = max(min(1.0, lowCos / xScale), 1e-12);
+    }
+    return radius * (1 + RADIUS_SLACK) / (EARTH_RADIUS_IN_METERS * scale);
+}
+
+// All the points at most radius meters from position (whose projection is
+// point), nearest first
+vector<ProjectedTree::Match> ProjectedTree::searchRadius(ANNsearchContext& searchContext,
+        LatLon position, ANNpoint point, double radius) const {
+    double radiusInTree = treeRadius(position, radius);
+    ANNdist sqRadius = radiusInTree * radiusInTree;
+
+    // Count the candidates, then fetch them
+    int numOfCandidates = tree->annkFRSearch(searchContext, point, sqRadius, 0);
+    vector<ANNidx> candidates(numOfCandidates);
+    tree->annkFRSearch(searchContext, point, sqRadius, numOfCandidates,
+            candidates.data(), NULL, 0);
+
+    vector<Match> matches;
+    matches.reserve(numOfCandidates);
+    for (ANNidx candidate : candidates) {
+        double distance = find_distance_between_two_points(position,
+                positions[candidate]);
+        if (distance <= radius)
+            matches.push_back({ids[candidate], distance});
+    }
+
+    sort(matches.begin(), matches.end(), closerMatch);
+    return matches;
+}
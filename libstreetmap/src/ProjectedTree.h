@@ -0,0 +1,76 @@
+/*
+ * File:   ProjectedTree.h
+ */
+
+/* An ANN kd tree over a set of map points (intersections, POIs) for exact
+ * nearest and radius queries under find_distance_between_two_points.
+ *
+ * The tree indexes the points in the same equirectangular projection the
+ * distance function uses, with longitudes scaled by the cosine of one
+ * latitude (the map's average), so the tree's nearest point is nearly
+ * always the true nearest. The distance function scales each pair of
+ * points by the cosine of their own average latitude instead, so the
+ * queries then guard the result: a fixed-radius search, widened by how
+ * much the two scales can differ between the query and any point, finds
+ * every point that could be as close as the tree's answer, and those are
+ * ranked by the true distance (ties going to the lowest id). On a city
+ * sized map that search finds the one point it started from.
+ *
+ * Threads may query at once, each with its own ANNsearchContext. */
+
+#ifndef PROJECTEDTREE_H
+#define PROJECTEDTREE_H
+
+#include <vector>
+
+#include "ANN.h"
+#include "LatLon.h"
+
+using namespace std;
+
+class ProjectedTree {
+public:
+    struct Match {
+        unsigned id;
+        double distance;        // Meters
+    };
+
+    // ids[i] is the point at positions[i]. Longitudes are scaled by
+    // cos(latRad).
+    ProjectedTree(const vector<unsigned>& ids, const vector<LatLon>& positions,
+            double latRad);
+    ~ProjectedTree();
+
+    unsigned size() const {
+        return ids.size();
+    }
+
+    // The nearest point, or id 0 at an infinite distance if there are none
+    Match nearest(ANNsearchContext& searchContext, LatLon position) const;
+
+    // The (up to) k nearest points, nearest first
+    vector<Match> nearest(ANNsearchContext& searchContext, LatLon position,
+            unsigned k) const;
+
+    // The points at most radius meters from position, nearest first
+    vector<Match> withinRadius(ANNsearchContext& searchContext, LatLon position,
+            double radius) const;
+
+private:
+    ProjectedTree(const ProjectedTree&) = delete;
+    void operator=(const ProjectedTree&) = delete;
+
+    void project(LatLon position, ANNpoint point) const;
+    double treeRadius(LatLon position, double radius) const;
+    vector<Match> searchRadius(ANNsearchContext& searchContext, LatLon position,
+            ANNpoint point, double radius) const;
+
+    vector<unsigned> ids;           // tree point index -> id
+    vector<LatLon> positions;       // tree point index -> position
+    double xScale;                  // cosine the longitudes are scaled by
+    double minCos;                  // smallest cosine of the points' latitudes
+    ANNpointArray points;
+    ANNkd_tree* tree;
+};
+
+#endif /* PROJECTEDTREE_H */
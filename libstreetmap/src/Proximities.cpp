@@ -12,6 +12,7 @@
  */
 
 #include "Proximities.h"
+#include "MapContext.h"
 
 Proximities::Proximities(const vector<DeliveryInfo>& deliveries, const vector<unsigned>& depots) {
     vector<IntersectionContent> intersectionContents(getNumberOfIntersections());
@@ -34,12 +35,16 @@ Proximities::Proximities(const vector<DeliveryInfo>& deliveries, const vector<un
     closestMap closestDelSections[NUM_THREADS];
     closestMap closestDepSections[NUM_THREADS];
     
-    // Execute courier Dijkstra using all threads to compute different parts at a time
+    // Execute courier Dijkstra using all threads to compute different parts at a time,
+    // all on the map of this thread
+    MapContext& context = MapContext::current();
     for(unsigned i = 0; i < (NUM_THREADS-1); i++) {
-        vector<unsigned>& range = ranges[i+1];
-        threads[i] = thread(courierDijkstra, ref(range), ref(intersectionContents),
-                ref(distanceSections[i+1]), ref(closestDelSections[i+1]), ref(closestDepSections[i+1]),
-                i+1, thingsToFind);
+        threads[i] = thread([&, i] {
+            MapContext::Binding binding(context);
+            courierDijkstra(ranges[i+1], intersectionContents,
+                    distanceSections[i+1], closestDelSections[i+1], closestDepSections[i+1],
+                    i+1, thingsToFind);
+        });
     }
     
     // Run on main thread
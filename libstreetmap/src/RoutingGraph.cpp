@@ -0,0 +1,174 @@
+/*
+ * File:   RoutingGraph.cpp
+ */
+
+#include "RoutingGraph.h"
+#include "MapContext.h"
+#include "SegmentTable.h"
+#include "m1.h"
+
+#include <limits>
+#include <stdexcept>
+
+// Function to access the instance of the current map context
+RoutingGraph& RoutingGraph::getInstance() {
+    return MapContext::current().getRoutingGraph();
+}
+
+// Lays out the arcs (given in street segment order) by their source
+// intersection. The placement is stable, so the arcs of each intersection
+// stay in street segment order.
+static void buildArcs(RoutingGraph::Arcs& arcs, unsigned numberOfIntersections,
+        unsigned numberOfStreetSegments, const vector<unsigned>& sources,
+        const vector<unsigned>& targets, const vector<unsigned>& segments) {
+    const SegmentTable& segmentTable = SegmentTable::getInstance();
+    unsigned numberOfArcs = sources.size();
+
+    arcs.firstArc.assign(numberOfIntersections + 1, 0);
+    for (unsigned arc = 0; arc < numberOfArcs; arc++)
+        arcs.firstArc[sources[arc] + 1]++;
+    for (unsigned i = 0; i < numberOfIntersections; i++)
+        arcs.firstArc[i + 1] += arcs.firstArc[i];
+
+    arcs.target.resize(numberOfArcs);
+    arcs.streetID.resize(numberOfArcs);
+    arcs.segmentID.resize(numberOfArcs);
+    arcs.segmentArcs.assign(2 * numberOfStreetSegments, -1U);
+
+    vector<unsigned> next(arcs.firstArc.begin(), arcs.firstArc.end() - 1);
+    for (unsigned arc = 0; arc < numberOfArcs; arc++) {
+        unsigned at = next[sources[arc]]++;
+        unsigned segmentID = segments[arc];
+        arcs.target[at] = targets[arc];
+        arcs.streetID[at] = segmentTable.getStreetID(segmentID);
+        arcs.segmentID[at] = segmentID;
+
+        unsigned slot = 2 * segmentID;
+        if (arcs.segmentArcs[slot] != -1U)
+            slot++;
+        arcs.segmentArcs[slot] = at;
+    }
+}
+
+// Sets the travel time of a street segment and of its arcs
+static void setTravelTime(RoutingGraph::Weights& weights,
+        const RoutingGraph::Arcs& forward, const RoutingGraph::Arcs& backward,
+        unsigned segmentID, double travelTime) {
+    weights.segmentTravelTime[segmentID] = travelTime;
+    for (unsigned slot = 2 * segmentID; slot < 2 * segmentID + 2; slot++) {
+        if (forward.segmentArcs[slot] != -1U)
+            weights.forwardTravelTime[forward.segmentArcs[slot]] = travelTime;
+        if (backward.segmentArcs[slot] != -1U)
+            weights.backwardTravelTime[backward.segmentArcs[slot]] = travelTime;
+    }
+}
+
+// Needs the segment table to have been built
+void RoutingGraph::build() {
+    const SegmentTable& segmentTable = SegmentTable::getInstance();
+    unsigned numberOfIntersections = getNumberOfIntersections();
+    unsigned numberOfStreetSegments = segmentTable.size();
+
+    // Every drivable direction of every segment, in street segment order.
+    // An intersection lists a segment once per end of it that touches the
+    // intersection, so a segment looping back to its own intersection
+    // yields two arcs there (none if it is one way), just as the searches
+    // used to see it twice in find_intersection_street_segments.
+    vector<unsigned> sources, targets, segments;
+    sources.reserve(2 * numberOfStreetSegments);
+    targets.reserve(2 * numberOfStreetSegments);
+    segments.reserve(2 * numberOfStreetSegments);
+
+    for (unsigned segmentID = 0; segmentID < numberOfStreetSegments; segmentID++) {
+        unsigned from = segmentTable.getFrom(segmentID);
+        unsigned to = segmentTable.getTo(segmentID);
+        bool oneWay = segmentTable.isOneWay(segmentID);
+
+        // Leaving from the "from" end, unless it is a one way loop
+        if (!(oneWay && from == to)) {
+            sources.push_back(from);
+            targets.push_back(to);
+            segments.push_back(segmentID);
+        }
+
+        // Leaving from the "to" end against the direction of the segment
+        if (!oneWay) {
+            sources.push_back(to);
+            targets.push_back(from);
+            segments.push_back(segmentID);
+        }
+    }
+
+    buildArcs(forward, numberOfIntersections, numberOfStreetSegments,
+            sources, targets, segments);
+    buildArcs(backward, numberOfIntersections, numberOfStreetSegments,
+            targets, sources, segments);
+
+    // The first snapshot has the travel times of the streets database
+    shared_ptr<Weights> initial = make_shared<Weights>();
+    initial->segmentTravelTime.resize(numberOfStreetSegments);
+    initial->speedLimit.resize(numberOfStreetSegments);
+    initial->closed.assign(numberOfStreetSegments, 0);
+    initial->forwardTravelTime.resize(forward.target.size());
+    initial->backwardTravelTime.resize(backward.target.size());
+    initial->maxSpeedLimit = 0;
+    for (unsigned segmentID = 0; segmentID < numberOfStreetSegments; segmentID++) {
+        initial->speedLimit[segmentID] = segmentTable.getSpeedLimit(segmentID);
+        initial->maxSpeedLimit = max(initial->maxSpeedLimit, initial->speedLimit[segmentID]);
+        setTravelTime(*initial, forward, backward, segmentID,
+                segmentTable.getTravelTime(segmentID));
+    }
+    atomic_store(&weights, shared_ptr<const Weights>(initial));
+}
+
+void RoutingGraph::clear() {
+    forward = Arcs();
+    backward = Arcs();
+    atomic_store(&weights, shared_ptr<const Weights>());
+}
+
+const RoutingGraph::Arcs& RoutingGraph::getForward() const {
+    return forward;
+}
+
+const RoutingGraph::Arcs& RoutingGraph::getBackward() const {
+    return backward;
+}
+
+shared_ptr<const RoutingGraph::Weights> RoutingGraph::getWeights() const {
+    return atomic_load(&weights);
+}
+
+void RoutingGraph::updateWeights(const vector<SegmentChange>& changes) {
+    const SegmentTable& segmentTable = SegmentTable::getInstance();
+    lock_guard<mutex> lock(updateMutex);
+
+    shared_ptr<const Weights> current = atomic_load(&weights);
+    if (!current)
+        throw logic_error("RoutingGraph::updateWeights: no map loaded");
+
+    // Copy the current snapshot (readers may still be using it) and redo
+    // the travel times of the changed segments only
+    shared_ptr<Weights> next = make_shared<Weights>(*current);
+    for (const SegmentChange& change : changes) {
+        unsigned segmentID = change.segmentID;
+        if (segmentID >= segmentTable.size())
+            throw out_of_range("RoutingGraph::updateWeights: segmentID");
+        if (!change.closed && !(change.speedLimit > 0))
+            throw invalid_argument("RoutingGraph::updateWeights: speedLimit");
+
+        next->speedLimit[segmentID] = change.speedLimit;
+        next->closed[segmentID] = change.closed;
+        // Lowering it would mean rescanning every segment, and a bound that
+        // is too high only weakens the heuristic
+        if (!change.closed)
+            next->maxSpeedLimit = max(next->maxSpeedLimit, change.speedLimit);
+
+        double travelTime = numeric_limits<double>::infinity();
+        if (!change.closed)
+            travelTime = segmentTable.getLength(segmentID) / 1000 / change.speedLimit * 60;
+        setTravelTime(*next, forward, backward, segmentID, travelTime);
+    }
+
+    atomic_store(&weights, shared_ptr<const Weights>(next));
+}
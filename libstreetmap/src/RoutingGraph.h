@@ -0,0 +1,111 @@
+/*
+ * File:   RoutingGraph.h
+ */
+
+/* The street network as a compressed sparse row (CSR) graph for the path
+ * finding in m3. Every direction a street segment can be driven in is an
+ * arc, and the arcs leaving each intersection are stored contiguously, so a
+ * search relaxes an intersection by walking a range of plain arrays instead
+ * of copying its segment list and looking up and re-measuring each segment.
+ *
+ * The travel times live apart from the arcs, in an immutable Weights
+ * snapshot. updateWeights applies speed limit changes and closures by
+ * publishing a new snapshot (read-copy-update): a search takes the current
+ * snapshot once and uses it throughout, so searches already running finish
+ * on the weights they started with, and only the changed segments' times
+ * are recomputed.
+ *
+ * The forward graph holds the arcs leaving each intersection, in the same
+ * order as find_intersection_street_segments lists their segments. The
+ * backward graph holds the arcs arriving at each intersection, with
+ * target being the intersection they leave from. */
+
+#ifndef ROUTINGGRAPH_H
+#define ROUTINGGRAPH_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+class RoutingGraph {
+public:
+    struct Arcs {
+        // The arcs of intersection i are [firstArc[i], firstArc[i+1])
+        vector<unsigned> firstArc;
+
+        // Per arc
+        vector<unsigned> target;        // intersection at the other end
+        vector<unsigned> streetID;
+        vector<unsigned> segmentID;
+
+        // The (up to two) arcs of each street segment are
+        // segmentArcs[2 * segmentID] and [2 * segmentID + 1], -1U if absent
+        vector<unsigned> segmentArcs;
+
+        unsigned begin(unsigned intersectionID) const {
+            return firstArc[intersectionID];
+        }
+
+        unsigned end(unsigned intersectionID) const {
+            return firstArc[intersectionID + 1];
+        }
+    };
+
+    // The one of the current MapContext
+    static RoutingGraph& getInstance();
+
+    struct Weights {
+        // Per street segment. A closed segment takes forever to travel.
+        vector<double> segmentTravelTime;   // minutes
+        vector<float> speedLimit;           // km/h
+        vector<unsigned char> closed;
+
+        // No open segment is faster than this (km/h), so a search can bound
+        // the time left to its destination by the straight line distance
+        // at this speed. Updates only ever raise it.
+        float maxSpeedLimit;
+
+        // Travel time of each arc of the forward and backward graphs
+        vector<double> forwardTravelTime;
+        vector<double> backwardTravelTime;
+    };
+
+    // A new speed limit (km/h) for a street segment, and whether it is
+    // closed. The speed limit must be positive unless it is closed.
+    struct SegmentChange {
+        unsigned segmentID;
+        float speedLimit;
+        bool closed;
+    };
+
+    // Builds both graphs from the loaded streets database
+    void build();
+    void clear();
+
+    const Arcs& getForward() const;
+    const Arcs& getBackward() const;
+
+    // The current snapshot. Safe to call while another thread updates.
+    shared_ptr<const Weights> getWeights() const;
+
+    // Publishes a snapshot with the changes applied (in order). Throws
+    // (publishing nothing) if a change is invalid.
+    void updateWeights(const vector<SegmentChange>& changes);
+
+private:
+    // Owned by MapContext; getInstance returns the current context's
+    friend class MapContext;
+    RoutingGraph() {}
+    RoutingGraph(const RoutingGraph&) = delete;
+    void operator=(const RoutingGraph&) = delete;
+
+    Arcs forward;
+    Arcs backward;
+
+    shared_ptr<const Weights> weights;    // only through atomic_load/store
+    mutex updateMutex;                      // one update at a time
+};
+
+#endif /* ROUTINGGRAPH_H */
@@ -0,0 +1,163 @@
+/*
+ * File:   SegmentIndex.cpp
+ */
+
+// Boost 1.74's R-tree includes headers of its own that boost deprecated
+#define BOOST_ALLOW_DEPRECATED_HEADERS
+
+// Before the headers with a using namespace std, after which boost.geometry
+// doesn't compile. Not the whole of boost/geometry.hpp, whose point_xy.hpp
+// doesn't compile after one either.
+#include <boost/geometry/geometries/point.hpp>
+#include <boost/geometry/geometries/segment.hpp>
+#include <boost/geometry/index/rtree.hpp>
+// The point to segment and point to box distances of nearest queries
+#include <boost/geometry/algorithms/comparable_distance.hpp>
+#include <boost/geometry/strategies/cartesian/distance_projected_point.hpp>
+#include <boost/geometry/strategies/cartesian/distance_pythagoras_point_box.hpp>
+
+#include "SegmentIndex.h"
+#include "MapContext.h"
+#include "StreetsDatabaseAPI.h"
+#include "m1.h"
+
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+// Tree pieces the closest point compares exactly, so that pieces the tree
+// finds equally near are broken by segment id
+#define CLOSEST_CANDIDATES 8
+
+// (x, y) in meters on the projection
+typedef boost::geometry::model::point<double, 2,
+        boost::geometry::cs::cartesian> Point;
+typedef boost::geometry::model::segment<Point> Piece;
+typedef pair<Piece, unsigned> Entry;        // piece, piece number
+typedef boost::geometry::index::rtree<Entry,
+        boost::geometry::index::quadratic<16> > PieceTree;
+
+struct SegmentIndex::Tree {
+    PieceTree pieces;
+};
+
+// The equirectangular projection (in meters) the tree indexes, with
+// longitudes scaled by xScale
+static Point project(LatLon position, double xScale);
+static LatLon unproject(const Point& point, double xScale);
+
+SegmentIndex::SegmentIndex() :
+    xScale(1.0),
+    tree(new Tree()) {
+}
+
+SegmentIndex::~SegmentIndex() {
+}
+
+// Function to access the instance of the current map context
+SegmentIndex& SegmentIndex::getInstance() {
+    return MapContext::current().getSegmentIndex();
+}
+
+void SegmentIndex::build() {
+    clear();
+    xScale = max(cos(MapContext::current().getAverageLatRad()), 0.0);
+
+    vector<Entry> entries;
+    vector<LatLon> points;
+    unsigned numberOfSegments = getNumberOfStreetSegments();
+    for (unsigned segmentID = 0; segmentID < numberOfSegments; segmentID++) {
+        // The segment's points from its start to its end
+        StreetSegmentInfo segmentInfo = getStreetSegmentInfo(segmentID);
+        const LatLon* curvePoints = getStreetSegmentCurvePoints(segmentID);
+        points.clear();
+        points.push_back(getIntersectionPosition(segmentInfo.from));
+        points.insert(points.end(), curvePoints,
+                curvePoints + segmentInfo.curvePointCount);
+        points.push_back(getIntersectionPosition(segmentInfo.to));
+
+        double offset = 0;
+        for (unsigned i = 0; i + 1 < points.size(); i++) {
+            unsigned piece = pieceSegments.size();
+            entries.push_back(Entry(Piece(project(points[i], xScale),
+                    project(points[i + 1], xScale)), piece));
+            pieceSegments.push_back(segmentID);
+            pieceStarts.push_back(points[i]);
+            pieceOffsets.push_back(offset);
+            offset += find_distance_between_two_points(points[i], points[i + 1]);
+        }
+    }
+
+    // The range constructor bulk loads the tree
+    tree->pieces = PieceTree(entries);
+}
+
+void SegmentIndex::clear() {
+    tree->pieces.clear();
+    pieceSegments.clear();
+    pieceStarts.clear();
+    pieceOffsets.clear();
+}
+
+SegmentIndex::Match SegmentIndex::closest(LatLon position) const {
+    Match closest = {0, position, 0, numeric_limits<double>::infinity()};
+    if (tree->pieces.empty())
+        return closest;
+
+    Point point = project(position, xScale);
+    vector<Entry> candidates;
+    candidates.reserve(CLOSEST_CANDIDATES);
+    tree->pieces.query(boost::geometry::index::nearest(point, CLOSEST_CANDIDATES),
+            back_inserter(candidates));
+
+    // Project onto each candidate piece, clamped to its ends
+    double closestSqDistance = numeric_limits<double>::infinity();
+    unsigned closestPiece = 0;
+    Point closestPoint(0, 0);
+    for (const Entry& candidate : candidates) {
+        const Point& start = candidate.first.first;
+        const Point& end = candidate.first.second;
+        double dx = end.get<0>() - start.get<0>();
+        double dy = end.get<1>() - start.get<1>();
+        double sqLength = dx * dx + dy * dy;
+        double t = 0;
+        if (sqLength > 0) {
+            t = ((point.get<0>() - start.get<0>()) * dx +
+                    (point.get<1>() - start.get<1>()) * dy) / sqLength;
+            t = min(max(t, 0.0), 1.0);
+        }
+        Point onPiece(start.get<0>() + t * dx, start.get<1>() + t * dy);
+        double ex = point.get<0>() - onPiece.get<0>();
+        double ey = point.get<1>() - onPiece.get<1>();
+        double sqDistance = ex * ex + ey * ey;
+
+        unsigned piece = candidate.second;
+        if (sqDistance < closestSqDistance || (sqDistance == closestSqDistance &&
+                piece < closestPiece)) {
+            closestSqDistance = sqDistance;
+            closestPiece = piece;
+            closestPoint = onPiece;
+        }
+    }
+
+    closest.segmentID = pieceSegments[closestPiece];
+    closest.position = unproject(closestPoint, xScale);
+    closest.offset = pieceOffsets[closestPiece] + find_distance_between_two_points(
+            pieceStarts[closestPiece], closest.position);
+    closest.distance = find_distance_between_two_points(position, closest.position);
+    return closest;
+}
+
+static Point project(LatLon position, double xScale) {
+    return Point(position.lon * DEG_TO_RAD * xScale * EARTH_RADIUS_IN_METERS,
+            position.lat * DEG_TO_RAD * EARTH_RADIUS_IN_METERS);
+}
+
+static LatLon unproject(const Point& point, double xScale) {
+    double lat = point.get<1>() / EARTH_RADIUS_IN_METERS / DEG_TO_RAD;
+    double lon = 0;
+    if (xScale > 0)
+        lon = point.get<0>() / EARTH_RADIUS_IN_METERS / xScale / DEG_TO_RAD;
+    return LatLon(lat, lon);
+}
@@ -0,0 +1,73 @@
+/*
+ * File:   SegmentIndex.h
+ */
+
+/* R-tree over the pieces of every street segment (the straight lines
+ * between its ends and curve points), built at load_map, so that the point
+ * on the road network nearest to a position (a click, a GPS fix) is found
+ * by visiting a few tree nodes instead of every piece of every segment.
+ *
+ * The pieces are indexed in meters on the same equirectangular projection
+ * as the kd trees (longitudes scaled by the cosine of the map's average
+ * latitude), and a position is projected onto the nearest piece in that
+ * plane. On a city sized map the plane's distances are within a fraction
+ * of a percent of find_distance_between_two_points; the distance and offset
+ * returned are measured with it. Equally near pieces go to the lowest
+ * segment id.
+ *
+ * Threads may query at once. */
+
+#ifndef SEGMENTINDEX_H
+#define SEGMENTINDEX_H
+
+#include <memory>
+#include <vector>
+
+#include "LatLon.h"
+
+using namespace std;
+
+class SegmentIndex {
+public:
+    struct Match {
+        unsigned segmentID;
+        LatLon position;        // nearest point on the segment
+        double offset;          // meters along the segment from its start
+                                // (from) to position, following its curve
+        double distance;        // meters from the query to position
+    };
+
+    // The one of the current MapContext
+    static SegmentIndex& getInstance();
+
+    // Builds the tree from the loaded streets database, projected at the
+    // map's average latitude
+    void build();
+    void clear();
+
+    // The point on a street segment nearest to position, or segment 0 at an
+    // infinite distance if there are no segments
+    Match closest(LatLon position) const;
+
+private:
+    // Owned by MapContext; getInstance returns the current context's
+    friend class MapContext;
+    SegmentIndex();
+    ~SegmentIndex();
+    SegmentIndex(const SegmentIndex&) = delete;
+    void operator=(const SegmentIndex&) = delete;
+
+    double xScale;                  // cosine the longitudes are scaled by
+
+    // The tree, defined with the boost.geometry types in SegmentIndex.cpp
+    // so that including this header doesn't include boost.geometry
+    struct Tree;
+    unique_ptr<Tree> tree;
+
+    // Per piece number
+    vector<unsigned> pieceSegments; // the segment it is a piece of
+    vector<LatLon> pieceStarts;     // its end nearer the segment's start
+    vector<double> pieceOffsets;    // meters along the segment to its start
+};
+
+#endif /* SEGMENTINDEX_H */
@@ -0,0 +1,83 @@
+/*
+ * File:   SegmentTable.cpp
+ */
+
+#include "SegmentTable.h"
+#include "MapContext.h"
+#include "m1.h"
+
+// Function to access the instance of the current map context
+SegmentTable& SegmentTable::getInstance() {
+    return MapContext::current().getSegmentTable();
+}
+
+void SegmentTable::build() {
+    unsigned numberOfStreetSegments = getNumberOfStreetSegments();
+
+    lengths.resize(numberOfStreetSegments);
+    travelTimes.resize(numberOfStreetSegments);
+    streetIDs.resize(numberOfStreetSegments);
+    from.resize(numberOfStreetSegments);
+    to.resize(numberOfStreetSegments);
+    oneWay.resize(numberOfStreetSegments);
+    speedLimits.resize(numberOfStreetSegments);
+
+    for (unsigned segmentID = 0; segmentID < numberOfStreetSegments; segmentID++) {
+        StreetSegmentInfo segInfo = getStreetSegmentInfo(segmentID);
+
+        // The length is the sum of the distances between consecutive points
+        // of the segment, from its "from" intersection through its curve
+        // points to its "to" intersection
+        double length = 0.0;
+        const LatLon* curvePoints = getStreetSegmentCurvePoints(segmentID);
+        LatLon previousPoint = getIntersectionPosition(segInfo.from);
+        for (unsigned curveID = 0; curveID < segInfo.curvePointCount; curveID++) {
+            length += find_distance_between_two_points(previousPoint, curvePoints[curveID]);
+            previousPoint = curvePoints[curveID];
+        }
+        length += find_distance_between_two_points(previousPoint,
+                getIntersectionPosition(segInfo.to));
+
+        lengths[segmentID] = length;
+        travelTimes[segmentID] = length / 1000 / segInfo.speedLimit * 60;
+        streetIDs[segmentID] = segInfo.streetID;
+        from[segmentID] = segInfo.from;
+        to[segmentID] = segInfo.to;
+        oneWay[segmentID] = segInfo.oneWay;
+        speedLimits[segmentID] = segInfo.speedLimit;
+    }
+}
+
+void SegmentTable::clear() {
+    lengths = vector<double>();
+    travelTimes = vector<double>();
+    streetIDs = vector<unsigned>();
+    from = vector<unsigned>();
+    to = vector<unsigned>();
+    oneWay = vector<unsigned char>();
+    speedLimits = vector<float>();
+}
+
+double SegmentTable::getTotalLength(const unsigned* segmentIDs, unsigned count) const {
+    double total = 0.0;
+    for (unsigned i = 0; i < count; i++)
+        total += lengths[segmentIDs[i]];
+    return total;
+}
+
+double SegmentTable::getTotalTravelTime(const unsigned* segmentIDs, unsigned count) const {
+    double total = 0.0;
+    for (unsigned i = 0; i < count; i++)
+        total += travelTimes[segmentIDs[i]];
+    return total;
+}
+
+void SegmentTable::getLengths(const unsigned* segmentIDs, unsigned count, double* out) const {
+    for (unsigned i = 0; i < count; i++)
+        out[i] = lengths[segmentIDs[i]];
+}
+
+void SegmentTable::getTravelTimes(const unsigned* segmentIDs, unsigned count, double* out) const {
+    for (unsigned i = 0; i < count; i++)
+        out[i] = travelTimes[segmentIDs[i]];
+}
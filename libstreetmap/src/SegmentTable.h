@@ -0,0 +1,86 @@
+/*
+ * File:   SegmentTable.h
+ */
+
+/* The attributes of every street segment, computed once at load_map and
+ * stored as one array per attribute (indexed by street segment id). Reading
+ * a segment's length or travel time is then an array read instead of a
+ * walk over its curve points, and loops over many segments (street lengths,
+ * path travel times) touch only the arrays they need.
+ *
+ * The accessors do not range check the ids. */
+
+#ifndef SEGMENTTABLE_H
+#define SEGMENTTABLE_H
+
+#include <vector>
+
+using namespace std;
+
+class SegmentTable {
+public:
+    // The one of the current MapContext
+    static SegmentTable& getInstance();
+
+    // Builds the table from the loaded streets database
+    void build();
+    void clear();
+
+    unsigned size() const {
+        return lengths.size();
+    }
+
+    // Meters
+    double getLength(unsigned segmentID) const {
+        return lengths[segmentID];
+    }
+
+    // Minutes, as find_street_segment_travel_time
+    double getTravelTime(unsigned segmentID) const {
+        return travelTimes[segmentID];
+    }
+
+    unsigned getStreetID(unsigned segmentID) const {
+        return streetIDs[segmentID];
+    }
+
+    unsigned getFrom(unsigned segmentID) const {
+        return from[segmentID];
+    }
+
+    unsigned getTo(unsigned segmentID) const {
+        return to[segmentID];
+    }
+
+    bool isOneWay(unsigned segmentID) const {
+        return oneWay[segmentID];
+    }
+
+    float getSpeedLimit(unsigned segmentID) const {
+        return speedLimits[segmentID];
+    }
+
+    // Batch variants over count segment ids. The totals are summed in
+    // the order the ids are given.
+    double getTotalLength(const unsigned* segmentIDs, unsigned count) const;
+    double getTotalTravelTime(const unsigned* segmentIDs, unsigned count) const;
+    void getLengths(const unsigned* segmentIDs, unsigned count, double* out) const;
+    void getTravelTimes(const unsigned* segmentIDs, unsigned count, double* out) const;
+
+private:
+    // Owned by MapContext; getInstance returns the current context's
+    friend class MapContext;
+    SegmentTable() {}
+    SegmentTable(const SegmentTable&) = delete;
+    void operator=(const SegmentTable&) = delete;
+
+    vector<double> lengths;
+    vector<double> travelTimes;
+    vector<unsigned> streetIDs;
+    vector<unsigned> from;
+    vector<unsigned> to;
+    vector<unsigned char> oneWay;
+    vector<float> speedLimits;
+};
+
+#endif /* SEGMENTTABLE_H */
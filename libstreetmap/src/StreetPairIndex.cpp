@@ -0,0 +1,76 @@
+/*
+ * File:   StreetPairIndex.cpp
+ */
+
+#include "StreetPairIndex.h"
+#include "StreetsDatabaseAPI.h"
+
+#include <algorithm>
+
+void StreetPairIndex::build() {
+    clear();
+
+    vector< vector<unsigned> > intersectionLists;
+    vector<unsigned> names;
+    unsigned numberOfIntersections = getNumberOfIntersections();
+    for (unsigned intersectionID = 0;
+            intersectionID < numberOfIntersections;
+            intersectionID++) {
+        // The distinct names of the streets meeting here
+        names.clear();
+        unsigned numberOfSegments = getIntersectionStreetSegmentCount(intersectionID);
+        for (unsigned i = 0; i < numberOfSegments; i++) {
+            unsigned segmentID = getIntersectionStreetSegment(intersectionID, i);
+            names.push_back(getStreetNameID(getStreetSegmentInfo(segmentID).streetID));
+        }
+        sort(names.begin(), names.end());
+        names.erase(unique(names.begin(), names.end()), names.end());
+
+        // Intersections are visited in order, so each list stays ascending
+        for (unsigned i = 0; i < names.size(); i++) {
+            for (unsigned j = i; j < names.size(); j++) {
+                auto inserted = pairIndices.insert(make_pair(
+                        pairKey(names[i], names[j]),
+                        (unsigned) intersectionLists.size()));
+                if (inserted.second)
+                    intersectionLists.push_back(vector<unsigned>());
+                intersectionLists[inserted.first->second].push_back(intersectionID);
+            }
+        }
+    }
+
+    pairIntersections.assign(intersectionLists);
+}
+
+void StreetPairIndex::clear() {
+    pairIndices.clear();
+    pairIntersections = IdLists();
+}
+
+IdRange StreetPairIndex::intersections(unsigned nameID1, unsigned nameID2) const {
+    auto pairIter = pairIndices.find(pairKey(nameID1, nameID2));
+    if (pairIter == pairIndices.end())
+        return IdRange();
+    return pairIntersections[pairIter->second];
+}
+
+vector<unsigned> StreetPairIndex::intersections(const vector<unsigned>& nameIDs1,
+        const vector<unsigned>& nameIDs2) const {
+    vector<unsigned> found;
+    for (unsigned nameID1 : nameIDs1) {
+        for (unsigned nameID2 : nameIDs2) {
+            IdRange range = intersections(nameID1, nameID2);
+            found.insert(found.end(), range.begin(), range.end());
+        }
+    }
+    sort(found.begin(), found.end());
+    found.erase(unique(found.begin(), found.end()), found.end());
+    return found;
+}
+
+// The pair's ids packed smaller first, so the order they come in doesn't matter
+uint64_t StreetPairIndex::pairKey(unsigned nameID1, unsigned nameID2) {
+    if (nameID1 > nameID2)
+        swap(nameID1, nameID2);
+    return ((uint64_t) nameID1 << 32) | nameID2;
+}
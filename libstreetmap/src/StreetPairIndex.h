@@ -0,0 +1,46 @@
+/*
+ * File:   StreetPairIndex.h
+ */
+
+/* Index from a pair of street names to the intersections where streets
+ * with those names meet, built at load_map from each intersection's
+ * incident streets so that looking up "A & B" is one hash probe per pair
+ * of names rather than a merge of every street's intersections.
+ *
+ * Names are the interned name ids, and a pair is unordered. A name paired
+ * with itself gives every intersection on a street with that name, as
+ * merging a street's intersections with its own always did. */
+
+#ifndef STREETPAIRINDEX_H
+#define STREETPAIRINDEX_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "IdRange.h"
+
+using namespace std;
+
+class StreetPairIndex {
+public:
+    void build();
+    void clear();
+
+    // The intersections where streets named nameID1 and nameID2 meet,
+    // ascending
+    IdRange intersections(unsigned nameID1, unsigned nameID2) const;
+
+    // The intersections of any of the pairs of a name in nameIDs1 and a
+    // name in nameIDs2, ascending
+    vector<unsigned> intersections(const vector<unsigned>& nameIDs1,
+            const vector<unsigned>& nameIDs2) const;
+
+private:
+    static uint64_t pairKey(unsigned nameID1, unsigned nameID2);
+
+    unordered_map<uint64_t, unsigned> pairIndices;
+    IdLists pairIntersections;
+};
+
+#endif /* STREETPAIRINDEX_H */
@@ -0,0 +1,118 @@
+/* 
+ * File:   TaskGraph.cpp
+ */
+
+#include "TaskGraph.h"
+
+#include <chrono>
+#include <thread>
+
+unsigned TaskGraph::addTask(string name, function<void()> work,
+        const vector<unsigned>& dependencies) {
+    unsigned taskID = tasks.size();
+    
+    Task task;
+    task.name = name;
+    task.work = work;
+    task.unfinishedDependencies = dependencies.size();
+    task.skipped = false;
+    task.ran = false;
+    task.seconds = 0;
+    tasks.push_back(task);
+    
+    for(unsigned dependency : dependencies)
+        tasks[dependency].dependents.push_back(taskID);
+    
+    return taskID;
+}
+
+void TaskGraph::run(unsigned numThreads, function<void()> threadStart) {
+    unfinishedTasks = tasks.size();
+    firstException = nullptr;
+    readyTasks.clear();
+    for(unsigned taskID = 0; taskID < tasks.size(); taskID++)
+        if(tasks[taskID].unfinishedDependencies == 0)
+            readyTasks.push_back(taskID);
+    
+    // No point in more threads than tasks
+    if(numThreads > tasks.size())
+        numThreads = tasks.size();
+    
+    vector<thread> threads;
+    for(unsigned i = 1; i < numThreads; i++)
+        threads.push_back(thread([this, &threadStart] {
+            if(threadStart)
+                threadStart();
+            worker();
+        }));
+    
+    // The calling thread works too
+    worker();
+    
+    for(unsigned i = 0; i < threads.size(); i++)
+        threads[i].join();
+    
+    if(firstException)
+        rethrow_exception(firstException);
+}
+
+vector< pair<string, double> > TaskGraph::getTimings() const {
+    vector< pair<string, double> > timings;
+    for(const Task& task : tasks)
+        if(task.ran)
+            timings.push_back(make_pair(task.name, task.seconds));
+    return timings;
+}
+
+// Takes ready tasks until every task has finished
+void TaskGraph::worker() {
+    unique_lock<mutex> lock(runMutex);
+    
+    while(unfinishedTasks > 0) {
+        if(readyTasks.empty()) {
+            taskReady.wait(lock);
+            continue;
+        }
+        
+        unsigned taskID = readyTasks.front();
+        readyTasks.pop_front();
+        Task& task = tasks[taskID];
+        
+        if(task.skipped) {
+            finished(taskID, true);
+            continue;
+        }
+        
+        lock.unlock();
+        bool failed = false;
+        auto start = chrono::steady_clock::now();
+        try {
+            task.work();
+        } catch (...) {
+            failed = true;
+            lock.lock();
+            if(!firstException)
+                firstException = current_exception();
+            lock.unlock();
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        lock.lock();
+        
+        task.ran = true;
+        task.seconds = seconds;
+        finished(taskID, failed);
+    }
+}
+
+// Releases the dependents of a finished task. Called with runMutex held.
+void TaskGraph::finished(unsigned taskID, bool failed) {
+    for(unsigned dependent : tasks[taskID].dependents) {
+        if(failed)
+            tasks[dependent].skipped = true;
+        if(--tasks[dependent].unfinishedDependencies == 0)
+            readyTasks.push_back(dependent);
+    }
+    
+    unfinishedTasks--;
+    taskReady.notify_all();
+}
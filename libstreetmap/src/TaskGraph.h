@@ -0,0 +1,67 @@
+/* 
+ * File:   TaskGraph.h
+ */
+
+/* A small dependency graph of tasks run on a pool of threads. Each task
+ * starts as soon as every task it depends on has finished, so independent
+ * tasks run concurrently. Used by load_map to overlap its loading and
+ * building stages. */
+
+#ifndef TASKGRAPH_H
+#define TASKGRAPH_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+class TaskGraph {
+public:
+    // Adds a task that runs work once every task in dependencies (ids
+    // returned by earlier calls) has finished. Returns the task's id.
+    unsigned addTask(string name, function<void()> work,
+            const vector<unsigned>& dependencies = vector<unsigned>());
+    
+    // Runs all the tasks on up to numThreads threads (including the calling
+    // thread) and returns once they have all finished. If a task throws,
+    // the tasks depending on it are skipped and the first exception is
+    // rethrown here. Each thread started here first calls threadStart, if
+    // given, e.g. to set up thread-local state.
+    void run(unsigned numThreads,
+            function<void()> threadStart = function<void()>());
+    
+    // Name and wall-clock seconds of every task that ran, in the order the
+    // tasks were added
+    vector< pair<string, double> > getTimings() const;
+    
+private:
+    struct Task {
+        string name;
+        function<void()> work;
+        vector<unsigned> dependents;    // tasks waiting on this one
+        unsigned unfinishedDependencies;
+        bool skipped;                   // a dependency threw
+        bool ran;
+        double seconds;
+    };
+    
+    vector<Task> tasks;
+    
+    // Shared state while running
+    mutex runMutex;
+    condition_variable taskReady;
+    deque<unsigned> readyTasks;
+    unsigned unfinishedTasks;
+    exception_ptr firstException;
+    
+    void worker();
+    void finished(unsigned taskID, bool failed);
+};
+
+#endif /* TASKGRAPH_H */
@@ -25,6 +25,7 @@
 //----------------------------------------------------------------------
 
 #include "kd_search.h"					// kd-search declarations
+#include "pr_queue.h"					// priority queue declarations
 
 //----------------------------------------------------------------------
 //	Approximate nearest neighbor searching by kd-tree search
@@ -71,16 +72,43 @@
 //----------------------------------------------------------------------
 
 //----------------------------------------------------------------------
-//		To keep argument lists short, a number of global variables
-//		are maintained which are common to all the recursive calls.
-//		These are given below.
+//	ANNsearchContext - state of a search
 //----------------------------------------------------------------------
 
-int				ANNkdDim;				// dimension of space
-ANNpoint		ANNkdQ;					// query point
-double			ANNkdMaxErr;			// max tolerable squared error
-ANNpointArray	ANNkdPts;				// the points
-ANNmin_k		*ANNkdPointMK;			// set of k closest points
+ANNsearchContext::ANNsearchContext()
+{
+	dim = 0;
+	q = NULL;
+	maxErr = 0;
+	pts = NULL;
+	pointMK = NULL;
+	boxPQ = NULL;
+	sqRad = 0;
+	ptsVisited = 0;
+	ptsInRange = 0;
+	closest = NULL;
+	boxes = NULL;
+}
+
+ANNsearchContext::~ANNsearchContext()
+{
+	delete closest;
+	delete boxes;
+}
+
+ANNmin_k *ANNsearchContext::closestSet(int k)
+{
+	if (closest == NULL) closest = new ANNmin_k(k);
+	else closest->reset(k);
+	return closest;
+}
+
+ANNpr_queue *ANNsearchContext::boxQueue(int max)
+{
+	if (boxes == NULL) boxes = new ANNpr_queue(max);
+	else boxes->reset(max);
+	return boxes;
+}
 
 //----------------------------------------------------------------------
 //	annkSearch - search for the k nearest neighbors
@@ -93,46 +121,57 @@ void ANNkd_tree::annkSearch(
 	ANNdistArray		dd,				// the approximate nearest neighbor
 	double				eps)			// the error bound
 {
+	ANNsearchContext ctx;				// state of this search only
+	annkSearch(ctx, q, k, nn_idx, dd, eps);
+}
+
+void ANNkd_tree::annkSearch(
+	ANNsearchContext	&ctx,			// search state (modified)
+	ANNpoint			q,				// the query point
+	int					k,				// number of near neighbors to return
+	ANNidxArray			nn_idx,			// nearest neighbor indices (returned)
+	ANNdistArray		dd,				// the approximate nearest neighbor
+	double				eps)			// the error bound
+{
 
-	ANNkdDim = dim;						// copy arguments to static equivs
-	ANNkdQ = q;
-	ANNkdPts = pts;
-	ANNptsVisited = 0;					// initialize count of points visited
+	ctx.dim = dim;						// copy arguments to the context
+	ctx.q = q;
+	ctx.pts = pts;
+	ctx.ptsVisited = 0;					// initialize count of points visited
 
 	if (k > n_pts) {					// too many near neighbors?
 		annError("Requesting more near neighbors than data points", ANNabort);
 	}
 
-	ANNkdMaxErr = ANN_POW(1.0 + eps);
+	ctx.maxErr = ANN_POW(1.0 + eps);
 	ANN_FLOP(2)							// increment floating op count
 
-	ANNkdPointMK = new ANNmin_k(k);		// create set for closest k points
+	ctx.pointMK = ctx.closestSet(k);	// set for closest k points
 										// search starting at the root
-	root->ann_search(annBoxDistance(q, bnd_box_lo, bnd_box_hi, dim));
+	root->ann_search(annBoxDistance(q, bnd_box_lo, bnd_box_hi, dim), ctx);
 
 	for (int i = 0; i < k; i++) {		// extract the k-th closest points
-		dd[i] = ANNkdPointMK->ith_smallest_key(i);
-		nn_idx[i] = ANNkdPointMK->ith_smallest_info(i);
+		dd[i] = ctx.pointMK->ith_smallest_key(i);
+		nn_idx[i] = ctx.pointMK->ith_smallest_info(i);
 	}
-	delete ANNkdPointMK;				// deallocate closest point set
 }
 
 //----------------------------------------------------------------------
 //	kd_split::ann_search - search a splitting node
 //----------------------------------------------------------------------
 
-void ANNkd_split::ann_search(ANNdist box_dist)
+void ANNkd_split::ann_search(ANNdist box_dist, ANNsearchContext &ctx)
 {
 										// check dist calc term condition
-	if (ANNmaxPtsVisited != 0 && ANNptsVisited > ANNmaxPtsVisited) return;
+	if (ANNmaxPtsVisited != 0 && ctx.ptsVisited > ANNmaxPtsVisited) return;
 
 										// distance to cutting plane
-	ANNcoord cut_diff = ANNkdQ[cut_dim] - cut_val;
+	ANNcoord cut_diff = ctx.q[cut_dim] - cut_val;
 
 	if (cut_diff < 0) {					// left of cutting plane
-		child[ANN_LO]->ann_search(box_dist);// visit closer child first
+		child[ANN_LO]->ann_search(box_dist, ctx);// visit closer child first
 
-		ANNcoord box_diff = cd_bnds[ANN_LO] - ANNkdQ[cut_dim];
+		ANNcoord box_diff = cd_bnds[ANN_LO] - ctx.q[cut_dim];
 		if (box_diff < 0)				// within bounds - ignore
 			box_diff = 0;
 										// distance to further box
@@ -140,14 +179,14 @@ void ANNkd_split::ann_search(ANNdist box_dist)
 				ANN_DIFF(ANN_POW(box_diff), ANN_POW(cut_diff)));
 
 										// visit further child if close enough
-		if (box_dist * ANNkdMaxErr < ANNkdPointMK->max_key())
-			child[ANN_HI]->ann_search(box_dist);
+		if (box_dist * ctx.maxErr < ctx.pointMK->max_key())
+			child[ANN_HI]->ann_search(box_dist, ctx);
 
 	}
 	else {								// right of cutting plane
-		child[ANN_HI]->ann_search(box_dist);// visit closer child first
+		child[ANN_HI]->ann_search(box_dist, ctx);// visit closer child first
 
-		ANNcoord box_diff = ANNkdQ[cut_dim] - cd_bnds[ANN_HI];
+		ANNcoord box_diff = ctx.q[cut_dim] - cd_bnds[ANN_HI];
 		if (box_diff < 0)				// within bounds - ignore
 			box_diff = 0;
 										// distance to further box
@@ -155,8 +194,8 @@ void ANNkd_split::ann_search(ANNdist box_dist)
 				ANN_DIFF(ANN_POW(box_diff), ANN_POW(cut_diff)));
 
 										// visit further child if close enough
-		if (box_dist * ANNkdMaxErr < ANNkdPointMK->max_key())
-			child[ANN_LO]->ann_search(box_dist);
+		if (box_dist * ctx.maxErr < ctx.pointMK->max_key())
+			child[ANN_LO]->ann_search(box_dist, ctx);
 
 	}
 	ANN_FLOP(10)						// increment floating ops
@@ -169,7 +208,7 @@ void ANNkd_split::ann_search(ANNdist box_dist)
 //		some fine tuning to replace indexing by pointer operations.
 //----------------------------------------------------------------------
 
-void ANNkd_leaf::ann_search(ANNdist box_dist)
+void ANNkd_leaf::ann_search(ANNdist box_dist, ANNsearchContext &ctx)
 {
 	register ANNdist dist;				// distance to data point
 	register ANNcoord* pp;				// data coordinate pointer
@@ -178,15 +217,15 @@ void ANNkd_leaf::ann_search(ANNdist box_dist)
 	register ANNcoord t;
 	register int d;
 
-	min_dist = ANNkdPointMK->max_key(); // k-th smallest distance so far
+	min_dist = ctx.pointMK->max_key(); // k-th smallest distance so far
 
 	for (int i = 0; i < n_pts; i++) {	// check points in bucket
 
-		pp = ANNkdPts[bkt[i]];			// first coord of next data point
-		qq = ANNkdQ;					// first coord of query point
+		pp = ctx.pts[bkt[i]];			// first coord of next data point
+		qq = ctx.q;					// first coord of query point
 		dist = 0;
 
-		for(d = 0; d < ANNkdDim; d++) {
+		for(d = 0; d < ctx.dim; d++) {
 			ANN_COORD(1)				// one more coordinate hit
 			ANN_FLOP(4)					// increment floating ops
 
@@ -197,14 +236,14 @@ void ANNkd_leaf::ann_search(ANNdist box_dist)
 			}
 		}
 
-		if (d >= ANNkdDim &&					// among the k best?
+		if (d >= ctx.dim &&					// among the k best?
 		   (ANN_ALLOW_SELF_MATCH || dist!=0)) { // and no self-match problem
 												// add it to the list
-			ANNkdPointMK->insert(dist, bkt[i]);
-			min_dist = ANNkdPointMK->max_key();
+			ctx.pointMK->insert(dist, bkt[i]);
+			min_dist = ctx.pointMK->max_key();
 		}
 	}
 	ANN_LEAF(1)							// one more leaf node visited
 	ANN_PTS(n_pts)						// increment points visited
-	ANNptsVisited += n_pts;				// increment number of points visited
+	ctx.ptsVisited += n_pts;				// increment number of points visited
 }
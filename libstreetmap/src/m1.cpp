@@ -1,67 +1,245 @@
 #include "m1.h"
+#include "BoxIndex.h"
 #include "FastStructs.h"
+#include "MapContext.h"
+#include "POIIndex.h"
+#include "RoutingGraph.h"
+#include "SegmentIndex.h"
+#include "SegmentTable.h"
+#include "TaskGraph.h"
+#include <atomic>
+#include <limits>
 #include <unordered_map>
+#include <unordered_set>
 #include <math.h>
 #include <sstream>
+#include <fstream>
+#include <sys/stat.h>
+#include <thread>
 
 using namespace std;
 
 // Private function declarations
 bool loadOSM(string map_name);
 string convertMapToOSMName(string mapName);
+string convertMapToMMapName(string mapName);
+string convertOSMToMMapName(string osmName);
+string convertMapToCacheName(string mapName);
+bool computeMapKey(string map_name, string osmName, unsigned long long& mapKey);
+bool loadStreets(string map_name, bool& loadedBIN);
+bool isNewerThan(string fileName, string otherFileName);
 void buildStreetsTable();
 void buildIntersectionStreetSegments();
 void buildStreetStreetSegmentsAndIntersections();
 void buildIntersectionskdTree();
 void buildSortedFeatures();
-void buildStreetSegmentClassifications();
+vector<RoadClass> buildRoadClassesFromOSM();
+void buildStreetSegmentClassifications(const vector<RoadClass>& roadClasses);
 void buildPlacesOfInterestClassifications();
 void removeDoubles(vector<unsigned>& vect);
 void getAvgLatRad();
 t_point convertToWorld(LatLon point);
 float computeArea(unsigned featureID);
-vector<string> separateString(string str);
-bool firstWithinSecond(const vector<string>& first, const vector<string>& second);
-double latRad;
 
-vector<const char*> allNames;
 void buildAllNamesVector();
+void buildNameTokenIndexes();
 
 //load the map
 
 bool load_map(string map_name) {
-    bool load_success = loadStreetsDatabaseBIN(map_name);
+    string osmName = convertMapToOSMName(map_name);
+    string cacheName = convertMapToCacheName(map_name);
+    bool streetsMMapCurrent = isNewerThan(convertMapToMMapName(map_name), map_name);
+    bool streetsLoaded = false, streetsLoadedBIN = false, osmLoaded = false;
+    bool haveMapKey = false, cached = false;
+    unsigned long long mapKey = 0;
+    vector<RoadClass> roadClasses;
+    bool haveRoadClasses = false, roadClassesUnsaved = false;
     
-    if (load_success) {
-        buildStreetsTable();
-        buildIntersectionStreetSegments();
-        buildStreetStreetSegmentsAndIntersections();
-        buildIntersectionskdTree();
-        buildSortedFeatures();
-        buildPlacesOfInterestClassifications();
-        getAvgLatRad();
-        buildAllNamesVector();
+    // The stages form a dependency graph: the streets database, the OSM
+    // database and the cache of derived structures are read concurrently,
+    // then the builders (which only read the streets database and each set
+    // their own FastStructs members) run concurrently. Stages whose inputs
+    // failed to load do nothing.
+    TaskGraph stages;
+    
+    unsigned streets = stages.addTask("load streets", [&] {
+        streetsLoaded = loadStreets(map_name, streetsLoadedBIN);
+    });
+    
+    // The OSM database is only needed for the road class of each street
+    // segment, which the memory-mapped streets database stores. If that is
+    // current, wait to see whether it has them rather than loading OSM
+    // speculatively.
+    vector<unsigned> osmDependencies;
+    if (streetsMMapCurrent)
+        osmDependencies.push_back(streets);
+    unsigned osm = stages.addTask("load OSM", [&] {
+        if (!streetsMMapCurrent || (streetsLoaded && !hasStreetSegmentRoadClasses()))
+            osmLoaded = loadOSM(osmName);
+    }, osmDependencies);
+    
+    // The derived structures only depend on the map files, so reuse the
+    // ones cached by a previous load of the same files if there are any
+    unsigned cache = stages.addTask("load cache", [&] {
+        haveMapKey = computeMapKey(map_name, osmName, mapKey);
+        cached = haveMapKey &&
+                FastStructs::getInstance().loadCache(cacheName, mapKey);
+    });
+    
+    unsigned classes = stages.addTask("road classes", [&] {
+        if (!streetsLoaded)
+            return;
         
-        string osmName = convertMapToOSMName(map_name);
-        load_success = loadOSM(osmName);
-    }
+        if (hasStreetSegmentRoadClasses()) {
+            unsigned numberOfStreetSegments = getNumberOfStreetSegments();
+            roadClasses.resize(numberOfStreetSegments);
+            for (unsigned seg = 0; seg < numberOfStreetSegments; seg++)
+                roadClasses[seg] = getStreetSegmentRoadClass(seg);
+            haveRoadClasses = true;
+        } else if (osmLoaded) {
+            roadClasses = buildRoadClassesFromOSM();
+            // A memory-mapped database is read-only; its file is rewritten
+            // with the classes below so later loads can skip OSM
+            roadClassesUnsaved = !setStreetSegmentRoadClasses(roadClasses);
+            haveRoadClasses = true;
+        }
+    }, {streets, osm});
+    
+    // Written after the road classes are set so that it stores them
+    stages.addTask("save streets mmap", [&] {
+        // Failing to write it (e.g. read-only map directory) is not an error
+        if (streetsLoadedBIN)
+            saveStreetsDatabaseMMap(convertMapToMMapName(map_name));
+        else if (roadClassesUnsaved)
+            saveStreetsDatabaseMMap(convertMapToMMapName(map_name), roadClasses);
+    }, {classes});
+    
+    unsigned averageLatitude = stages.addTask("average latitude", [&] {
+        if (streetsLoaded)
+            getAvgLatRad();
+    }, {streets});
+    
+    vector<unsigned> builders;
+    auto addBuilder = [&](string name, void (*build)(), vector<unsigned> after) {
+        after.push_back(cache);
+        builders.push_back(stages.addTask(name, [&, build] {
+            if (streetsLoaded && !cached)
+                build();
+        }, after));
+    };
+    addBuilder("streets table", buildStreetsTable, {streets});
+    addBuilder("intersection segments", buildIntersectionStreetSegments, {streets});
+    addBuilder("street segments and intersections", buildStreetStreetSegmentsAndIntersections, {streets});
+    // The feature areas are measured on the projection at the average latitude
+    addBuilder("sorted features", buildSortedFeatures, {averageLatitude});
+    addBuilder("POI classifications", buildPlacesOfInterestClassifications, {streets});
+    addBuilder("all names", buildAllNamesVector, {streets});
+    
+    builders.push_back(stages.addTask("road classifications", [&] {
+        if (haveRoadClasses && !cached)
+            buildStreetSegmentClassifications(roadClasses);
+    }, {classes, cache}));
+    
+    stages.addTask("save cache", [&] {
+        // Failing to write it (e.g. read-only map directory) is not an error
+        if (streetsLoaded && haveRoadClasses && haveMapKey && !cached)
+            FastStructs::getInstance().saveCache(cacheName, mapKey);
+    }, builders);
+    
+    unsigned kdTree = stages.addTask("kd tree", [&] {
+        if (streetsLoaded)
+            buildIntersectionskdTree();
+    }, {averageLatitude});
+    // After the first kd tree, as ANN allocates a shared empty leaf with it
+    stages.addTask("POI index", [&] {
+        if (streetsLoaded)
+            POIIndex::getInstance().build();
+    }, {kdTree});
+    stages.addTask("segment index", [&] {
+        if (streetsLoaded)
+            SegmentIndex::getInstance().build();
+    }, {averageLatitude});
+    stages.addTask("name search indexes", [&] {
+        if (streetsLoaded)
+            buildNameTokenIndexes();
+    }, {streets});
+    stages.addTask("street pair index", [&] {
+        if (streetsLoaded)
+            MapContext::current().getStreetPairIndex().build();
+    }, {streets});
+    stages.addTask("box index", [&] {
+        if (streetsLoaded)
+            BoxIndex::getInstance().build();
+    }, {streets});
+    unsigned segmentTable = stages.addTask("segment table", [&] {
+        if (streetsLoaded)
+            SegmentTable::getInstance().build();
+    }, {streets});
+    stages.addTask("routing graph", [&] {
+        if (streetsLoaded)
+            RoutingGraph::getInstance().build();
+    }, {segmentTable});
+    
+    // The stages running on other threads load into the same context
+    MapContext& context = MapContext::current();
+    stages.run(max(thread::hardware_concurrency(), 1U), [&context] {
+        MapContext::bindThread(&context);
+    });
+    context.setLoadMapTimings(stages.getTimings());
+
+    return streetsLoaded && haveRoadClasses;
+}
+
+// Returns the name and wall-clock seconds of each stage of the last load_map
 
-    return load_success;
+vector< pair<string, double> > getLoadMapTimings() {
+    return MapContext::current().getLoadMapTimings();
 }
 
 //close the map
 
 void close_map() {
+    RoutingGraph::getInstance().clear();
+    SegmentTable::getInstance().clear();
+    POIIndex::getInstance().clear();
+    MapContext::current().getStreetNameIndex().clear();
+    MapContext::current().getPOINameIndex().clear();
+    MapContext::current().getStreetPairIndex().clear();
+    BoxIndex::getInstance().clear();
+    SegmentIndex::getInstance().clear();
     closeStreetDatabase();
+    closeOSMDatabase();
+}
+
+// Load the streets database, preferring the memory-mapped copy next to the
+// map file. If there is none yet (or the map file has changed since it was
+// written), load the boost archive and set loadedBIN so that load_map writes
+// the mapped copy for next time.
+
+bool loadStreets(string map_name, bool& loadedBIN) {
+    string mmapName = convertMapToMMapName(map_name);
+    
+    loadedBIN = false;
+    if (isNewerThan(mmapName, map_name) && loadStreetsDatabaseMMap(mmapName))
+        return true;
+    
+    loadedBIN = loadStreetsDatabaseBIN(map_name);
+    return loadedBIN;
 }
 
-// Load the OSM database
+// Load the OSM database, preferring its memory-mapped copy in the same way
+// as loadStreets
 
 bool loadOSM(string map_name) {
-    bool load_OSM_success = loadOSMDatabaseBIN(map_name);
+    string mmapName = convertOSMToMMapName(map_name);
+    bool load_OSM_success = isNewerThan(mmapName, map_name) && loadOSMDatabaseMMap(mmapName);
     
-    if (load_OSM_success)
-        buildStreetSegmentClassifications();
+    if (!load_OSM_success) {
+        load_OSM_success = loadOSMDatabaseBIN(map_name);
+        if (load_OSM_success)
+            saveOSMDatabaseMMap(mmapName);
+    }
     
     return load_OSM_success;
 }
@@ -79,15 +257,92 @@ string convertMapToOSMName(string mapName) {
     return osmName;
 }
 
+// Converts a map street file name to the name of its memory-mapped copy
+string convertMapToMMapName(string mapName) {
+    string mapNameSuffix = "streets.bin";
+    
+    auto positionOfFileSuffix = mapName.find(mapNameSuffix);
+    if(positionOfFileSuffix != string::npos)
+        mapName.erase(positionOfFileSuffix, mapNameSuffix.size());
+    
+    return mapName + "streets.mmap";
+}
+
+// Converts an OSM file name to the name of its memory-mapped copy
+string convertOSMToMMapName(string osmName) {
+    string osmNameSuffix = "osm.bin";
+    
+    auto positionOfFileSuffix = osmName.find(osmNameSuffix);
+    if(positionOfFileSuffix != string::npos)
+        osmName.erase(positionOfFileSuffix, osmNameSuffix.size());
+    
+    return osmName + "osm.mmap";
+}
+
+// Converts a map street file name to the name of its derived structures cache
+string convertMapToCacheName(string mapName) {
+    string mapNameSuffix = "streets.bin";
+    
+    auto positionOfFileSuffix = mapName.find(mapNameSuffix);
+    if(positionOfFileSuffix != string::npos)
+        mapName.erase(positionOfFileSuffix, mapNameSuffix.size());
+    
+    return mapName + "m1.cache";
+}
+
+// Computes a 64-bit FNV-1a hash of the size and modification time of the
+// streets file and, if there is one, the OSM file. Only the file metadata is
+// read, so checking the cache does not touch the (large) map files. Returns
+// false if the streets file can't be found.
+bool computeMapKey(string map_name, string osmName, unsigned long long& mapKey) {
+    const unsigned long long fnvPrime = 1099511628211ULL;
+    mapKey = 14695981039346656037ULL;
+    
+    for(const string& fileName : {map_name, osmName}) {
+        struct stat fileStat;
+        if(stat(fileName.c_str(), &fileStat) != 0) {
+            if(fileName == osmName)
+                continue;
+            return false;
+        }
+        
+        const unsigned long long fields[] = {
+            (unsigned long long) fileStat.st_size,
+            (unsigned long long) fileStat.st_mtim.tv_sec,
+            (unsigned long long) fileStat.st_mtim.tv_nsec
+        };
+        for(unsigned long long field : fields) {
+            for(unsigned byte = 0; byte < sizeof(field); byte++) {
+                mapKey ^= (field >> (8 * byte)) & 0xff;
+                mapKey *= fnvPrime;
+            }
+        }
+    }
+    
+    return true;
+}
+
+// True if fileName exists and was modified no earlier than otherFileName
+bool isNewerThan(string fileName, string otherFileName) {
+    struct stat fileStat, otherFileStat;
+    
+    if(stat(fileName.c_str(), &fileStat) != 0)
+        return false;
+    if(stat(otherFileName.c_str(), &otherFileStat) != 0)
+        return true;
+    
+    return fileStat.st_mtime >= otherFileStat.st_mtime;
+}
+
 //function to return street id(s) for a street name
 //return a 0-length vector if no street with this name exists.
 
 vector<unsigned> find_street_ids_from_name(string street_name) {
-    // Initialize the returned vector
-    vector<unsigned> streetIDs =
-            FastStructs::getInstance().getStreetIDsFromName(street_name);
+    return find_street_ids_from_name_range(street_name).toVector();
+}
 
-    return streetIDs;
+IdRange find_street_ids_from_name_range(const string& street_name) {
+    return FastStructs::getInstance().getStreetIDRangeFromName(street_name);
 }
 //function to return street names at an intersection (include duplicate street names in returned vector)
 
@@ -95,22 +350,20 @@ vector<string> find_intersection_street_names(unsigned intersection_id) {
     // Initialize the returned vector of street names
     vector<string> streetNames;
 
-    // Create a vector of segmentIDs at the given intersection id
-    vector<unsigned> segmentsAtIntersection =
-            FastStructs::getInstance().getSegmentsAtIntersection(intersection_id);
+    // The segmentIDs at the given intersection id
+    IdRange segmentsAtIntersection =
+            find_intersection_street_segments_range(intersection_id);
+    streetNames.reserve(segmentsAtIntersection.size());
 
-    // For each segmentID in the vector,
-    // acquire the streetID and use getStreetName function from StreetsDataBaseAPI
-    // to get the name of the street segment and push back the name into the
-    // streetNames vector
+    // For each segmentID in the vector, acquire the streetID and push back
+    // the name of its street (read in place from the interned names) into
+    // the streetNames vector
     for (auto segmentIter = segmentsAtIntersection.begin();
             segmentIter < segmentsAtIntersection.end();
             segmentIter++) {
-        unsigned segmentID = *segmentIter;
-        StreetSegmentInfo segInfo = getStreetSegmentInfo(segmentID);
-        unsigned streetID = segInfo.streetID;
-        string streetName = getStreetName(streetID);
-        streetNames.push_back(streetName);
+        unsigned streetID = SegmentTable::getInstance().getStreetID(*segmentIter);
+        boost::string_view streetName = getStreetNameView(streetID);
+        streetNames.emplace_back(streetName.data(), streetName.size());
     }
 
     return streetNames;
@@ -119,11 +372,11 @@ vector<string> find_intersection_street_names(unsigned intersection_id) {
 // function to return the street segments for a given intersection
 
 vector<unsigned> find_intersection_street_segments(unsigned intersection_id) {
-    // Initialize the returned vector with the information from
-    // FastStructs data structure
-    vector<unsigned> streetSegs = FastStructs::getInstance().getSegmentsAtIntersection(intersection_id);
+    return find_intersection_street_segments_range(intersection_id).toVector();
+}
 
-    return streetSegs;
+IdRange find_intersection_street_segments_range(unsigned intersection_id) {
+    return FastStructs::getInstance().getSegmentsAtIntersection(intersection_id);
 }
 
 //find all intersections reachable by traveling down one street segment
@@ -131,12 +384,11 @@ vector<unsigned> find_intersection_street_segments(unsigned intersection_id) {
 //the returned vector should NOT contain duplicate intersections
 
 vector<unsigned> find_adjacent_intersections(unsigned intersection_id) {
-    // Initialize the returned vector with the information from
-    // FastStructs data structure
-    vector<unsigned> intersectionIDs =
-            FastStructs::getInstance().getAdjacentIntersections(intersection_id);
+    return find_adjacent_intersections_range(intersection_id).toVector();
+}
 
-    return intersectionIDs;
+IdRange find_adjacent_intersections_range(unsigned intersection_id) {
+    return FastStructs::getInstance().getAdjacentIntersections(intersection_id);
 }
 
 //can you get from intersection1 to intersection2 using a single street segment (hint: check for 1-way streets too)
@@ -147,44 +399,29 @@ bool are_directly_connected(unsigned intersection_id1, unsigned intersection_id2
     if (intersection_id1 == intersection_id2)
         return true;
 
-    // Initialize a vector of all intersections reachable from intersection_id1
-    vector<unsigned> intersectionsFrom1 = find_adjacent_intersections(intersection_id1);
-
-    // Initialize iterators at begin() and  end() of the vector above
-    auto first = intersectionsFrom1.begin();
-    auto last = intersectionsFrom1.end();
-    // Initialize an iterator using find() to see if intersection_id2 is a
-    // reachable intersection from intersection_id1
-    auto found = find(first, last, intersection_id2);
-
-    // If found is not at the end(), return true because intersection_id2 is
-    // reachable
-    if (found != last)
-        return true;
-    // Otherwise return false
-    return false;
+    // Binary search the (sorted) intersections reachable from intersection_id1
+    return FastStructs::getInstance().isAdjacentIntersection(
+            intersection_id1, intersection_id2);
 }
 
 //for a given street, return all the street segments
 
 vector<unsigned> find_street_street_segments(unsigned street_id) {
-    // Initialize the returned vector with the information from
-    // FastStructs data structure
-    vector<unsigned> connectedSegments =
-            FastStructs::getInstance().getSegmentsOnStreet(street_id);
+    return find_street_street_segments_range(street_id).toVector();
+}
 
-    return connectedSegments;
+IdRange find_street_street_segments_range(unsigned street_id) {
+    return FastStructs::getInstance().getSegmentsOnStreet(street_id);
 }
 
 //for a given street, find all the intersections
 
 std::vector<unsigned> find_all_street_intersections(unsigned street_id) {
-    // Initialize the returned vector with the information from
-    // FastStructs data structure
-    vector<unsigned> connectedIntersections =
-            FastStructs::getInstance().getIntersectionsOnStreet(street_id);
+    return find_all_street_intersections_range(street_id).toVector();
+}
 
-    return connectedIntersections;
+IdRange find_all_street_intersections_range(unsigned street_id) {
+    return FastStructs::getInstance().getIntersectionsOnStreet(street_id);
 }
 
 
@@ -195,114 +432,23 @@ std::vector<unsigned> find_all_street_intersections(unsigned street_id) {
 std::vector<unsigned> find_intersection_ids_from_street_names
 (std::string street_name1, std::string street_name2) {
 
-    // form sorted 2D vectors of:
-    //      all street_name1 intersections
-    //      all street_name2 intersections
-    vector<unsigned> streetIDs1 = find_street_ids_from_name(street_name1);
-    vector< vector<unsigned> > intersections1(streetIDs1.size());
-    for (unsigned streetNum = 0; streetNum < streetIDs1.size(); streetNum++) {
-        unsigned currentStreetID = streetIDs1[streetNum];
-        intersections1[streetNum] = find_all_street_intersections(currentStreetID);
-    }
-
-    vector<unsigned> streetIDs2 = find_street_ids_from_name(street_name2);
-    vector< vector<unsigned> > intersections2(streetIDs2.size());
-    for (unsigned streetNum = 0; streetNum < streetIDs2.size(); streetNum++) {
-        unsigned currentStreetID = streetIDs2[streetNum];
-        intersections2[streetNum] = find_all_street_intersections(currentStreetID);
-    }
-
-    // every column of intersection in the 2D vectors is sorted,
-    // we can efficiently compare each column
-    //
-    // for every column of intersections in street1,
-    // check every column of intersection in street2 for a match 
-    vector<unsigned> intersectionsBetweenStreets;
-
-    for (auto streetIDIter1 = intersections1.begin();
-            streetIDIter1 < intersections1.end();
-            streetIDIter1++) {
-        for (auto streetIDIter2 = intersections2.begin();
-                streetIDIter2 < intersections2.end();
-                streetIDIter2++) {
-            // use iters to search through the 2 current columns
-            auto intersectionIter1 = (*streetIDIter1).begin();
-            auto intersectionIter2 = (*streetIDIter2).begin();
-            while (
-                    intersectionIter1 < (*streetIDIter1).end() &&
-                    intersectionIter2 < (*streetIDIter2).end()) {
-
-                // if there is a match, add it and increment
-                if (*intersectionIter1 == *intersectionIter2) {
-                    intersectionsBetweenStreets.push_back(*intersectionIter2);
-                    intersectionIter1++;
-                } else if (*intersectionIter1 < *intersectionIter2) {
-                    intersectionIter1++;
-                } else {
-                    intersectionIter2++;
-                }
-            }
-        }
-    }
-
-    removeDoubles(intersectionsBetweenStreets);
+    // Streets with the same name share its interned id, so the first
+    // street with each name gives the pair to look up
+    IdRange streetIDs1 = find_street_ids_from_name_range(street_name1);
+    IdRange streetIDs2 = find_street_ids_from_name_range(street_name2);
+    if (streetIDs1.empty() || streetIDs2.empty())
+        return vector<unsigned>();
 
-    return intersectionsBetweenStreets;
+    return MapContext::current().getStreetPairIndex().intersections(
+            getStreetNameID(streetIDs1[0]),
+            getStreetNameID(streetIDs2[0])).toVector();
 }
 
 //find the length of a given street segment
 
 double find_street_segment_length(unsigned street_segment_id) {
-    // Initialize returned variable
-    // Initialize curveID to 0
-    // Get the StreetSegmentInfo of the given street segment
-    double length = 0.0;
-    unsigned curveID = 0;
-    StreetSegmentInfo segInfo = getStreetSegmentInfo(street_segment_id);
-
-    // Acquire the starting and ending LatLon of the given street segment
-    // Also initialize pointA and pointB, which will be used for computing
-    // Street segment length of a curved street segment
-    LatLon pointStart, pointEnd, pointA, pointB;
-    pointStart = getIntersectionPosition(segInfo.from);
-    pointEnd = getIntersectionPosition(segInfo.to);
-
-    // If the street segment is not curved, then compute the length
-    // using find_distance_between_two_points();)
-    if (segInfo.curvePointCount == 0)
-        return find_distance_between_two_points(pointStart, pointEnd);
-
-        // If the street segment only has one curve point, then compute the distance
-        // between the start of the segment to the curve point and the distance
-        // between the curve point to the end of the segment and return their sum
-    else if (segInfo.curvePointCount == 1) {
-        curveID = 0;
-        pointA = getStreetSegmentCurvePoint(street_segment_id, curveID);
-
-        length += find_distance_between_two_points(pointStart, pointA);
-        length += find_distance_between_two_points(pointA, pointEnd);
-        return length;
-    }
-        // If the street segment has more than one curve point, then compute
-        // the distance between start of the segment to the first curve point and 
-        // the distance between the last curve point and the end of the segment;
-        // also compute the distances between all the curve points.
-        // Return the sum of all the distances
-    else {
-        curveID = 0;
-        pointA = getStreetSegmentCurvePoint(street_segment_id, curveID);
-        length += find_distance_between_two_points(pointStart, pointA);
-
-        for (curveID = 0;
-                curveID < segInfo.curvePointCount - 1;
-                curveID++) {
-            pointA = getStreetSegmentCurvePoint(street_segment_id, curveID);
-            pointB = getStreetSegmentCurvePoint(street_segment_id, curveID + 1);
-            length += find_distance_between_two_points(pointA, pointB);
-        }
-        length += find_distance_between_two_points(pointB, pointEnd);
-    }
-    return length;
+    // Precomputed at load_map from the segment's curve points
+    return SegmentTable::getInstance().getLength(street_segment_id);
 }
 
 //find distance between two coordinates
@@ -324,120 +470,206 @@ double find_distance_between_two_points(LatLon point1, LatLon point2) {
 }
 
 double find_street_length(unsigned street_id) {
-    // Initialize returned variable
-    double length = 0.0;
-    // Initialize a vector of all street segments in the given street
-    vector<unsigned> streetSegments = find_street_street_segments(street_id);
-
-    // Find the lengths of all street segments in the streetSegments vector
-    // and return the sum
-    for (auto segmentIter = streetSegments.begin();
-            segmentIter < streetSegments.end();
-            segmentIter++) {
-        length += find_street_segment_length(*segmentIter);
-    }
-    return length;
+    // Sum the lengths of all street segments in the given street
+    IdRange streetSegments = find_street_street_segments_range(street_id);
+
+    return SegmentTable::getInstance().getTotalLength(
+            streetSegments.begin(), streetSegments.size());
 }
 
 //find the travel time to drive a street segment (time(minutes) = distance(km)/speed_limit(km/hr) * 60
 
 double find_street_segment_travel_time(unsigned street_segment_id) {
-    // Acquire the StreetSegmentInfo of the given street segment
-    StreetSegmentInfo segInfo = getStreetSegmentInfo(street_segment_id);
-
-    // Find the distance of the given street segment
-    double distance = find_street_segment_length(street_segment_id);
-    // Acquire the speed limit of the given street segment
-    float speedLimit = segInfo.speedLimit;
-
-    // Compute the distance using the speed limit and the calculated distance
-    return distance / 1000 / speedLimit * 60;
+    // Precomputed at load_map from the segment's length and speed limit,
+    // and redone by RoutingGraph::updateWeights when either changes
+    return RoutingGraph::getInstance().getWeights()->segmentTravelTime.at(street_segment_id);
 }
 
 //find the nearest point of interest to a given position
 
 unsigned find_closest_point_of_interest(LatLon my_position) {
-    double shortestDistance;
-    unsigned closestPOI;
-
-    // Initialize the shortest distance with the ID of
-    // the first POI
-    LatLon poiPosition = getPointOfInterestPosition(0);
-    double distance = find_distance_between_two_points(my_position,
-            poiPosition);
-    shortestDistance = distance;
-    closestPOI = 0;
-
-    // Find the shortest distance by cycling through the rest
-    // of the intersections
-    unsigned maxPOIs = getNumberOfPointsOfInterest();
-    for (unsigned poiID = 1;
-            poiID < maxPOIs;
-            poiID++) {
-        poiPosition = getPointOfInterestPosition(poiID);
-        distance = find_distance_between_two_points(my_position,
-                poiPosition);
-        if (distance < shortestDistance) {
-            shortestDistance = distance;
-            closestPOI = poiID;
-        }
-    }
+    // Ties go to the lowest POI id
+    return POIIndex::getInstance().closest(my_position).id;
+}
+
+// Returns the ids of matches, in order
+static vector<unsigned> poiIDsOf(const vector<POIIndex::Match>& matches) {
+    vector<unsigned> poiIDs(matches.size());
+    for (unsigned i = 0; i < matches.size(); i++)
+        poiIDs[i] = matches[i].id;
+    return poiIDs;
+}
+
+//find the (up to) k nearest points of interest, nearest first
+
+vector<unsigned> find_closest_points_of_interest(LatLon my_position, unsigned k) {
+    return poiIDsOf(POIIndex::getInstance().nearest(my_position, k));
+}
+
+vector<unsigned> find_closest_points_of_interest(LatLon my_position, unsigned k,
+        string type) {
+    return poiIDsOf(POIIndex::getInstance().nearest(my_position, k, type));
+}
+
+//find the points of interest within radius meters, nearest first
+
+vector<unsigned> find_points_of_interest_within(LatLon my_position, double radius) {
+    return poiIDsOf(POIIndex::getInstance().withinRadius(my_position, radius));
+}
 
-    return closestPOI;
+vector<unsigned> find_points_of_interest_within(LatLon my_position, double radius,
+        string type) {
+    return poiIDsOf(POIIndex::getInstance().withinRadius(my_position, radius, type));
 }
 
 //find the nearest intersection (by ID) to a given position
 //This function uses an external library, ANN
 //which is a library that uses kd tree
 
+// The nearest intersection to my_position, and its distance (meters) in
+// distance. Returns 0 (and an infinite distance) if the map has none.
+// The kd tree indexes the same projection find_distance_between_two_points
+// measures, so its nearest intersection is the closest (see ProjectedTree).
+static unsigned closestIntersection(const FastStructs& fastStructs,
+        ANNsearchContext& searchContext, LatLon my_position, double& distance) {
+    ProjectedTree::Match closest =
+            fastStructs.getClosestIntersection(searchContext, my_position);
+    distance = closest.distance;
+    return closest.id;
+}
+
+// The search's scratch state, kept by each thread so that threads can
+// query at once and repeated queries allocate nothing
+static thread_local ANNsearchContext intersectionSearchContext;
+
 unsigned find_closest_intersection(LatLon my_position) {
-    // Create an ANNpoint with the location so that we can use the
-    // ANN kd tree library function to find the nearest neighbors
-    ANNpoint location = annAllocPt(2);
-    location[0] = my_position.lon;
-    location[1] = my_position.lat;
-
-    // Number of nearest intersections to my_position that will be returned
-    unsigned numOfNearest = 5;
-
-    // Array that will hold the numOfNearest intersections to my_position
-    ANNidxArray nearIntersectionIDs = new ANNidx[numOfNearest];
-
-    // The closest point is computed based on the standard pythagorean distance
-    // formula as opposed to the distance between two points formula for lat lon
-    // coordinates. For this reason, numOfNearest intersections are returned
-    // and then the true lat lon distance formula is used to compare the 
-    // closest of the returned intersectionIDs.
-    FastStructs::getInstance().getClosestIntersectionIDs(location,
-            nearIntersectionIDs,
-            numOfNearest);
-
-    // Initialise the closest intersection to the first one returned.
-    unsigned closestID = nearIntersectionIDs[0];
-    LatLon intersectionPosition = getIntersectionPosition(closestID);
-    double distance = find_distance_between_two_points(my_position,
-            intersectionPosition);
-    double shortestDistance = distance;
-
-    // Cycle through all the intersection ids in the array and compute the 
-    // distance between the intersection and the given position.
-    // If the computed distance is smaller than the distance computed previously,
-    // the the new intersection id is the closest intersection
-    for (unsigned i = 1; i < numOfNearest; i++) {
-        unsigned intersectionID = nearIntersectionIDs[i];
-        intersectionPosition = getIntersectionPosition(intersectionID);
-        distance = find_distance_between_two_points(my_position,
-                intersectionPosition);
-        if (distance < shortestDistance) {
-            shortestDistance = distance;
-            closestID = intersectionID;
-        }
+    double distance;
+    return closestIntersection(FastStructs::getInstance(),
+            intersectionSearchContext, my_position, distance);
+}
+
+// Interleaves the bits of x and y (16 bits each) into a Morton (Z-order) code
+static unsigned mortonCode(unsigned x, unsigned y) {
+    unsigned code = 0;
+    for (unsigned bit = 0; bit < 16; bit++) {
+        code |= ((x >> bit) & 1) << (2 * bit);
+        code |= ((y >> bit) & 1) << (2 * bit + 1);
     }
+    return code;
+}
+
+// The order in which to answer the queries at positions: along a Morton
+// curve over their bounding box, so that consecutive queries (and so each
+// chunk of them) search the same parts of the kd tree
+static vector<unsigned> mortonOrder(const vector<LatLon>& positions) {
+    float minLat = numeric_limits<float>::max(), maxLat = -minLat;
+    float minLon = minLat, maxLon = maxLat;
+    for (const LatLon& position : positions) {
+        minLat = min(minLat, position.lat);
+        maxLat = max(maxLat, position.lat);
+        minLon = min(minLon, position.lon);
+        maxLon = max(maxLon, position.lon);
+    }
+    double latScale = maxLat > minLat ? 65535.0 / (maxLat - minLat) : 0;
+    double lonScale = maxLon > minLon ? 65535.0 / (maxLon - minLon) : 0;
+
+    vector< pair<unsigned, unsigned> > codes(positions.size());
+    for (unsigned i = 0; i < positions.size(); i++) {
+        // NaN positions compare false above and land at code 0
+        double x = (positions[i].lon - minLon) * lonScale;
+        double y = (positions[i].lat - minLat) * latScale;
+        unsigned xCell = x > 0 ? (unsigned) min(x, 65535.0) : 0;
+        unsigned yCell = y > 0 ? (unsigned) min(y, 65535.0) : 0;
+        codes[i] = make_pair(mortonCode(xCell, yCell), i);
+    }
+    sort(codes.begin(), codes.end());
+
+    vector<unsigned> order(positions.size());
+    for (unsigned i = 0; i < positions.size(); i++)
+        order[i] = codes[i].second;
+    return order;
+}
+
+// Queries handed to a thread at a time
+#define SNAP_CHUNK_SIZE 512
+
+void find_closest_intersections(const vector<LatLon>& positions,
+        vector<unsigned>& intersectionIDs, vector<double>& distances) {
+    unsigned numOfPositions = positions.size();
+    intersectionIDs.resize(numOfPositions);
+    distances.resize(numOfPositions);
+    if (numOfPositions == 0)
+        return;
+
+    vector<unsigned> order = mortonOrder(positions);
+    unsigned numOfChunks = (numOfPositions + SNAP_CHUNK_SIZE - 1) / SNAP_CHUNK_SIZE;
+    atomic<unsigned> nextChunk(0);
+
+    // The threads answer the queries on the map of this thread
+    MapContext& context = MapContext::current();
+    auto snap = [&] {
+        MapContext::Binding binding(context);
+        const FastStructs& fastStructs = context.getFastStructs();
+        for (unsigned chunk = nextChunk++; chunk < numOfChunks; chunk = nextChunk++) {
+            unsigned end = min((chunk + 1) * SNAP_CHUNK_SIZE, numOfPositions);
+            for (unsigned i = chunk * SNAP_CHUNK_SIZE; i < end; i++) {
+                unsigned query = order[i];
+                intersectionIDs[query] = closestIntersection(fastStructs,
+                        intersectionSearchContext, positions[query],
+                        distances[query]);
+            }
+        }
+    };
+
+    unsigned numOfThreads = min(max(thread::hardware_concurrency(), 1U), numOfChunks);
+    vector<thread> threads;
+    for (unsigned i = 1; i < numOfThreads; i++)
+        threads.push_back(thread(snap));
+    snap();     // This thread takes chunks too
+    for (thread& worker : threads)
+        worker.join();
+}
+
+//find the nearest point on a street segment to a given position
+//The segment index keeps an R-tree of the segments' pieces (see SegmentIndex)
+
+SegmentMatch find_closest_street_segment(LatLon my_position) {
+    SegmentIndex::Match closest = SegmentIndex::getInstance().closest(my_position);
+    SegmentMatch match;
+    match.streetSegmentID = closest.segmentID;
+    match.position = closest.position;
+    match.offset = closest.offset;
+    match.distance = closest.distance;
+    return match;
+}
+
+//find what lies in a box of the map
+//The box index keeps an R-tree per kind of item (see BoxIndex)
+
+BoxContents query_box(LatLon corner1, LatLon corner2) {
+    const BoxIndex& boxIndex = BoxIndex::getInstance();
+    BoxContents contents;
+    contents.intersections = boxIndex.intersections(corner1, corner2);
+    contents.streetSegments = boxIndex.streetSegments(corner1, corner2);
+    contents.features = boxIndex.features(corner1, corner2);
+    contents.pointsOfInterest = boxIndex.pointsOfInterest(corner1, corner2);
+    return contents;
+}
+
+vector<unsigned> query_box_intersections(LatLon corner1, LatLon corner2) {
+    return BoxIndex::getInstance().intersections(corner1, corner2);
+}
+
+vector<unsigned> query_box_street_segments(LatLon corner1, LatLon corner2) {
+    return BoxIndex::getInstance().streetSegments(corner1, corner2);
+}
 
-    annDeallocPt(location);
-    delete [] nearIntersectionIDs;
+vector<unsigned> query_box_features(LatLon corner1, LatLon corner2) {
+    return BoxIndex::getInstance().features(corner1, corner2);
+}
 
-    return closestID;
+vector<unsigned> query_box_points_of_interest(LatLon corner1, LatLon corner2) {
+    return BoxIndex::getInstance().pointsOfInterest(corner1, corner2);
 }
 
 //get the different kinds of roads
@@ -470,16 +702,19 @@ void buildStreetsTable() {
     // streeID vectors are values
     unordered_map<string, vector<unsigned>> streetNamesToIDs;
 
+    // Group the streets by interned name id first, so that each distinct
+    // name is only copied into a string once
+    unordered_map<unsigned, vector<unsigned>> nameIDsToStreetIDs;
+
     unsigned numberOfStreets = getNumberOfStreets();
 
-    for (unsigned streetID = 0; streetID < numberOfStreets; streetID++) {
-        string streetName = getStreetName(streetID);
-        auto streetIDsIter = streetNamesToIDs.find(streetName);
-        if (streetIDsIter != streetNamesToIDs.end()) { // Entry already exists
-            streetIDsIter->second.push_back(streetID); // Add streetID to vector
-        } else { // Create the entry for the name and add vector with streetID
-            streetNamesToIDs[streetName] = vector<unsigned>(1, streetID);
-        }
+    for (unsigned streetID = 0; streetID < numberOfStreets; streetID++)
+        nameIDsToStreetIDs[getStreetNameID(streetID)].push_back(streetID);
+
+    for (auto& nameStreets : nameIDsToStreetIDs) {
+        boost::string_view streetName = getNameView(nameStreets.first);
+        streetNamesToIDs[string(streetName.data(), streetName.size())] =
+                move(nameStreets.second);
     }
 
     FastStructs::getInstance().setStreets(streetNamesToIDs);
@@ -672,80 +907,84 @@ std::vector<unsigned>& getUnknowns() {
 // Builds an ANNkd tree
 
 void buildIntersectionskdTree() {
-    FastStructs::getInstance().setIntersectionskdTree();
+    FastStructs::getInstance().setIntersectionskdTree(
+            MapContext::current().getAverageLatRad());
 }
 
-// Build structure that classifies street segments based on road type
-
-void buildStreetSegmentClassifications() {
-    unsigned numOfStreets = getNumberOfStreets();
+// Derives the road class of every street segment from the highway tag of
+// its OSM way, for streets databases that don't store them
 
-    // Different classifications
-    vector<unsigned> highways(numOfStreets);
-    vector<unsigned> motorways(numOfStreets);
-    vector<unsigned> serviceRoads(numOfStreets);
-    vector<unsigned> commercialRoads(numOfStreets);
-    vector<unsigned> localRoads(numOfStreets);
+vector<RoadClass> buildRoadClassesFromOSM() {
+    unsigned numberOfStreetSegments = getNumberOfStreetSegments();
+    vector<RoadClass> roadClasses(numberOfStreetSegments, RoadClass::None);
+    
+    // Most ways have several segments, so only look each one up once
+    unordered_map<OSMID, RoadClass> wayClasses;
     
-    // For every street segment, search through every OSM way for the
-    // one that matches the segment wayOSMID
-    unsigned long long numberOfWays = getNumberOfWays();
-    unsigned maxStreetSegs = getNumberOfStreetSegments();
-    // Maps OSM ids to the street segments that are a part of it
-    unordered_map<OSMID, vector<unsigned>> osmToSeg;    
-    for (unsigned seg = 0; seg < maxStreetSegs; seg++) {
-        StreetSegmentInfo segInfo = getStreetSegmentInfo(seg);
-        OSMID segOSM = segInfo.wayOSMID;
-        auto osmToSegIter = osmToSeg.find(segOSM);
-        if (osmToSegIter == osmToSeg.end()) {
-            osmToSeg[segOSM] = vector<unsigned>(1, seg);
-        } else {
-            osmToSegIter->second.push_back(seg);
+    // Tags are compared by index, so look the key up once
+    unsigned highwayKey = getWayTagKeyIndex("highway");
+    
+    for (unsigned seg = 0; seg < numberOfStreetSegments; seg++) {
+        OSMID wayID = getStreetSegmentInfo(seg).wayOSMID;
+        auto wayClassIter = wayClasses.find(wayID);
+        
+        if (wayClassIter == wayClasses.end()) {
+            RoadClass roadClass = RoadClass::None;
+            unsigned wayIndex = getWayIndexFromOSMID(wayID);
+            
+            if (wayIndex != -1U) {
+                unsigned highwayValue = getWayTagValueIndex(getWayByIndex(wayIndex), highwayKey);
+                if (highwayValue == -1U)
+                    roadClass = RoadClass::Other;
+                else
+                    roadClass = roadClassFromHighwayTag(getWayTagValueString(highwayValue).to_string());
+            }
+            
+            wayClassIter = wayClasses.insert(make_pair(wayID, roadClass)).first;
         }
+        
+        roadClasses[seg] = wayClassIter->second;
     }
     
-    // Go through every OSM way and add the street segment ids that are a part
-    // of it to the proper street classification category, based on the highway tag
-    for (unsigned wayIndex = 0; wayIndex < numberOfWays; wayIndex++) {
-        const OSMWay *way = getWayByIndex(wayIndex);
-        OSMID wayID = way->id();
-        auto osmToSegIter = osmToSeg.find(wayID);
-        
-        if (osmToSegIter != osmToSeg.end()) {
-            unsigned tagCount = getTagCount(way);
-            unsigned tagIdx = 0;
-            pair<string, string> tag;
-
-            do {
-                tag = getTagPair(way, tagIdx);
-                tagIdx++;
-            } while (tag.first != "highway" && tagIdx < tagCount);
-
-            if (tag.second == "motorway")
-                highways.insert(highways.end(),
-                    osmToSegIter->second.begin(),
-                    osmToSegIter->second.end());
-            else if (tag.second == "trunk" ||
-                    tag.second == "primary" ||
-                    tag.second == "motorway_link")
-                motorways.insert(motorways.end(),
-                    osmToSegIter->second.begin(),
-                    osmToSegIter->second.end());
-            else if (tag.second == "secondary" ||
-                    tag.second == "secondary_link")
-                serviceRoads.insert(serviceRoads.end(),
-                    osmToSegIter->second.begin(),
-                    osmToSegIter->second.end());
-            else if (tag.second == "tertiary" ||
-                    tag.second == "tertiary_link" ||
-                    tag.second == "unclassified")
-                commercialRoads.insert(commercialRoads.end(),
-                    osmToSegIter->second.begin(),
-                    osmToSegIter->second.end());
-            else
-                localRoads.insert(localRoads.end(),
-                    osmToSegIter->second.begin(),
-                    osmToSegIter->second.end());
+    return roadClasses;
+}
+
+// Build structure that classifies street segments based on road type
+
+void buildStreetSegmentClassifications(const vector<RoadClass>& roadClasses) {
+    // Different classifications
+    vector<unsigned> highways;
+    vector<unsigned> motorways;
+    vector<unsigned> serviceRoads;
+    vector<unsigned> commercialRoads;
+    vector<unsigned> localRoads;
+    
+    // Add every street segment to the proper street classification
+    // category. Segments whose way wasn't found have no class.
+    for (unsigned seg = 0; seg < roadClasses.size(); seg++) {
+        switch (roadClasses[seg]) {
+            case RoadClass::None:
+                break;
+            case RoadClass::Motorway:
+                highways.push_back(seg);
+                break;
+            case RoadClass::Trunk:
+            case RoadClass::Primary:
+            case RoadClass::MotorwayLink:
+                motorways.push_back(seg);
+                break;
+            case RoadClass::Secondary:
+            case RoadClass::SecondaryLink:
+                serviceRoads.push_back(seg);
+                break;
+            case RoadClass::Tertiary:
+            case RoadClass::TertiaryLink:
+            case RoadClass::Unclassified:
+                commercialRoads.push_back(seg);
+                break;
+            default:
+                localRoads.push_back(seg);
+                break;
         }
     }
 
@@ -763,17 +1002,26 @@ vector<unsigned> poiIDsFromName(string name) {
 
 // Checks if a given poi contains a tag
 bool doesContainTag(unsigned poiID, string tag) {
+    POITag tagID = poiTagFromName(tag);
+    return tagID != TAG_NONE && doesContainTag(poiID, tagID);
+}
+
+bool doesContainTag(unsigned poiID, POITag tag) {
     return FastStructs::getInstance().poiContainsTag(poiID, tag);
 }
 
-// Gets the type of a given poi
+// Gets the type (category) of a given poi
 string typeForPOI(unsigned poiID) {
-    return FastStructs::getInstance().poiType(poiID);
+    return poiTagName(categoryForPOI(poiID));
+}
+
+POICategory categoryForPOI(unsigned poiID) {
+    return FastStructs::getInstance().poiCategory(poiID);
 }
 
 // Gets the tag for a given alias
 string tagForAlias(string alias) {
-    return FastStructs::getInstance().tagForAlias(alias);
+    return poiTagName(poiTagForAlias(alias));
 }
 
 // Gets the average latitude of a city in radians
@@ -793,7 +1041,7 @@ void getAvgLatRad() {
     }
     
     // Get the mean of the extremes
-    latRad = (minLat + maxLat) / 2.0 * DEG_TO_RAD;
+    MapContext::current().setAverageLatRad((minLat + maxLat) / 2.0 * DEG_TO_RAD);
 }
 
 // Converts latitude longitude to world coordinates in meters for the map.
@@ -802,6 +1050,7 @@ t_point convertToWorld(LatLon point) {
     double lat = point.lat * DEG_TO_RAD;
     double lon = point.lon * DEG_TO_RAD;
     
+    double latRad = MapContext::current().getAverageLatRad();
     double x = lon * cos(latRad) * EARTH_RADIUS_IN_METERS;
     double y = lat * EARTH_RADIUS_IN_METERS;
     
@@ -816,7 +1065,8 @@ float computeArea(unsigned featureID) {
     float area = 0.0;
     float maxX, minX, maxY, minY;
     unsigned numOfPoints = getFeaturePointCount(featureID);
-    t_point point = convertToWorld(getFeaturePoint(featureID, 0));
+    const LatLon* featurePoints = getFeaturePoints(featureID);
+    t_point point = convertToWorld(featurePoints[0]);
     maxX = point.x;
     minX = point.x;
     maxY = point.y;
@@ -824,7 +1074,7 @@ float computeArea(unsigned featureID) {
     
     // Find the max and min vertices of the feature
     for (unsigned pointCount = 1; pointCount < numOfPoints; pointCount++) {
-        t_point point = convertToWorld(getFeaturePoint(featureID, pointCount));
+        t_point point = convertToWorld(featurePoints[pointCount]);
         
         if(point.x < minX)
             minX = point.x;
@@ -860,141 +1110,69 @@ void removeDoubles(vector<unsigned>& vect) {
     }
 }
 
+// The distinct name ids of streets
+static vector<unsigned> streetNameIDs(const vector<unsigned>& streetIDs) {
+    vector<unsigned> nameIDs(streetIDs.size());
+    for (unsigned i = 0; i < streetIDs.size(); i++)
+        nameIDs[i] = getStreetNameID(streetIDs[i]);
+    sort(nameIDs.begin(), nameIDs.end());
+    nameIDs.erase(unique(nameIDs.begin(), nameIDs.end()), nameIDs.end());
+    return nameIDs;
+}
+
 // Find intersection ids by parts of street names
 vector<unsigned> searchIntersectionByPartsOfName(string streetName1, 
         string streetName2) {
-    // form sorted 2D vectors of:
-    //      all street_name1 intersections
-    //      all street_name2 intersections
+    // The distinct names of the streets matching each part, every pair
+    // of which is looked up in the street pair index
     vector<unsigned> streetIDs1 = searchStreetByPartOfName(streetName1);
-    vector< vector<unsigned> > intersections1(streetIDs1.size());
-    for (unsigned streetNum = 0; streetNum < streetIDs1.size(); streetNum++) {
-        unsigned currentStreetID = streetIDs1[streetNum];
-        intersections1[streetNum] = find_all_street_intersections(currentStreetID);
-    }
-
+    vector<unsigned> nameIDs1 = streetNameIDs(streetIDs1);
     vector<unsigned> streetIDs2 = searchStreetByPartOfName(streetName2);
-    vector< vector<unsigned> > intersections2(streetIDs2.size());
-    for (unsigned streetNum = 0; streetNum < streetIDs2.size(); streetNum++) {
-        unsigned currentStreetID = streetIDs2[streetNum];
-        intersections2[streetNum] = find_all_street_intersections(currentStreetID);
-    }
-
-    // every column of intersection in the 2D vectors is sorted,
-    // we can efficiently compare each column
-    //
-    // for every column of intersections in street1,
-    // check every column of intersection in street2 for a match 
-    vector<unsigned> intersectionsBetweenStreets;
-
-    for (auto streetIDIter1 = intersections1.begin();
-            streetIDIter1 < intersections1.end();
-            streetIDIter1++) {
-        for (auto streetIDIter2 = intersections2.begin();
-                streetIDIter2 < intersections2.end();
-                streetIDIter2++) {
-            // use iters to search through the 2 current columns
-            auto intersectionIter1 = (*streetIDIter1).begin();
-            auto intersectionIter2 = (*streetIDIter2).begin();
-            while (
-                    intersectionIter1 < (*streetIDIter1).end() &&
-                    intersectionIter2 < (*streetIDIter2).end()) {
-
-                // if there is a match, add it and increment
-                if (*intersectionIter1 == *intersectionIter2) {
-                    intersectionsBetweenStreets.push_back(*intersectionIter2);
-                    intersectionIter1++;
-                } else if (*intersectionIter1 < *intersectionIter2) {
-                    intersectionIter1++;
-                } else {
-                    intersectionIter2++;
-                }
-            }
-        }
-    }
-
-    removeDoubles(intersectionsBetweenStreets);
+    vector<unsigned> nameIDs2 = streetNameIDs(streetIDs2);
 
-    return intersectionsBetweenStreets;
+    return MapContext::current().getStreetPairIndex().intersections(nameIDs1,
+            nameIDs2);
 }
 
 // Find street ids by parts of a name
 vector<unsigned> searchStreetByPartOfName(string searchField) {
-    vector<unsigned> streetIDs; // ids of streets's that contain searchField
-    
     // Separate the searchField into its constituent words
     vector<string> searchWords = separateString(searchField);
     string upperSearchField = capitalizeWords(searchField); // Capitalized version
     vector<string> upperSearchWords = separateString(upperSearchField);
     
-    // For every street
-    unsigned numOfStreets = getNumberOfStreets();
-    for(unsigned streetID = 0; streetID < numOfStreets; streetID++) {
-        string streetName = getStreetName(streetID);
-        vector<string> streetWords = separateString(streetName);    // Separate into
-                                                                    // constituent words
-        // If either the search field or its capitalized version is within
-        // the street name, that street id is a match
-        if(firstWithinSecond(searchWords, streetWords) ||
-                firstWithinSecond(upperSearchWords, streetWords))
-            streetIDs.push_back(streetID);
-    }
-    
-    return streetIDs;
+    // A street matches if the words of either the search field or its
+    // capitalized version appear consecutively in the street name
+    return MapContext::current().getStreetNameIndex().search(searchWords,
+            upperSearchWords);
 }
 
 // Find point of interest ids by part of a name
 vector<unsigned> searchPOIByPartOfName(string searchField) {
-    vector<unsigned> poiIDs;    // ids of poi's that contain searchField
-    
     // Separate the searchField into its constituent words
     vector<string> searchWords = separateString(searchField);
     string upperSearchField = capitalizeWords(searchField); // Capitalized version
     vector<string> upperSearchWords = separateString(upperSearchField);
     
-    // For every poi
-    unsigned numOfPOIs = getNumberOfPointsOfInterest();
-    for(unsigned poiID = 0; poiID < numOfPOIs; poiID++) {
-        string poiName = getPointOfInterestName(poiID);
-        vector<string> poiWords = separateString(poiName);  // Separate into
-                                                            // constituent words
-        // If either the search field or its capitalized version is within
-        // the point of interest name, that poi id is a match
-        if(firstWithinSecond(searchWords, poiWords) ||
-                firstWithinSecond(upperSearchWords, poiWords))
-            poiIDs.push_back(poiID);
-    }
-    
-    return poiIDs;
+    // As searchStreetByPartOfName
+    return MapContext::current().getPOINameIndex().search(searchWords,
+            upperSearchWords);
 }
 
-// Checks if a vector of words is part of another vector of words
-bool firstWithinSecond(const vector<string>& first, const vector<string>& second) {
-    
-    unsigned sizeOfFirst = first.size();
-    unsigned sizeOfSecond = second.size();
-    
-    // First is larger than second. Cannot be within it.
-    if(sizeOfFirst > sizeOfSecond)
-        return false;
-    
-    // The max amount of iterations we have to go through to compare both vectors
-    unsigned idxOfComparison = sizeOfSecond - sizeOfFirst;
-    
-    for(unsigned i = 0; i <= idxOfComparison; i++) {    // For a given segment within
-        bool isWithin = true;                           // second,
-        for(unsigned j = 0; j < sizeOfFirst; j++) {     // Check if first is within
-            if(first[j] != second[i+j]) {               // that segment
-                isWithin = false;
-                break;
-            }
-        }
-        
-        if(isWithin)
-            return true;
-    }
+// Builds the word indexes of the street and poi names that
+// searchStreetByPartOfName and searchPOIByPartOfName search
+void buildNameTokenIndexes() {
+    unsigned numOfStreets = getNumberOfStreets();
+    vector<unsigned> streetNameIDs(numOfStreets);
+    for(unsigned streetID = 0; streetID < numOfStreets; streetID++)
+        streetNameIDs[streetID] = getStreetNameID(streetID);
+    MapContext::current().getStreetNameIndex().build(streetNameIDs);
     
-    return false;
+    unsigned numOfPOIs = getNumberOfPointsOfInterest();
+    vector<unsigned> poiNameIDs(numOfPOIs);
+    for(unsigned poiID = 0; poiID < numOfPOIs; poiID++)
+        poiNameIDs[poiID] = getPointOfInterestNameID(poiID);
+    MapContext::current().getPOINameIndex().build(poiNameIDs);
 }
 
 // Takes in a string and converts the first letter
@@ -1049,299 +1227,60 @@ vector<string> separateString(string str) {
 void buildPlacesOfInterestClassifications() {
     unsigned numOfPOIs = getNumberOfPointsOfInterest();
     unordered_map<string, vector<unsigned>> poiNamesToIDs;
-    vector< vector<string> > poiTags(numOfPOIs);
+    unordered_map<unsigned, vector<unsigned>> nameIDsToPOIIDs;
+    vector<unsigned char> poiCategories(numOfPOIs);
+    vector<POITagSet> poiTags(numOfPOIs);
     
     for (unsigned poiID = 0; poiID < numOfPOIs; poiID++) {
-        string name = getPointOfInterestName(poiID);
-        string type = getPointOfInterestType(poiID);
+        boost::string_view type = getPointOfInterestTypeView(poiID);
         
-        // Build hash table
-        auto poiIDsIter = poiNamesToIDs.find(name);
-        if (poiIDsIter != poiNamesToIDs.end()) { // Entry already exists
-            poiIDsIter->second.push_back(poiID); // Add poiID to vector
-        } else { // Create the entry for the name and add vector with poiID
-            poiNamesToIDs[name] = vector<unsigned>(1, poiID);
-        }
+        // Group by interned name id for the hash table
+        nameIDsToPOIIDs[getPointOfInterestNameID(poiID)].push_back(poiID);
         
-        // Build classifications
-        if(type == "fuel") {
-            poiTags[poiID].push_back("automotive");
-            poiTags[poiID].push_back("gas station");
-        }
-        else if(type == "charging_station") {
-            poiTags[poiID].push_back("automotive");
-            poiTags[poiID].push_back("charging station");
-        }
-        else if(type == "Mosque") {
-            poiTags[poiID].push_back("religious");
-            poiTags[poiID].push_back("mosque");
-        }
-        else if(type == "place_of_worship") {
-            poiTags[poiID].push_back("religious");
-            poiTags[poiID].push_back("temple");
-        }
-        else if(type == "grave_yard") {
-            poiTags[poiID].push_back("religious");
-            poiTags[poiID].push_back("grave yard");
-        }
-        else if(type == "parish_hall") {
-            poiTags[poiID].push_back("religious");
-            poiTags[poiID].push_back("church");
-            poiTags[poiID].push_back("parish hall");
-        }
-        else if(type == "wedding_chapel") {
-            poiTags[poiID].push_back("religious");
-            poiTags[poiID].push_back("church");
-            poiTags[poiID].push_back("wedding chapel");
-        }
-        else if(type == "school") {
-            poiTags[poiID].push_back("education");
-            poiTags[poiID].push_back("school");
-        }
-        else if(type == "university") {
-            poiTags[poiID].push_back("education");
-            poiTags[poiID].push_back("university");
-        }
-        else if(type == "college") {
-            poiTags[poiID].push_back("education");
-            poiTags[poiID].push_back("college");
-        }
-        else if(type == "kindergarten") {
-            poiTags[poiID].push_back("education");
-            poiTags[poiID].push_back("kindergarten");
-        }
-        else if(type == "education") {
-            poiTags[poiID].push_back("education");
-        }
-        else if(type == "preschool") {
-            poiTags[poiID].push_back("education");
-            poiTags[poiID].push_back("preschool");
-        }
-        else if(type == "embassy") {
-            poiTags[poiID].push_back("public place");
-            poiTags[poiID].push_back("embassy");
-        }
-        else if(type == "courthouse") {
-            poiTags[poiID].push_back("public place");
-            poiTags[poiID].push_back("courthouse");
-        }
-        else if(type == "public_building") {
-            poiTags[poiID].push_back("public place");
-        }
-        else if(type == "townhall") {
-            poiTags[poiID].push_back("public place");
-            poiTags[poiID].push_back("townhall");
-        }
-        else if(type == "post_office") {
-            poiTags[poiID].push_back("public place");
-            poiTags[poiID].push_back("post office");
-        }
-        else if(type == "library") {
-            poiTags[poiID].push_back("public place");
-            poiTags[poiID].push_back("library");
-        }
-        else if(type == "government_office") {
-            poiTags[poiID].push_back("public place");
-            poiTags[poiID].push_back("government office");
-        }
-        else if(type == "arts_centre") {
-            poiTags[poiID].push_back("arts");
-            poiTags[poiID].push_back("arts centre");
-        }
-        else if(type == "cinema") {
-            poiTags[poiID].push_back("arts");
-            poiTags[poiID].push_back("movie theatre");
-        }
-        else if(type == "theatre") {
-            poiTags[poiID].push_back("arts");
-            poiTags[poiID].push_back("movie theatre");
-        }
-        else if(type == "music_venue") {
-            poiTags[poiID].push_back("arts");
-            poiTags[poiID].push_back("music venue");
-        }
-        else if(type == "cafe") {
-            poiTags[poiID].push_back("food");
-            poiTags[poiID].push_back("cafe");
-        }
-        else if(type == "restaurant") {
-            poiTags[poiID].push_back("food");
-            poiTags[poiID].push_back("restaurant");
-        }
-        else if(type == "fast_food") {
-            poiTags[poiID].push_back("food");
-            poiTags[poiID].push_back("fast food");
-        }
-        else if(type == "food") {
-            poiTags[poiID].push_back("food");
-        }
-        else if(type == "food_court") {
-            poiTags[poiID].push_back("food");
-            poiTags[poiID].push_back("food_court");
-        }
-        else if(type == "internet_cafe") {
-            poiTags[poiID].push_back("food");
-            poiTags[poiID].push_back("cafe");
-            poiTags[poiID].push_back("internet cafe");
-        }
-        else if(type == "Coffee Shop") {
-            poiTags[poiID].push_back("food");
-            poiTags[poiID].push_back("cafe");
-        }
-        else if(type == "ferry_terminal") {
-            poiTags[poiID].push_back("ferry");
-        }
-        else if(type == "hospital") {
-            poiTags[poiID].push_back("hospital");
-        }
-        else if(type == "pharmacy") {
-            poiTags[poiID].push_back("pharmacy");
-        }
-        else if(type == "pool; fitness centre; ice rinks") {
-            poiTags[poiID].push_back("recreation");
-            poiTags[poiID].push_back("pool");
-            poiTags[poiID].push_back("fitness centre");
-            poiTags[poiID].push_back("ice rink");
-        }
-        else if(type == "gym") {
-            poiTags[poiID].push_back("recreation");
-            poiTags[poiID].push_back("fitness centre");
-            poiTags[poiID].push_back("gym");
-        }
-        else if(type == "swimming_pool") {
-            poiTags[poiID].push_back("recreation");
-            poiTags[poiID].push_back("pool");
-        }
-        else if(type == "fitness_center" || type == "fitness centre") {
-            poiTags[poiID].push_back("recreation");
-            poiTags[poiID].push_back("fitness centre");
-        }
-        else if(type == "ice_rink") {
-            poiTags[poiID].push_back("recreation");
-            poiTags[poiID].push_back("ice rink");
-        }
-        else if(type == "gymnasium") {
-            poiTags[poiID].push_back("recreation");
-            poiTags[poiID].push_back("fitness centre");
-            poiTags[poiID].push_back("gym");
-            poiTags[poiID].push_back("gymnasium");
-        }
-        else if(type == "bar") {
-            poiTags[poiID].push_back("entertainment");
-            poiTags[poiID].push_back("bar");
-        }
-        else if(type == "pub") {
-            poiTags[poiID].push_back("entertainment");
-            poiTags[poiID].push_back("bar");
-            poiTags[poiID].push_back("pub");
-        }
-        else if(type == "bowling") {
-            poiTags[poiID].push_back("entertainment");
-            poiTags[poiID].push_back("bowling");
-        }
-        else if(type == "nightclub") {
-            poiTags[poiID].push_back("entertainment");
-            poiTags[poiID].push_back("club");
-            poiTags[poiID].push_back("nightclub");
-        }
-        else if(type == "stripclub") {
-            poiTags[poiID].push_back("entertainment");
-            poiTags[poiID].push_back("club");
-            poiTags[poiID].push_back("stripclub");
-        }
-        else if(type == "billiards") {
-            poiTags[poiID].push_back("entertainment");
-            poiTags[poiID].push_back("billiards");
-        }
-        else if(type == "karaoke") {
-            poiTags[poiID].push_back("entertainment");
-            poiTags[poiID].push_back("karaoke");
-        }
-        else if(type == "comedy_club") {
-            poiTags[poiID].push_back("entertainment");
-            poiTags[poiID].push_back("club");
-            poiTags[poiID].push_back("comedy club");
-        }
-        else if(type == "bank") {
-            poiTags[poiID].push_back("bank");
-        }
-        else if(type == "atm") {
-            poiTags[poiID].push_back("bank");
-            poiTags[poiID].push_back("atm");
-        }
-        else if(type == "observatory") {
-            poiTags[poiID].push_back("tourism");
-            poiTags[poiID].push_back("observatory");
-        }
-        else if(type == "fountain") {
-            poiTags[poiID].push_back("tourism");
-            poiTags[poiID].push_back("fountain");
-        }
-        else if(type == "police") {
-            poiTags[poiID].push_back("emergency");
-            poiTags[poiID].push_back("police station");
-        }
-        else if(type== "fire_station") {
-            poiTags[poiID].push_back("emergency");
-            poiTags[poiID].push_back("fire station");
-        }
-        else if(type == "ambulance") {
-            poiTags[poiID].push_back("emergency");
-            poiTags[poiID].push_back("ambulance station");
-        }
-        else if(type == "casino") {
-            poiTags[poiID].push_back("casino");
-        }
-        else if(type == "parking") {
-            poiTags[poiID].push_back("parking");
-        }
-        else if(type == "hotel") {
-            poiTags[poiID].push_back("lodging");
-            poiTags[poiID].push_back("hotel");
-        }
-        else if(type == "motel") {
-            poiTags[poiID].push_back("lodging");
-            poiTags[poiID].push_back("motel");
-        }
-        else if(type == "shop") {
-            poiTags[poiID].push_back("shop");
-        }
-        else if(type == "marketplace") {
-            poiTags[poiID].push_back("shop");
-            poiTags[poiID].push_back("marketplace");
-        }
-        else if(type == "bus_station") {
-            poiTags[poiID].push_back("bus station");
-        }
+        // Classify by type (see POIClassifier)
+        poiCategories[poiID] = classifyPOIType(type, poiTags[poiID]);
+    }
+    
+    // Build hash table, copying each distinct name into a string once
+    for (auto& namePOIs : nameIDsToPOIIDs) {
+        boost::string_view name = getNameView(namePOIs.first);
+        poiNamesToIDs[string(name.data(), name.size())] = move(namePOIs.second);
     }
     
     FastStructs::getInstance().setPOIs(poiNamesToIDs);
-    FastStructs::getInstance().setpoiTags(poiTags);
+    FastStructs::getInstance().setpoiClassifications(poiCategories, poiTags);
 }
 
+// Builds the sorted, deduplicated names used for tab completion.
+// Names are interned, so each distinct name is copied once.
 void buildAllNamesVector() {
     unsigned numOfStreets = getNumberOfStreets();
     unsigned numOfPOIs = getNumberOfPointsOfInterest();
-    const char* streetName;
-    const char* poiName;
-    string tempName;
+    unordered_set<unsigned> nameIDs;
+    vector<string> allNames;
     
     for (unsigned streetID = 0; 
             streetID < numOfStreets; 
             streetID++) {
-        tempName = getStreetName(streetID);
-        streetName = tempName.c_str();
-        allNames.push_back(streetName);
+        unsigned nameID = getStreetNameID(streetID);
+        if (nameIDs.insert(nameID).second)
+            allNames.push_back(getNameView(nameID).to_string());
     }
     for (unsigned poiID = 0;
             poiID < numOfPOIs;
             poiID++) {
-        tempName = getPointOfInterestName(poiID);
-        poiName = tempName.c_str();
-        allNames.push_back(poiName);
+        unsigned nameID = getPointOfInterestNameID(poiID);
+        if (nameIDs.insert(nameID).second)
+            allNames.push_back(getNameView(nameID).to_string());
     }
+    
+    FastStructs::getInstance().setAllNames(allNames);
+}
+
+const vector<string>& getSortedNames() {
+    return FastStructs::getInstance().getSortedNames();
 }
 
-vector <const char*> getAllNames() {
-    return allNames;
+pair<unsigned, unsigned> findNamesWithPrefix(const string& prefix) {
+    return FastStructs::getInstance().getNamesWithPrefix(prefix);
 }
\ No newline at end of file
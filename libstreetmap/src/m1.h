@@ -18,6 +18,9 @@ bool load_map(std::string map_name);
 //close the loaded map
 void close_map();
 
+//name and wall-clock seconds of each stage of the last load_map
+std::vector< std::pair<std::string, double> > getLoadMapTimings();
+
 //function to return street id(s) for a street name
 //return a 0-length vector if no street with this name exists.
 std::vector<unsigned> find_street_ids_from_name(std::string street_name);
@@ -43,9 +46,18 @@ std::vector<unsigned> find_street_street_segments(unsigned street_id);
 //for a given street, find all the intersections
 std::vector<unsigned> find_all_street_intersections(unsigned street_id);
 
+//zero-copy versions of the functions above: views of the loaded map's own
+//arrays, valid until the map is closed (or another is loaded into its context)
+IdRange find_street_ids_from_name_range(const std::string& street_name);
+IdRange find_intersection_street_segments_range(unsigned intersection_id);
+IdRange find_adjacent_intersections_range(unsigned intersection_id);
+IdRange find_street_street_segments_range(unsigned street_id);
+IdRange find_all_street_intersections_range(unsigned street_id);
+
 //function to return all intersection ids for two intersecting streets
 //this function will typically return one intersection id between two street names
 //but duplicate street names are allowed, so more than 1 intersection id may exist for 2 street names
+//(returned in ascending order)
 std::vector<unsigned> find_intersection_ids_from_street_names(std::string street_name1, std::string street_name2);
 
 //find distance between two coordinates
@@ -63,9 +75,53 @@ double find_street_segment_travel_time(unsigned street_segment_id);
 //find the nearest point of interest to a given position
 unsigned find_closest_point_of_interest(LatLon my_position);
 
+//find the (up to) k nearest points of interest, optionally only those of a type
+//(as getPointOfInterestType), nearest first
+std::vector<unsigned> find_closest_points_of_interest(LatLon my_position, unsigned k);
+std::vector<unsigned> find_closest_points_of_interest(LatLon my_position, unsigned k,
+        std::string type);
+
+//find the points of interest within radius meters of a given position, optionally
+//only those of a type, nearest first
+std::vector<unsigned> find_points_of_interest_within(LatLon my_position, double radius);
+std::vector<unsigned> find_points_of_interest_within(LatLon my_position, double radius,
+        std::string type);
+
 //find the nearest intersection (by ID) to a given position
 unsigned find_closest_intersection(LatLon my_position);
 
+//find the nearest intersection to each of many positions at once, on all cores;
+//intersectionIDs[i] and distances[i] (meters) are for positions[i]
+void find_closest_intersections(const std::vector<LatLon>& positions,
+        std::vector<unsigned>& intersectionIDs, std::vector<double>& distances);
+
+//find the nearest point on a street segment to a given position: the segment,
+//the point, how far along the segment (meters, from its start following its
+//curve points) the point is, and how far (meters) the point is from my_position.
+//Returns segment 0 at an infinite distance if the map has no segments.
+struct SegmentMatch {
+    unsigned streetSegmentID;
+    LatLon position;
+    double offset;
+    double distance;
+};
+SegmentMatch find_closest_street_segment(LatLon my_position);
+
+//find what lies in the box with opposite corners corner1 and corner2: the ids
+//(ascending) of the intersections, street segments, features and points of
+//interest whose bounding boxes touch it
+struct BoxContents {
+    std::vector<unsigned> intersections;
+    std::vector<unsigned> streetSegments;
+    std::vector<unsigned> features;
+    std::vector<unsigned> pointsOfInterest;
+};
+BoxContents query_box(LatLon corner1, LatLon corner2);
+std::vector<unsigned> query_box_intersections(LatLon corner1, LatLon corner2);
+std::vector<unsigned> query_box_street_segments(LatLon corner1, LatLon corner2);
+std::vector<unsigned> query_box_features(LatLon corner1, LatLon corner2);
+std::vector<unsigned> query_box_points_of_interest(LatLon corner1, LatLon corner2);
+
 //get the different kinds of roads
 std::vector<unsigned>& getLocalRoads();
 std::vector<unsigned>& getServiceRoads();
@@ -85,8 +141,12 @@ std::vector<unsigned>& getUnknowns();
 
 // POI functions
 vector<unsigned> poiIDsFromName(string name);
+// The tags, types and aliases are those of POIClassifier; a poi of no
+// known type has type "<unknown>" and no tags, and so does an unknown alias
 bool doesContainTag(unsigned poiID, string tag);
+bool doesContainTag(unsigned poiID, POITag tag);
 string typeForPOI(unsigned poiID);
+POICategory categoryForPOI(unsigned poiID);
 string tagForAlias(string alias);
 
 /* Advanced string searching functions
@@ -96,4 +156,9 @@ vector<unsigned> searchIntersectionByPartsOfName(string streetName1,
 vector<unsigned> searchStreetByPartOfName(string searchField);
 vector<unsigned> searchPOIByPartOfName(string searchField);
 string capitalizeWords(string inStr);
-vector<const char*> getAllNames();
\ No newline at end of file
+vector<string> separateString(string str);
+
+// Tab completion: the distinct street and poi names, sorted, and the range
+// [first, second) of them that start with prefix
+const vector<string>& getSortedNames();
+pair<unsigned, unsigned> findNamesWithPrefix(const string& prefix);
\ No newline at end of file
@@ -28,6 +28,27 @@ bool destIsPOI = false;
     vector<unsigned>    destPOI;
     vector<unsigned>    pathSegments;
 
+// viewport culling: the street segments of each road class and the features
+// of each kind whose bounding boxes touch the visible world (plus a margin
+// for symbols and names), in ascending id order like the full lists. Set by
+// draw_map_a before drawing, from one R-tree query each, so that a redraw
+// only visits what is on the screen.
+enum SegmentClass {
+    DRAW_LOCAL_ROADS, DRAW_COMMERCIAL_ROADS, DRAW_SERVICE_ROADS, DRAW_MOTORWAYS, DRAW_HIGHWAYS,
+    NUM_SEGMENT_CLASSES
+};
+enum FeatureClass {
+    DRAW_LAKES, DRAW_PONDS, DRAW_ISLANDS, DRAW_GREENS, DRAW_SANDS, DRAW_RIVERS, DRAW_BUILDINGS,
+    NUM_FEATURE_CLASSES
+};
+vector<unsigned> visibleSegments[NUM_SEGMENT_CLASSES];
+vector<unsigned> visibleFeatures[NUM_FEATURE_CLASSES];
+
+// The class of every street segment and feature (NUM_..._CLASSES for those
+// that aren't drawn), set by draw_map for the map being shown
+vector<unsigned char> segmentClasses;
+vector<unsigned char> featureClasses;
+
 ////////////////////////////////////////////////////////////////////////////////
 // HELPER FUNCTION DECLARATIONS
 ////////////////////////////////////////////////////////////////////////////////
@@ -36,6 +57,9 @@ bool destIsPOI = false;
 t_point convertLatLonToWorld(LatLon point);
 LatLon convertWorldToLatLon(t_point point);
 float getWidthOfCurrentWindow(); // (in km)
+void getVisibleCorners(LatLon &corner1, LatLon &corner2);
+void buildDrawClasses();
+void updateVisibleItems();
 
 
 // point manipulation
@@ -84,8 +108,8 @@ void drawLineFeatures(unsigned featureID, t_color color);
 // draw POIs
 void drawPOIs();
 void drawPOI(float windowWidth, float symbolCutoff, float textCutoff,
-        t_color symbolColor, float symbolRadius, string poiType, string name, 
-        string symbol, int symbolSize, t_point pos);
+        t_color symbolColor, float symbolRadius, const string& poiType, 
+        boost::string_view name, const string& symbol, int symbolSize, t_point pos);
 
 void drawReligious(t_point pos, float symbolRadius);
 void drawEducation(t_point pos, float symbolRadius);
@@ -184,6 +208,7 @@ void draw_map(){
     // Set the world (drawing) coordinates for the loaded map
     t_bound_box worldCoord = getWorldCoordinates();
     set_visible_world(worldCoord);
+    buildDrawClasses();
 
     // Set the buttons
     destroy_button("PostScript");
@@ -214,6 +239,7 @@ void draw_map(){
 // actual draw map
 void draw_map_a() {
     clearscreen();
+    updateVisibleItems();
     
     // Features
     drawLakes();
@@ -253,13 +279,13 @@ void draw_map_a() {
 ////////////////////////////////////////////////////////////////////////////////
 // FEATURE DRAWING
 ////////////////////////////////////////////////////////////////////////////////
-// 1) get the vector of features of the feature type
+// 1) get the vector of visible features of the feature type
 // 2) set the color for the feature type
 // 3) draw every feature, either as a polygon or as a line
 
 void drawLakes() {
     // get points and color
-    vector<unsigned> lakes = getLakes();
+    const vector<unsigned>& lakes = visibleFeatures[DRAW_LAKES];
     t_color color = LIGHTSKYBLUE;
     
     // for every "lake" draw either polygon or line
@@ -282,7 +308,7 @@ void drawLakes() {
 
 void drawPonds() {
     // get points and color
-    vector<unsigned> ponds = getPonds();
+    const vector<unsigned>& ponds = visibleFeatures[DRAW_PONDS];
     t_color color = LIGHTSKYBLUE;
     
     for (auto iter = ponds.begin();
@@ -302,7 +328,7 @@ void drawPonds() {
 }
 void drawIslands() {
     // get points and color
-    vector<unsigned> islands = getIslands();
+    const vector<unsigned>& islands = visibleFeatures[DRAW_ISLANDS];
     t_color color = BISQUE;
     
     for (auto iter = islands.begin();
@@ -323,7 +349,7 @@ void drawIslands() {
 
 void drawGreens() {
     // get points and color
-    vector<unsigned> greens = getGreens();
+    const vector<unsigned>& greens = visibleFeatures[DRAW_GREENS];
     t_color color = GRASS;
     
     for (auto iter = greens.begin();
@@ -344,7 +370,7 @@ void drawGreens() {
 
 void drawSands() {
     // get points and color
-    vector<unsigned> sands = getSands();
+    const vector<unsigned>& sands = visibleFeatures[DRAW_SANDS];
     t_color color = SANDS;
     
     for (auto iter = sands.begin();
@@ -365,7 +391,7 @@ void drawSands() {
 
 void drawRivers() {
     // get points and color
-    vector<unsigned> rivers = getRivers();
+    const vector<unsigned>& rivers = visibleFeatures[DRAW_RIVERS];
     t_color color = LIGHTSKYBLUE;
     
     for (auto iter = rivers.begin();
@@ -390,7 +416,7 @@ void drawBuildings() {
     if (currentWidth > HOUSE) return; 
     
     // get points and color
-    vector<unsigned> buildings = getBuildings();
+    const vector<unsigned>& buildings = visibleFeatures[DRAW_BUILDINGS];
     t_color color = LIGHTGREY;
     
     for (auto iter = buildings.begin();
@@ -418,8 +444,9 @@ void drawPolygonFeatures(unsigned featureID, t_color color) {
     setcolor(color);
     
     // fill the t_point array
+    const LatLon* featurePoints = getFeaturePoints(featureID);
     for (unsigned pointCount = 0; pointCount < numOfPoints; pointCount++) {
-        t_point point = convertLatLonToWorld(getFeaturePoint(featureID, pointCount));
+        t_point point = convertLatLonToWorld(featurePoints[pointCount]);
         points[pointCount] = point;
     }
     
@@ -438,8 +465,9 @@ void drawLineFeatures(unsigned featureID, t_color color) {
     setcolor(color);
     
     // fill the t_point array
+    const LatLon* featurePoints = getFeaturePoints(featureID);
     for (unsigned pointCount = 0; pointCount < numOfPoints; pointCount++) {
-        t_point point = convertLatLonToWorld(getFeaturePoint(featureID, pointCount));
+        t_point point = convertLatLonToWorld(featurePoints[pointCount]);
         points[pointCount] = point;
     }
     
@@ -464,7 +492,7 @@ void drawLineFeatures(unsigned featureID, t_color color) {
 //          proportionate to surrounding buildings)
 
 void drawHighways() {
-    vector<unsigned> highways = getHighways();
+    const vector<unsigned>& highways = visibleSegments[DRAW_HIGHWAYS];
 
     t_color coreColor = HIGHWAY;
     int coreWidth = STREETWIDTH_CORE;
@@ -478,7 +506,7 @@ void drawHighways() {
 }
 
 void drawMotorways() {
-    vector<unsigned> motorways = getMotorways();
+    const vector<unsigned>& motorways = visibleSegments[DRAW_MOTORWAYS];
 
     t_color coreColor = MOTORWAY;
     int coreWidth = STREETWIDTH_CORE;
@@ -492,7 +520,7 @@ void drawMotorways() {
 }
 
 void drawServiceRoads() {
-    vector<unsigned> serviceRoads = getServiceRoads();
+    const vector<unsigned>& serviceRoads = visibleSegments[DRAW_SERVICE_ROADS];
     float currentWidth = getWidthOfCurrentWindow();
     t_color coreColor;
     int coreWidth;
@@ -516,7 +544,7 @@ void drawServiceRoads() {
 }
 
 void drawCommercialRoads() {
-    vector<unsigned> commercialRoads = getCommercialRoads();
+    const vector<unsigned>& commercialRoads = visibleSegments[DRAW_COMMERCIAL_ROADS];
     float currentWidth = getWidthOfCurrentWindow();
     t_color coreColor;
     int coreWidth;
@@ -541,7 +569,7 @@ void drawCommercialRoads() {
 }
 
 void drawLocalRoads() { // CHANGE THIS
-    vector<unsigned> localRoads = getLocalRoads();
+    const vector<unsigned>& localRoads = visibleSegments[DRAW_LOCAL_ROADS];
     float currentWidth = getWidthOfCurrentWindow();
     t_color coreColor;
     int coreWidth;
@@ -572,7 +600,7 @@ void drawLocalRoads() { // CHANGE THIS
 // 2) only draw names of streets if at appropriate zoom
 
 void drawHighwaysText() {
-    vector<unsigned> highways = getHighways();
+    const vector<unsigned>& highways = visibleSegments[DRAW_HIGHWAYS];
     int fontSize;
     
     float currentWidth = getWidthOfCurrentWindow();
@@ -590,7 +618,7 @@ void drawHighwaysText() {
 }
 
 void drawMotorwaysText() {
-    vector<unsigned> motorways = getMotorways();
+    const vector<unsigned>& motorways = visibleSegments[DRAW_MOTORWAYS];
     int fontSize;
     
     float currentWidth = getWidthOfCurrentWindow();
@@ -608,7 +636,7 @@ void drawMotorwaysText() {
 }
 
 void drawServiceRoadsText() {
-    vector<unsigned> serviceRoads = getServiceRoads();
+    const vector<unsigned>& serviceRoads = visibleSegments[DRAW_SERVICE_ROADS];
     int fontSize;
     
     float currentWidth = getWidthOfCurrentWindow();
@@ -628,7 +656,7 @@ void drawServiceRoadsText() {
 }
 
 void drawCommercialRoadsText() {
-    vector<unsigned> commercialRoads = getCommercialRoads();
+    const vector<unsigned>& commercialRoads = visibleSegments[DRAW_COMMERCIAL_ROADS];
     int fontSize;
     
     float currentWidth = getWidthOfCurrentWindow();
@@ -645,7 +673,7 @@ void drawCommercialRoadsText() {
 }
 
 void drawLocalRoadsText() {
-    vector<unsigned> localRoads = getLocalRoads();
+    const vector<unsigned>& localRoads = visibleSegments[DRAW_LOCAL_ROADS];
     int fontSize;
     
     float currentWidth = getWidthOfCurrentWindow();
@@ -677,7 +705,7 @@ void drawSegments(const vector<unsigned>& segments,
     float angle;
     
     
-    // for every segment
+    // for every segment on the screen
     for(unsigned i = 0; i < numOfSegments; i++) {
         unsigned segmentID = segments[i];
         
@@ -733,11 +761,12 @@ void drawSegments(const vector<unsigned>& segments,
                 // an arrow in the middle of the segment afterwards
             
             // Draw everything in between
+            const LatLon* segmentCurvePoints = getStreetSegmentCurvePoints(segmentID);
             for(unsigned curvePointIdx = 0;
                     curvePointIdx < (curvePoints-1);
                     curvePointIdx++) {
-                startLatLon = getStreetSegmentCurvePoint(segmentID, curvePointIdx);
-                endLatLon = getStreetSegmentCurvePoint(segmentID, curvePointIdx+1);
+                startLatLon = segmentCurvePoints[curvePointIdx];
+                endLatLon = segmentCurvePoints[curvePointIdx+1];
                 p1 = convertLatLonToWorld(startLatLon);
                 p2 = convertLatLonToWorld(endLatLon);
                 drawline(p1, p2);
@@ -775,13 +804,13 @@ void drawSegmentsText(const vector<unsigned>& segments,
     unsigned numOfSegments = segments.size();
     for(unsigned i = 0; i < numOfSegments; i++) {
         
-        // get numOfCurvePoints
+        // get numOfCurvePoints (of segments on the screen)
         unsigned segmentID = segments[i];
         StreetSegmentInfo segInfo = getStreetSegmentInfo(segmentID);
         unsigned numOfCurvePoints = segInfo.curvePointCount;
         
         // get streetName
-        string streetName = getStreetName(segInfo.streetID);
+        boost::string_view streetName = getStreetNameView(segInfo.streetID);
         if(streetName == "<unknown>"){
             continue;
         }
@@ -797,7 +826,7 @@ void drawSegmentsText(const vector<unsigned>& segments,
         
         // If there are no curve points
         if(numOfCurvePoints == 0) {
-            drawTextBetweenPoints(pointStart, pointEnd, streetName);
+            drawTextBetweenPoints(pointStart, pointEnd, streetName.to_string());
         }
         
         // If there are 1 or more curve points
@@ -849,7 +878,7 @@ void drawSegmentsText(const vector<unsigned>& segments,
             }
             
             // draw text on largest part
-            drawTextBetweenPoints(pointA, pointB, streetName);
+            drawTextBetweenPoints(pointA, pointB, streetName.to_string());
         }
     }
 }
@@ -866,15 +895,18 @@ void drawPOIs() {
     if(windowWidth > HOUSE)
         return;
     
-    unsigned numOfPOIs = getNumberOfPointsOfInterest();
+    // Only the POIs on the screen
+    LatLon corner1, corner2;
+    getVisibleCorners(corner1, corner2);
+    vector<unsigned> visiblePOIs = query_box_points_of_interest(corner1, corner2);
     
     // Diameter 2% of current window. Window width is in km, while world
     // coordinates are in m. Therefore, multiplying my 10 is the same thing
     // as converting km to m and then taking 1% of it for the radius.
     float symbolRadius = SYMBOL_SCALE * windowWidth; 
     
-    for(unsigned poiID = 0; poiID < numOfPOIs; poiID++) {
-        string name = getPointOfInterestName(poiID);
+    for(unsigned poiID : visiblePOIs) {
+        boost::string_view name = getPointOfInterestNameView(poiID);
         LatLon latlon = getPointOfInterestPosition(poiID);
         t_point screenPos = convertLatLonToWorld(latlon);
         string symbol;
@@ -1007,8 +1039,8 @@ void drawPOIs() {
 
 
 void drawPOI(float windowWidth, float symbolCutoff, float textCutoff,
-        t_color symbolColor, float symbolRadius, string poiType, 
-        string name, string symbol, int symbolSize, t_point pos) {
+        t_color symbolColor, float symbolRadius, const string& poiType, 
+        boost::string_view name, const string& symbol, int symbolSize, t_point pos) {
     // Draw the symbol
     if(windowWidth < symbolCutoff) {
         setcolor(WHITE);
@@ -1048,7 +1080,7 @@ void drawPOI(float windowWidth, float symbolCutoff, float textCutoff,
         settextattrs(10, 0);
         // 1.5% below the symbol (which has radius 1% of the current window)
         t_point textCenter(pos.x, pos.y-symbolRadius-10*windowWidth);
-        drawtext(textCenter, name, FLT_MAX, FLT_MAX);
+        drawtext(textCenter, name.to_string(), FLT_MAX, FLT_MAX);
     }
 }
 
@@ -1561,7 +1593,7 @@ void drawHighlightedPOIs() {
     
     for(unsigned i = 0; i < numOfPOIs; i++) {
         unsigned poiID = highlightedPOIs[i];
-        string name = getPointOfInterestName(poiID);
+        boost::string_view name = getPointOfInterestNameView(poiID);
         LatLon latlon = getPointOfInterestPosition(poiID);
         t_point screenPos = convertLatLonToWorld(latlon);
         string symbol;
@@ -1773,8 +1805,21 @@ void act_on_mouse_click(float x, float y, t_event_buttonPressed event) {
                     outputIntersection(intersectionID);
                     cout << endl << endl;
                 }
+                // else, find the street segment that user clicked on
                 else{
-                    updateNeeded = false;
+                    LatLon clickLatLon = convertWorldToLatLon(clickPoint);
+                    SegmentMatch clickedSegment =
+                            find_closest_street_segment(clickLatLon);
+                    if(clickedSegment.distance <= CLICK_THRESHOLD){
+                        unsigned segmentID = clickedSegment.streetSegmentID;
+                        highlightedSegments.push_back(segmentID);
+                        cout << "Street: "
+                             << getStreetNameView(getStreetSegmentInfo(segmentID).streetID)
+                             << endl << endl;
+                    }
+                    else{
+                        updateNeeded = false;
+                    }
                 }
             }
         }
@@ -2227,24 +2272,22 @@ char** command_completion(const char* stem_text, int start, int end) {
 
 char* name_generator(const char* stem_text, int state) {
     //Static here means a variable's value persists across function invocations
-    static int count;
+    static unsigned count;
+    static unsigned end;
 
     if(state == 0) { 
-        //We initialize the count the first time we are called
+        //The names are sorted, so the completions of stem_text are
+        //the contiguous range found the first time we are called
         //with this stem_text
-        count = -1;
+        pair<unsigned, unsigned> completions = findNamesWithPrefix(stem_text);
+        count = completions.first;
+        end = completions.second;
     }
 
-    int text_len = strlen(stem_text);
-    vector <const char*> allNames = getAllNames();
-    //Search through intersection_names until we find a match
-    while(count < (int) allNames.size()-1) {
-        count++;
-        if(strncmp(allNames[count], stem_text, text_len) == 0) {
-            //Must return a duplicate, Readline will handle
-            //freeing this string itself.
-            return strdup(allNames[count]);
-        }
+    if(count < end) {
+        //Must return a duplicate, Readline will handle
+        //freeing this string itself.
+        return strdup(getSortedNames()[count++].c_str());
     }
 
     //No more matches
@@ -2352,11 +2395,11 @@ t_point getPointFromIntersectionID(unsigned intersectionID) {
 }
 
 bool findStreets(string searchField) {
-    vector<unsigned> foundStreets = find_street_ids_from_name(searchField);
+    vector<unsigned> foundStreets = find_street_ids_from_name_range(searchField).toVector();
     
     string streetUpper = capitalizeWords(searchField);
     if(streetUpper != searchField) {
-        vector<unsigned> upperStreets = find_street_ids_from_name(streetUpper);
+        IdRange upperStreets = find_street_ids_from_name_range(streetUpper);
         foundStreets.insert(foundStreets.begin(),
                 upperStreets.begin(), upperStreets.end());
     }
@@ -2375,7 +2418,7 @@ bool findStreets(string searchField) {
         
         for(unsigned i = 0; i < foundStreets.size(); i++) {
             unsigned streetID = foundStreets[i];
-            vector<unsigned> segments = find_street_street_segments(streetID);
+            IdRange segments = find_street_street_segments_range(streetID);
             highlightedSegments.insert(highlightedSegments.end(),
                     segments.begin(), segments.end());
         }
@@ -2390,8 +2433,8 @@ bool findPOIs(string searchField, vector<unsigned> &POIs) {
     vector<unsigned> foundPOIs;
     
     // Search by category
-    string tag = tagForAlias(searchField);
-    if(tag != "<unknown>") {
+    POITag tag = poiTagForAlias(searchField);
+    if(tag != TAG_NONE) {
         unsigned numOfPOIs = getNumberOfPointsOfInterest();
         for(unsigned poiID = 0; poiID < numOfPOIs; poiID++) {
             if(doesContainTag(poiID, tag))
@@ -2465,6 +2508,74 @@ float getWidthOfCurrentWindow() {
     return kilometersOfView;
 }
 
+// Returns opposite corners of the visible world, widened by a tenth of its
+// width on each side so that symbols and names of items just off the
+// screen are still drawn
+void getVisibleCorners(LatLon &corner1, LatLon &corner2) {
+    t_bound_box currentView = get_visible_world();
+    float margin = currentView.get_width() / 10;
+    corner1 = convertWorldToLatLon(t_point(currentView.left() - margin,
+            currentView.bottom() - margin));
+    corner2 = convertWorldToLatLon(t_point(currentView.right() + margin,
+            currentView.top() + margin));
+}
+
+// Records the draw class of every street segment and feature of the map,
+// from the lists load_map sorted them into
+void buildDrawClasses() {
+    const vector<unsigned>* segmentLists[NUM_SEGMENT_CLASSES];
+    segmentLists[DRAW_LOCAL_ROADS] = &getLocalRoads();
+    segmentLists[DRAW_COMMERCIAL_ROADS] = &getCommercialRoads();
+    segmentLists[DRAW_SERVICE_ROADS] = &getServiceRoads();
+    segmentLists[DRAW_MOTORWAYS] = &getMotorways();
+    segmentLists[DRAW_HIGHWAYS] = &getHighways();
+    
+    segmentClasses.assign(getNumberOfStreetSegments(), NUM_SEGMENT_CLASSES);
+    for(unsigned segmentClass = 0; segmentClass < NUM_SEGMENT_CLASSES; segmentClass++) {
+        for(unsigned segmentID : *segmentLists[segmentClass])
+            segmentClasses[segmentID] = segmentClass;
+    }
+    
+    const vector<unsigned>* featureLists[NUM_FEATURE_CLASSES];
+    featureLists[DRAW_LAKES] = &getLakes();
+    featureLists[DRAW_PONDS] = &getPonds();
+    featureLists[DRAW_ISLANDS] = &getIslands();
+    featureLists[DRAW_GREENS] = &getGreens();
+    featureLists[DRAW_SANDS] = &getSands();
+    featureLists[DRAW_RIVERS] = &getRivers();
+    featureLists[DRAW_BUILDINGS] = &getBuildings();
+    
+    featureClasses.assign(getNumberOfFeatures(), NUM_FEATURE_CLASSES);
+    for(unsigned featureClass = 0; featureClass < NUM_FEATURE_CLASSES; featureClass++) {
+        for(unsigned featureID : *featureLists[featureClass])
+            featureClasses[featureID] = featureClass;
+    }
+}
+
+// Collects the street segments and features on the screen by class, using
+// the load_map R-trees instead of testing every one. The ids come back
+// ascending, so each class keeps the order of its full list.
+void updateVisibleItems() {
+    LatLon corner1, corner2;
+    getVisibleCorners(corner1, corner2);
+    
+    for(vector<unsigned>& segments : visibleSegments)
+        segments.clear();
+    for(unsigned segmentID : query_box_street_segments(corner1, corner2)) {
+        unsigned segmentClass = segmentClasses[segmentID];
+        if(segmentClass < NUM_SEGMENT_CLASSES)
+            visibleSegments[segmentClass].push_back(segmentID);
+    }
+    
+    for(vector<unsigned>& features : visibleFeatures)
+        features.clear();
+    for(unsigned featureID : query_box_features(corner1, corner2)) {
+        unsigned featureClass = featureClasses[featureID];
+        if(featureClass < NUM_FEATURE_CLASSES)
+            visibleFeatures[featureClass].push_back(featureID);
+    }
+}
+
 t_bound_box getWorldCoordinates() {
     unsigned numOfIntersections = getNumberOfIntersections();
     
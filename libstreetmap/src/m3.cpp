@@ -1,7 +1,11 @@
 #include "m3.h"
+#include "RoutingGraph.h"
+#include "SegmentTable.h"
 #include <queue>
 
-// Constant upper speed limit for heuristic function
+// Speed the heuristic function assumes at least (km/h). A* searches use the
+// weights snapshot's maximum speed limit instead if a road is faster, so that
+// the heuristic never overestimates.
 const float upperSpeedLimit = 120.0;    // km/h
 
 // Constant turn time penalty for path finding
@@ -12,11 +16,13 @@ struct pathNode {
     double distance;
     bool visited;
     unsigned previous;
+    unsigned previousStreet;
     
     pathNode(){
         distance = FLT_MAX; // Initialize with distance infinity from source
         visited = false;    // Has not yet been visited by algorithm
         previous = UINT_MAX;    // Initialize previous street segment id with undefined value
+        previousStreet = UINT_MAX;  // and the street it is on
     }
 };
 
@@ -29,8 +35,10 @@ struct QueueNode {
     }
 };
 
-// Vector of path nodes with size of total number of intersections
-vector<pathNode> pathNodes(getNumberOfIntersections());
+// Vector of path nodes with size of total number of intersections.
+// Resized for the current map by every search, and kept per thread so that
+// searches on different maps (or threads) don't share it.
+thread_local vector<pathNode> pathNodes;
 
 // Comparator function for the priority_queue
 struct compareIntersectionDistances {
@@ -43,9 +51,9 @@ struct compareIntersectionDistances {
 void resetPathNodes();
 vector<unsigned> constructPath(unsigned end);
 double getDistanceCost(unsigned currentNode, unsigned nextNode, 
-        unsigned segID, unsigned endNode, bool aStar);
-double heuristicDistanceCost(unsigned currentNode, unsigned nextNode, unsigned endNode);
-double turnPenalty(unsigned currentNode, unsigned segID);
+        unsigned arc, double arcTravelTime, unsigned endNode, bool aStar, double heuristicSpeed);
+double heuristicDistanceCost(unsigned currentNode, unsigned nextNode, unsigned endNode, double heuristicSpeed);
+double turnPenalty(unsigned currentNode, unsigned streetID);
 void printTravelTime(unsigned destination);
 void directions(const vector<unsigned>& path, unsigned startIntersection);
 void printStartDirection(unsigned startIntersection, unsigned streetSeg);
@@ -70,6 +78,12 @@ std::vector<unsigned> find_path_between_intersections(unsigned
     // Reset the path
     resetPathNodes();
     
+    // The whole search uses the weights current when it starts
+    const RoutingGraph::Arcs& arcs = RoutingGraph::getInstance().getForward();
+    shared_ptr<const RoutingGraph::Weights> weights = RoutingGraph::getInstance().getWeights();
+    const vector<double>& arcTravelTimes = weights->forwardTravelTime;
+    double heuristicSpeed = max(upperSpeedLimit, weights->maxSpeedLimit);
+    
     // Set the distance associated to the start to the ideal point-to-point
     // travel time from the start intersection to the end intersection
     LatLon startLatLon = getIntersectionPosition(intersect_id_start);
@@ -77,7 +91,7 @@ std::vector<unsigned> find_path_between_intersections(unsigned
     double startToEndDistance = 
         find_distance_between_two_points(startLatLon, endLatLon);
     double startToEndTravelTime = 
-        startToEndDistance / 1000.0 / upperSpeedLimit * 60.0;
+        startToEndDistance / 1000.0 / heuristicSpeed * 60.0;
     pathNodes[intersect_id_start].distance = startToEndTravelTime;
     
     // Initialize the priority queue for frontier unvisited intersections
@@ -101,26 +115,13 @@ std::vector<unsigned> find_path_between_intersections(unsigned
         if(currentNode == intersect_id_end)
             break;
         
-        // All the connected street segments to the current intersection
-        vector<unsigned> connected = find_intersection_street_segments(currentNode);
-        unsigned numOfConnected = connected.size();
-        
-        // For every outgoing intersection
-        for(unsigned i = 0; i < numOfConnected; i++) {
-            unsigned segID = connected[i];      // Segment id
-            
-            // Check if one way going towards the current intersection.
-            // If it is, skip it
-            StreetSegmentInfo segInfo = getStreetSegmentInfo(segID);
-            if(segInfo.oneWay && segInfo.to == currentNode)
-                continue;
-            
-            // Find the connected intersection id
-            unsigned nextNode;
-            if(segInfo.to == currentNode)
-                nextNode = segInfo.from;
-            else
-                nextNode = segInfo.to;
+        // For every outgoing intersection. The routing graph only holds the
+        // directions street segments can be driven in, so one way streets
+        // going towards the current intersection are already left out.
+        unsigned lastArc = arcs.end(currentNode);
+        for(unsigned arc = arcs.begin(currentNode); arc < lastArc; arc++) {
+            unsigned segID = arcs.segmentID[arc];       // Segment id
+            unsigned nextNode = arcs.target[arc];       // Connected intersection id
             
             // Avoid going in a back and forth loop between two intersections
             if(pathNodes[nextNode].visited && pathNodes[currentNode].previous == segID)
@@ -128,7 +129,7 @@ std::vector<unsigned> find_path_between_intersections(unsigned
             
             // Distance cost associated with nextNode along this path
             double distance = 
-                getDistanceCost(currentNode, nextNode, segID, intersect_id_end, true);
+                getDistanceCost(currentNode, nextNode, arc, arcTravelTimes[arc], intersect_id_end, true, heuristicSpeed);
             
             // If the distance cost is more than the nextNode's current
             // distance cost, skip it
@@ -140,6 +141,7 @@ std::vector<unsigned> find_path_between_intersections(unsigned
             
             // Update the previous street segment
             pathNodes[nextNode].previous = segID;
+            pathNodes[nextNode].previousStreet = arcs.streetID[arc];
             
             // Add the nextNode to the frontier.
             // Note: this algorithm uses a lazy delete. If the nextNode is
@@ -182,6 +184,9 @@ std::vector<unsigned> find_path_between_intersections(unsigned
 // segment, plus 15 seconds per turn implied by the path. A turn occurs
 // when two consecutive street segments have different street names.
 double compute_path_travel_time(const std::vector<unsigned>& path) {
+    const SegmentTable& segmentTable = SegmentTable::getInstance();
+    shared_ptr<const RoutingGraph::Weights> weights = RoutingGraph::getInstance().getWeights();
+    const vector<double>& travelTimes = weights->segmentTravelTime;
     double pathTravelTime = 0.0;
     
     unsigned pathSize = path.size();
@@ -192,9 +197,8 @@ double compute_path_travel_time(const std::vector<unsigned>& path) {
     // This computation is outside of the for-loop because the first
     // street segment does not have a turn penalty associated to it.
     if(pathSize) {
-        pathTravelTime += find_street_segment_travel_time(path[0]);
-        StreetSegmentInfo segInfo = getStreetSegmentInfo(path[0]);
-        previousStreetID = segInfo.streetID;
+        pathTravelTime += travelTimes[path[0]];
+        previousStreetID = segmentTable.getStreetID(path[0]);
     }
     
     // Compute the travel time associated to each street segment and
@@ -202,10 +206,9 @@ double compute_path_travel_time(const std::vector<unsigned>& path) {
     for(unsigned segIdx = 1; segIdx < pathSize; segIdx++) {
         unsigned segID = path[segIdx];
         
-        pathTravelTime += find_street_segment_travel_time(segID);
+        pathTravelTime += travelTimes[segID];
         
-        StreetSegmentInfo segInfo = getStreetSegmentInfo(segID);
-        unsigned streetID = segInfo.streetID;
+        unsigned streetID = segmentTable.getStreetID(segID);
         
         // If we changed streetIDs relative to the previous segment in the path,
         // add the turn penalty
@@ -263,6 +266,11 @@ std::vector<unsigned> find_path_to_point_of_interest (
     // Set the distance associated to the start to 0
     pathNodes[intersect_id_start].distance = 0.0;
     
+    // The whole search uses the weights current when it starts
+    const RoutingGraph::Arcs& arcs = RoutingGraph::getInstance().getForward();
+    shared_ptr<const RoutingGraph::Weights> weights = RoutingGraph::getInstance().getWeights();
+    const vector<double>& arcTravelTimes = weights->forwardTravelTime;
+    
     // Initialize the priority queue for frontier unvisited intersections
     priority_queue<QueueNode, vector<QueueNode>, compareIntersectionDistances> frontier;
     double queueNodeDistance = pathNodes[intersect_id_start].distance;
@@ -288,26 +296,13 @@ std::vector<unsigned> find_path_to_point_of_interest (
             break;
         }
         
-        // All the connected street segments to the current intersection
-        vector<unsigned> connected = find_intersection_street_segments(currentNode);
-        unsigned numOfConnected = connected.size();
-        
-        // For every outgoing intersection
-        for(unsigned i = 0; i < numOfConnected; i++) {
-            unsigned segID = connected[i];      // Segment id
-            
-            // Check if one way going towards the current intersection.
-            // If it is, skip it
-            StreetSegmentInfo segInfo = getStreetSegmentInfo(segID);
-            if(segInfo.oneWay && segInfo.to == currentNode)
-                continue;
-            
-            // Find the connected intersection id
-            unsigned nextNode;
-            if(segInfo.to == currentNode)
-                nextNode = segInfo.from;
-            else
-                nextNode = segInfo.to;
+        // For every outgoing intersection. The routing graph only holds the
+        // directions street segments can be driven in, so one way streets
+        // going towards the current intersection are already left out.
+        unsigned lastArc = arcs.end(currentNode);
+        for(unsigned arc = arcs.begin(currentNode); arc < lastArc; arc++) {
+            unsigned segID = arcs.segmentID[arc];       // Segment id
+            unsigned nextNode = arcs.target[arc];       // Connected intersection id
             
             // Avoid going in a back and forth loop between two intersections
             if(pathNodes[nextNode].visited && pathNodes[currentNode].previous == segID)
@@ -317,7 +312,7 @@ std::vector<unsigned> find_path_to_point_of_interest (
             // No need to pass in a destination intersection because
             // we are not using A*.
             double distance = 
-                getDistanceCost(currentNode, nextNode, segID, 0, false);
+                getDistanceCost(currentNode, nextNode, arc, arcTravelTimes[arc], 0, false, 0.0);
             
             // If the distance cost is more than the nextNode's current
             // distance cost, skip it
@@ -329,6 +324,7 @@ std::vector<unsigned> find_path_to_point_of_interest (
             
             // Update the previous street segment
             pathNodes[nextNode].previous = segID;
+            pathNodes[nextNode].previousStreet = arcs.streetID[arc];
             
             // Add the nextNode to the frontier.
             // Note: this algorithm uses a lazy delete. If the nextNode is
@@ -382,11 +378,11 @@ vector<unsigned> constructPath(unsigned end) {
         
         // Get the next intersection in the list, which is the intersection at
         // the other end of the street segment
-        StreetSegmentInfo segInfo = getStreetSegmentInfo(segID);
-        if(segInfo.to == currentNode)
-            currentNode = segInfo.from;
+        const SegmentTable& segmentTable = SegmentTable::getInstance();
+        if(segmentTable.getTo(segID) == currentNode)
+            currentNode = segmentTable.getFrom(segID);
         else
-            currentNode = segInfo.to;
+            currentNode = segmentTable.getTo(segID);
     }
     
     // Reverse the path
@@ -399,18 +395,20 @@ vector<unsigned> constructPath(unsigned end) {
 }
 
 double getDistanceCost(unsigned currentNode, unsigned nextNode, 
-    unsigned segID, unsigned endNode, bool aStar) {
+    unsigned arc, double arcTravelTime, unsigned endNode, bool aStar, double heuristicSpeed) {
+    const RoutingGraph::Arcs& arcs = RoutingGraph::getInstance().getForward();
+    
     // Travel time along the street segment from current to next intersection
-    double segDistance = find_street_segment_travel_time(segID);
+    double segDistance = arcTravelTime;
     
     // Ideal travel time from nextNode to the destination minus
     // ideal travel time from currentNode to the destination
     double heuristicDistance = 0.0;
     if(aStar)
-        heuristicDistance = heuristicDistanceCost(currentNode, nextNode, endNode);
+        heuristicDistance = heuristicDistanceCost(currentNode, nextNode, endNode, heuristicSpeed);
     
     // Turn penalty associated with going from currentNode to nextNode
-    double penalty = turnPenalty(currentNode, segID);
+    double penalty = turnPenalty(currentNode, arcs.streetID[arc]);
     
     // Travel time associated with going from the current node to the next node,
     // then ideally from the next node to the destination node, minus turn penalties
@@ -423,11 +421,12 @@ double getDistanceCost(unsigned currentNode, unsigned nextNode,
 // The heuristic function for the A* path finding algorithm.
 // The heuristic cost is essentially the travel time corresponding to going from
 // the next node all the way to the destination node if you were traveling on
-// an ideal straight highway. We also subtract the ideal travel time from the
+// an ideal straight highway at heuristicSpeed (km/h), which must be at least
+// the speed limit of every street segment. We also subtract the ideal travel time from the
 // current node to the destination node, so that when we add the heuristic cost
 // to the total distance cost, the resulting travel time corresponds to going
 // from the start node to the next node and then straight to the destination node.
-double heuristicDistanceCost(unsigned currentNode, unsigned nextNode, unsigned endNode) {
+double heuristicDistanceCost(unsigned currentNode, unsigned nextNode, unsigned endNode, double heuristicSpeed) {
     LatLon currentNodeLatLon = getIntersectionPosition(currentNode);
     LatLon nextNodeLatLon = getIntersectionPosition(nextNode);
     LatLon endNodeLatLon = getIntersectionPosition(endNode);
@@ -438,26 +437,21 @@ double heuristicDistanceCost(unsigned currentNode, unsigned nextNode, unsigned e
         find_distance_between_two_points(nextNodeLatLon, endNodeLatLon);
     
     double currentToEndTravelTime = 
-        distanceCurrentToEnd / 1000.0 / upperSpeedLimit * 60.0;
+        distanceCurrentToEnd / 1000.0 / heuristicSpeed * 60.0;
     double nextToEndTravelTime = 
-        distanceNextToEnd / 1000.0 / upperSpeedLimit * 60.0;
+        distanceNextToEnd / 1000.0 / heuristicSpeed * 60.0;
     
     return nextToEndTravelTime - currentToEndTravelTime;
 }
 
-// A time penalty associated to taking a turn (changing streetIDs)
-double turnPenalty(unsigned currentNode, unsigned segID) {
-    unsigned previousSegID = pathNodes[currentNode].previous;
-    
+// A time penalty associated to taking a turn (changing streetIDs) onto
+// a street segment of the street currentStreetID
+double turnPenalty(unsigned currentNode, unsigned currentStreetID) {
     // There was no previous street segment. We were at the start
-    if(previousSegID == UINT_MAX)
+    if(pathNodes[currentNode].previous == UINT_MAX)
         return 0.0;
     
-    StreetSegmentInfo previousSegInfo = getStreetSegmentInfo(previousSegID);
-    StreetSegmentInfo currentSegInfo = getStreetSegmentInfo(segID);
-    
-    unsigned previousStreetID = previousSegInfo.streetID;
-    unsigned currentStreetID = currentSegInfo.streetID;
+    unsigned previousStreetID = pathNodes[currentNode].previousStreet;
     
     // If the street is different, assume a turn was made and add
     // the turn penalty. Otherwise, no turn was made and add no penalty.
@@ -644,29 +638,28 @@ void printAmbiguousAction(string streetName, int turnNumber) {
 // Returns true if the user is staying on the same street (without u-turns),
 // or if there is only one option available
 bool noChangeInDirection(unsigned seg1, unsigned seg2) {
-    StreetSegmentInfo segInfo1 = getStreetSegmentInfo(seg1);
-    StreetSegmentInfo segInfo2 = getStreetSegmentInfo(seg2);
-    string streetName1 = getStreetName(segInfo1.streetID);
-    string streetName2 = getStreetName(segInfo2.streetID);
+    // Names are compared by their interned ids
+    const SegmentTable& segmentTable = SegmentTable::getInstance();
+    unsigned streetName1 = getStreetNameID(segmentTable.getStreetID(seg1));
+    unsigned streetName2 = getStreetNameID(segmentTable.getStreetID(seg2));
     
     // If there is no other option but to go from seg1 to seg2,
     // no change in directions
     unsigned sharedIntersection = sharedIntersectionBetweenSegments(seg1, seg2);
-    vector<unsigned> connected = find_intersection_street_segments(sharedIntersection);
+    IdRange connected = find_intersection_street_segments_range(sharedIntersection);
     unsigned numOfConnected = connected.size();
     if(numOfConnected == 2)
         return true;
     
     // If the streets are unknown, we cannot determine if there is a change in directions.
     // Assume that there is
-    if(streetName1 == "<unknown>" && streetName2 == "<unknown>")
+    if(streetName1 == streetName2 && getNameView(streetName1) == "<unknown>")
         return false;
     
     // If the street name is the same, and there was no u-turn, change in directions
     unsigned numOfSameStreets = 0;
     for(unsigned i = 0; i < numOfConnected; i++) {
-        StreetSegmentInfo segInfo = getStreetSegmentInfo(connected[i]);
-        string streetName = getStreetName(segInfo.streetID);
+        unsigned streetName = getStreetNameID(segmentTable.getStreetID(connected[i]));
         if(streetName == streetName1)
             numOfSameStreets++;
     }
@@ -797,7 +790,7 @@ int ambiguityForAction(unsigned seg1, unsigned seg2, double angle) {
     unsigned sharedIntersection = sharedIntersectionBetweenSegments(seg1, seg2);
     
     // All the connected street segments to the current intersection
-    vector<unsigned> connected = find_intersection_street_segments(sharedIntersection);
+    IdRange connected = find_intersection_street_segments_range(sharedIntersection);
     unsigned numOfConnected = connected.size();
     
     // Count of the number of street segments on the same turn side as
@@ -814,9 +807,9 @@ int ambiguityForAction(unsigned seg1, unsigned seg2, double angle) {
         
         // If the segment is a continuation of the previous one,
         // then skip it
-        StreetSegmentInfo segInfo1 = getStreetSegmentInfo(seg1);
-        StreetSegmentInfo newSegInfo = getStreetSegmentInfo(segID);
-        if(getStreetName(segInfo1.streetID) == getStreetName(newSegInfo.streetID))
+        const SegmentTable& segmentTable = SegmentTable::getInstance();
+        if(getStreetNameID(segmentTable.getStreetID(seg1)) ==
+                getStreetNameID(segmentTable.getStreetID(segID)))
             continue;
 
         // Check if one way going towards the current intersection.
@@ -866,7 +859,8 @@ unsigned sharedIntersectionBetweenSegments(unsigned seg1, unsigned seg2) {
 
 /* ---------------------------------------------------------------------------*/
 /* MULTI THREADING CODE -- VERY MESSY */
-vector<vector<pathNode>> threadedPathNodes(NUM_THREADS);
+// Per thread like pathNodes; each worker only fills in its own entry
+thread_local vector<vector<pathNode>> threadedPathNodes(NUM_THREADS);
 
 void resetPathNodesThread(unsigned i) {
     threadedPathNodes[i] = vector<pathNode>(getNumberOfIntersections());
@@ -879,18 +873,12 @@ struct threadedCompareIntersectionDistances {
     }
 };
 
-double threadTurnPenalty(unsigned currentNode, unsigned segID, unsigned thread) {
-    unsigned previousSegID = threadedPathNodes[thread][currentNode].previous;
-    
+double threadTurnPenalty(unsigned currentNode, unsigned currentStreetID, unsigned thread) {
     // There was no previous street segment. We were at the start
-    if(previousSegID == UINT_MAX)
+    if(threadedPathNodes[thread][currentNode].previous == UINT_MAX)
         return 0.0;
     
-    StreetSegmentInfo previousSegInfo = getStreetSegmentInfo(previousSegID);
-    StreetSegmentInfo currentSegInfo = getStreetSegmentInfo(segID);
-    
-    unsigned previousStreetID = previousSegInfo.streetID;
-    unsigned currentStreetID = currentSegInfo.streetID;
+    unsigned previousStreetID = threadedPathNodes[thread][currentNode].previousStreet;
     
     // If the street is different, assume a turn was made and add
     // the turn penalty. Otherwise, no turn was made and add no penalty.
@@ -901,12 +889,14 @@ double threadTurnPenalty(unsigned currentNode, unsigned segID, unsigned thread)
 }
 
 double threadGetDistanceCost(unsigned currentNode, unsigned nextNode, 
-    unsigned segID, unsigned thread) {
+    unsigned arc, double arcTravelTime, unsigned thread) {
+    const RoutingGraph::Arcs& arcs = RoutingGraph::getInstance().getForward();
+    
     // Travel time along the street segment from current to next intersection
-    double segDistance = find_street_segment_travel_time(segID);
+    double segDistance = arcTravelTime;
     
     // Turn penalty associated with going from currentNode to nextNode
-    double penalty = threadTurnPenalty(currentNode, segID, thread);
+    double penalty = threadTurnPenalty(currentNode, arcs.streetID[arc], thread);
     
     // Travel time associated with going from the current node to the next node,
     // then ideally from the next node to the destination node, minus turn penalties
@@ -925,6 +915,11 @@ double threadGetDistanceCost(unsigned currentNode, unsigned nextNode,
 void courierDijkstra(const vector<unsigned>& range, const vector<IntersectionContent>& intersectionContents,
         costMap& distanceCostMap, closestMap& closestDeliveryMap, closestMap& closestDepotMap,
         unsigned thread, unsigned thingsToFind) { 
+    // Every search uses the weights current when this starts
+    const RoutingGraph::Arcs& arcs = RoutingGraph::getInstance().getForward();
+    shared_ptr<const RoutingGraph::Weights> weights = RoutingGraph::getInstance().getWeights();
+    const vector<double>& arcTravelTimes = weights->forwardTravelTime;
+    
     // Apply dijkstra to every delivery in the set
     unsigned rangeSize = range.size();
     for(unsigned i = 0; i < rangeSize; i++) {
@@ -977,26 +972,11 @@ void courierDijkstra(const vector<unsigned>& range, const vector<IntersectionCon
                 }
             }
 
-            // All the connected street segments to the current intersection
-            vector<unsigned> connected = find_intersection_street_segments(currentNode);
-            unsigned numOfConnected = connected.size();
-
-            // For every outgoing intersection
-            for(unsigned i = 0; i < numOfConnected; i++) {
-                unsigned segID = connected[i];      // Segment id
-
-                // Check if one way going towards the current intersection.
-                // If it is, skip it
-                StreetSegmentInfo segInfo = getStreetSegmentInfo(segID);
-                if(segInfo.oneWay && segInfo.to == currentNode)
-                    continue;
-
-                // Find the connected intersection id
-                unsigned nextNode;
-                if(segInfo.to == currentNode)
-                    nextNode = segInfo.from;
-                else
-                    nextNode = segInfo.to;
+            // For every outgoing intersection (see find_path_between_intersections)
+            unsigned lastArc = arcs.end(currentNode);
+            for(unsigned arc = arcs.begin(currentNode); arc < lastArc; arc++) {
+                unsigned segID = arcs.segmentID[arc];       // Segment id
+                unsigned nextNode = arcs.target[arc];       // Connected intersection id
 
                 // Do not revisit nodes
                 if(threadedPathNodes[thread][nextNode].visited)
@@ -1004,7 +984,7 @@ void courierDijkstra(const vector<unsigned>& range, const vector<IntersectionCon
 
                 // Distance cost associated with nextNode along this path
                 double distance = 
-                    threadGetDistanceCost(currentNode, nextNode, segID, thread);
+                    threadGetDistanceCost(currentNode, nextNode, arc, arcTravelTimes[arc], thread);
 
                 // If the distance cost is more than the nextNode's current
                 // distance cost, skip it
@@ -1016,6 +996,7 @@ void courierDijkstra(const vector<unsigned>& range, const vector<IntersectionCon
 
                 // Update the previous street segment
                 threadedPathNodes[thread][nextNode].previous = segID;
+                threadedPathNodes[thread][nextNode].previousStreet = arcs.streetID[arc];
 
                 // Add the nextNode to the frontier.
                 // Note: this algorithm uses a lazy delete. If the nextNode is
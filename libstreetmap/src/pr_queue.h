@@ -59,6 +59,7 @@ class ANNpr_queue {
 	};
 	int			n;						// number of items in queue
 	int			max_size;				// maximum queue size
+	int			capacity;				// max size without reallocating
 	pq_node		*pq;					// the priority queue (array of nodes)
 
 public:
@@ -66,9 +67,21 @@ public:
 		{
 			n = 0;						// initially empty
 			max_size = max;				// maximum number of items
+			capacity = max;
 			pq = new pq_node[max+1];	// queue is array [1..max] of nodes
 		}
 
+	void reset(int max)					// make empty, with a new max size
+		{
+			if (max > capacity) {		// reallocate only to grow
+				delete [] pq;
+				pq = new pq_node[max+1];
+				capacity = max;
+			}
+			n = 0;
+			max_size = max;
+		}
+
 	~ANNpr_queue()						// destructor
 		{ delete [] pq; }
 
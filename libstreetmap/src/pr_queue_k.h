@@ -71,6 +71,7 @@ class ANNmin_k {
 
 	int			k;						// max number of keys to store
 	int			n;						// number of keys currently active
+	int			capacity;				// max k without reallocating
 	mk_node		*mk;					// the list itself
 
 public:
@@ -78,11 +79,23 @@ public:
 		{
 			n = 0;						// initially no items
 			k = max;					// maximum number of items
+			capacity = max;
 			mk = new mk_node[max+1];	// sorted array of keys
 		}
 
 	~ANNmin_k()							// destructor
 		{ delete [] mk; }
+
+	void reset(int max)					// empty, with a new max size
+		{
+			if (max > capacity) {		// reallocate only to grow
+				delete [] mk;
+				mk = new mk_node[max+1];
+				capacity = max;
+			}
+			n = 0;
+			k = max;
+		}
 	
 	PQKkey ANNmin_key()					// return minimum key
 		{ return (n > 0 ? mk[0].key : PQ_NULL_KEY); }
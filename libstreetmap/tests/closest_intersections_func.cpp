@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <random>
+#include <limits>
+#include <unittest++/UnitTest++.h>
+
+#include "StreetsDatabaseAPI.h"
+#include "m1.h"
+
+#include "unit_test_util.h"
+
+using ece297test::relative_error;
+using ece297test::random_positions;
+
+SUITE(closest_intersections) {
+    TEST(batch_matches_single_queries) {
+        std::mt19937 rng(18);
+        std::vector<LatLon> positions = random_positions(rng, 20000);
+
+        std::vector<unsigned> intersectionIDs;
+        std::vector<double> distances;
+        find_closest_intersections(positions, intersectionIDs, distances);
+
+        CHECK_EQUAL(positions.size(), intersectionIDs.size());
+        CHECK_EQUAL(positions.size(), distances.size());
+        for(unsigned i = 0; i < positions.size(); i++) {
+            CHECK_EQUAL(find_closest_intersection(positions[i]), intersectionIDs[i]);
+
+            double distance = find_distance_between_two_points(positions[i],
+                    getIntersectionPosition(intersectionIDs[i]));
+            CHECK(relative_error(distance, distances[i]) < 1e-9);
+        }
+    } //batch_matches_single_queries
+
+    TEST(closest_intersection_matches_linear_scan) {
+        std::mt19937 rng(19);
+        std::vector<LatLon> positions = random_positions(rng, 200);
+
+        std::vector<unsigned> intersectionIDs;
+        std::vector<double> distances;
+        find_closest_intersections(positions, intersectionIDs, distances);
+
+        for(unsigned i = 0; i < positions.size(); i++) {
+            double closest = std::numeric_limits<double>::infinity();
+            for(unsigned intersectionID = 0; intersectionID < getNumberOfIntersections(); intersectionID++) {
+                closest = std::min(closest, find_distance_between_two_points(positions[i],
+                        getIntersectionPosition(intersectionID)));
+            }
+
+            // Another intersection may be just as close
+            CHECK(relative_error(closest, distances[i]) < 1e-9);
+        }
+    } //closest_intersection_matches_linear_scan
+
+    TEST(batch_of_none) {
+        std::vector<unsigned> intersectionIDs(3);
+        std::vector<double> distances(3);
+        find_closest_intersections(std::vector<LatLon>(), intersectionIDs, distances);
+
+        CHECK(intersectionIDs.empty());
+        CHECK(distances.empty());
+    } //batch_of_none
+
+} //closest_intersections
@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <limits>
+#include <unittest++/UnitTest++.h>
+
+#include "StreetsDatabaseAPI.h"
+#include "m1.h"
+#include "MapContext.h"
+
+#include "unit_test_util.h"
+
+using ece297test::relative_error;
+using ece297test::absolute_error;
+using ece297test::random_positions;
+
+namespace {
+
+// A point on the equirectangular projection (meters) find_closest_street_segment
+// measures in, with longitudes scaled at the map's average latitude
+struct Planar {
+    double x, y;
+};
+
+Planar project(LatLon position) {
+    double xScale = std::max(cos(MapContext::current().getAverageLatRad()), 0.0);
+    return {position.lon * DEG_TO_RAD * xScale * EARTH_RADIUS_IN_METERS,
+            position.lat * DEG_TO_RAD * EARTH_RADIUS_IN_METERS};
+}
+
+// The nearest point to position on a segment, found by projecting onto every
+// piece (the straight lines between its ends and curve points)
+struct Projection {
+    double distance;    // meters, on the plane
+    double offset;      // meters along the segment, as find_street_segment_length measures
+};
+
+Projection projectOntoSegment(unsigned segmentID, LatLon position) {
+    StreetSegmentInfo info = getStreetSegmentInfo(segmentID);
+    const LatLon* curvePoints = getStreetSegmentCurvePoints(segmentID);
+    std::vector<LatLon> points(1, getIntersectionPosition(info.from));
+    points.insert(points.end(), curvePoints, curvePoints + info.curvePointCount);
+    points.push_back(getIntersectionPosition(info.to));
+
+    Planar point = project(position);
+    Projection closest = {std::numeric_limits<double>::infinity(), 0};
+    double offset = 0;
+    for(unsigned i = 0; i + 1 < points.size(); i++) {
+        Planar start = project(points[i]), end = project(points[i + 1]);
+        double dx = end.x - start.x, dy = end.y - start.y;
+        double sqLength = dx * dx + dy * dy;
+        double t = 0;
+        if(sqLength > 0)
+            t = std::min(std::max(((point.x - start.x) * dx + (point.y - start.y) * dy) / sqLength, 0.0), 1.0);
+
+        double distance = hypot(point.x - start.x - t * dx, point.y - start.y - t * dy);
+        double pieceLength = find_distance_between_two_points(points[i], points[i + 1]);
+        if(distance < closest.distance)
+            closest = {distance, offset + t * pieceLength};
+        offset += pieceLength;
+    }
+    return closest;
+}
+
+// The position a match returns is stored as floats, which round it by up to
+// a few tenths of a meter
+const double positionTolerance = 1.0;
+}
+
+SUITE(closest_segment) {
+    TEST(closest_segment_matches_projection_onto_every_piece) {
+        std::mt19937 rng(24);
+
+        for(LatLon position : random_positions(rng, 100)) {
+            double closest = std::numeric_limits<double>::infinity();
+            for(unsigned segmentID = 0; segmentID < getNumberOfStreetSegments(); segmentID++)
+                closest = std::min(closest, projectOntoSegment(segmentID, position).distance);
+
+            // Another segment may be just as close
+            SegmentMatch match = find_closest_street_segment(position);
+            Projection expected = projectOntoSegment(match.streetSegmentID, position);
+            CHECK(relative_error(closest, expected.distance) < 1e-9);
+
+            Planar point = project(position), matched = project(match.position);
+            double matchedDistance = hypot(point.x - matched.x, point.y - matched.y);
+            CHECK(absolute_error(closest, matchedDistance) < positionTolerance);
+            CHECK(absolute_error(expected.offset, match.offset) < positionTolerance);
+            CHECK_EQUAL(find_distance_between_two_points(position, match.position), match.distance);
+        }
+    } //closest_segment_matches_projection_onto_every_piece
+
+    TEST(points_on_segments_match_themselves) {
+        std::mt19937 rng(25);
+        unsigned numberOfStreetSegments = getNumberOfStreetSegments();
+
+        for(unsigned i = 0; i < 1000; i++) {
+            unsigned segmentID = rng() % numberOfStreetSegments;
+            StreetSegmentInfo info = getStreetSegmentInfo(segmentID);
+            LatLon from = getIntersectionPosition(info.from);
+
+            // A segment's start is on it, and on any other segment from the
+            // same intersection
+            SegmentMatch match = find_closest_street_segment(from);
+            CHECK(match.distance < positionTolerance);
+            CHECK(projectOntoSegment(match.streetSegmentID, from).distance < positionTolerance);
+            CHECK(match.offset <= find_street_segment_length(match.streetSegmentID) + positionTolerance);
+        }
+    } //points_on_segments_match_themselves
+
+} //closest_segment
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <unittest++/UnitTest++.h>
+
+#include "StreetsDatabaseAPI.h"
+#include "m1.h"
+
+#include "unit_test_util.h"
+
+namespace {
+
+typedef std::vector<std::string> Words;
+
+// Whether first appears as consecutive words of second, as the searches
+// compared names before the word index
+bool firstWithinSecond(const Words& first, const Words& second) {
+    if(first.size() > second.size())
+        return false;
+    for(unsigned i = 0; i + first.size() <= second.size(); i++) {
+        if(std::equal(first.begin(), first.end(), second.begin() + i))
+            return true;
+    }
+    return false;
+}
+
+// The words of each street's or POI's name
+std::vector<Words> streetNameWords() {
+    std::vector<Words> names;
+    for(unsigned streetID = 0; streetID < getNumberOfStreets(); streetID++)
+        names.push_back(separateString(getStreetName(streetID)));
+    return names;
+}
+
+std::vector<Words> poiNameWords() {
+    std::vector<Words> names;
+    for(unsigned poiID = 0; poiID < getNumberOfPointsOfInterest(); poiID++)
+        names.push_back(separateString(getPointOfInterestName(poiID)));
+    return names;
+}
+
+// The items whose names contain the words of searchField or of its
+// capitalized version, checking every name
+std::vector<unsigned> linearSearch(const std::vector<Words>& names, const std::string& searchField) {
+    Words searchWords = separateString(searchField);
+    Words upperSearchWords = separateString(capitalizeWords(searchField));
+
+    std::vector<unsigned> items;
+    for(unsigned item = 0; item < names.size(); item++) {
+        if(firstWithinSecond(searchWords, names[item]) || firstWithinSecond(upperSearchWords, names[item]))
+            items.push_back(item);
+    }
+    return items;
+}
+
+std::string join(Words::const_iterator first, Words::const_iterator last) {
+    std::string joined;
+    for(Words::const_iterator word = first; word != last; word++)
+        joined += (joined.empty() ? "" : " ") + *word;
+    return joined;
+}
+
+// Queries made from the words of count random names: runs of up to three
+// consecutive words, the same with the first letters lowered (so that
+// only the capitalized query can match), and two words that aren't
+// consecutive in the name
+std::vector<std::string> queriesFrom(const std::vector<Words>& names, std::mt19937& rng, unsigned count) {
+    std::vector<std::string> queries;
+    for(unsigned i = 0; i < count && !names.empty(); i++) {
+        const Words& name = names[rng() % names.size()];
+        for(unsigned first = 0; first < name.size(); first++) {
+            for(unsigned length = 1; length <= 3 && first + length <= name.size(); length++) {
+                std::string query = join(name.begin() + first, name.begin() + first + length);
+                queries.push_back(query);
+
+                std::string lowered = query;
+                for(unsigned c = 0; c < lowered.size(); c++) {
+                    if(c == 0 || lowered[c - 1] == ' ')
+                        lowered[c] = tolower(lowered[c]);
+                }
+                queries.push_back(lowered);
+            }
+        }
+        if(name.size() >= 3)
+            queries.push_back(name[0] + " " + name[2]);
+    }
+    return queries;
+}
+
+// Queries where a word repeats: the runs of every name with a repeated word
+// that start or end at a repeat, and each word of count random names twice
+std::vector<std::string> repeatedWordQueries(const std::vector<Words>& names, std::mt19937& rng, unsigned count) {
+    std::vector<std::string> queries;
+    for(const Words& name : names) {
+        for(unsigned first = 0; first < name.size(); first++) {
+            for(unsigned repeat = first + 1; repeat < name.size(); repeat++) {
+                if(name[repeat] != name[first])
+                    continue;
+                queries.push_back(join(name.begin() + first, name.begin() + repeat + 1));
+                queries.push_back(join(name.begin() + repeat, name.end()));
+                queries.push_back(join(name.begin(), name.begin() + repeat + 1));
+            }
+        }
+    }
+    for(unsigned i = 0; i < count && !names.empty(); i++) {
+        for(const std::string& word : names[rng() % names.size()])
+            queries.push_back(word + " " + word);
+    }
+    return queries;
+}
+}
+
+SUITE(name_search) {
+    TEST(street_multi_word_and_capitalized_queries) {
+        std::mt19937 rng(20);
+        std::vector<Words> names = streetNameWords();
+
+        for(const std::string& query : queriesFrom(names, rng, 100))
+            CHECK(linearSearch(names, query) == searchStreetByPartOfName(query));
+    } //street_multi_word_and_capitalized_queries
+
+    TEST(poi_multi_word_and_capitalized_queries) {
+        std::mt19937 rng(21);
+        std::vector<Words> names = poiNameWords();
+
+        for(const std::string& query : queriesFrom(names, rng, 100))
+            CHECK(linearSearch(names, query) == searchPOIByPartOfName(query));
+    } //poi_multi_word_and_capitalized_queries
+
+    TEST(repeated_words) {
+        std::mt19937 rng(22);
+        std::vector<Words> streets = streetNameWords();
+        std::vector<Words> pois = poiNameWords();
+
+        for(const std::string& query : repeatedWordQueries(streets, rng, 50))
+            CHECK(linearSearch(streets, query) == searchStreetByPartOfName(query));
+        for(const std::string& query : repeatedWordQueries(pois, rng, 50))
+            CHECK(linearSearch(pois, query) == searchPOIByPartOfName(query));
+    } //repeated_words
+
+    TEST(odd_queries) {
+        std::vector<Words> streets = streetNameWords();
+        std::vector<Words> pois = poiNameWords();
+        const char* queries[] = {"", " ", "  street", "street  ", "no such name",
+                "no such name at all but very long"};
+
+        for(const char* query : queries) {
+            CHECK(linearSearch(streets, query) == searchStreetByPartOfName(query));
+            CHECK(linearSearch(pois, query) == searchPOIByPartOfName(query));
+        }
+    } //odd_queries
+
+} //name_search
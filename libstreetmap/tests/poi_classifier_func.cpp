@@ -0,0 +1,80 @@
+#include <string>
+#include <unittest++/UnitTest++.h>
+
+#include "m1.h"
+#include "POIClassifier.h"
+
+#include "unit_test_util.h"
+
+SUITE(poi_classifier) {
+    TEST(tables_are_strictly_ascending) {
+        CHECK(poiTypeRulesSorted());
+        CHECK(poiAliasesSorted());
+    } //tables_are_strictly_ascending
+
+    TEST(types_classify) {
+        POITagSet tags;
+
+        CHECK_EQUAL(POI_FOOD, classifyPOIType("cafe", tags));
+        CHECK(tags[POI_FOOD] && tags[TAG_CAFE]);
+        CHECK_EQUAL(2u, tags.count());
+
+        CHECK_EQUAL(POI_FOOD, classifyPOIType("internet_cafe", tags));
+        CHECK(tags[POI_FOOD] && tags[TAG_CAFE] && tags[TAG_INTERNET_CAFE]);
+        CHECK_EQUAL(3u, tags.count());
+
+        CHECK_EQUAL(POI_FOOD, classifyPOIType("food", tags));
+        CHECK(tags[POI_FOOD]);
+        CHECK_EQUAL(1u, tags.count());
+
+        // The first and last entries
+        CHECK_EQUAL(POI_FOOD, classifyPOIType("Coffee Shop", tags));
+        CHECK(tags[TAG_CAFE]);
+        CHECK_EQUAL(POI_RELIGIOUS, classifyPOIType("wedding_chapel", tags));
+        CHECK(tags[TAG_CHURCH] && tags[TAG_WEDDING_CHAPEL]);
+
+        // Types are matched exactly
+        CHECK_EQUAL(POI_UNKNOWN, classifyPOIType("Cafe", tags));
+        CHECK(tags.none());
+        CHECK_EQUAL(POI_UNKNOWN, classifyPOIType("no_such_type", tags));
+        CHECK(tags.none());
+        CHECK_EQUAL(POI_UNKNOWN, classifyPOIType("", tags));
+        CHECK(tags.none());
+    } //types_classify
+
+    TEST(aliases_resolve) {
+        CHECK_EQUAL(TAG_ATM, poiTagForAlias("ATM"));
+        CHECK_EQUAL(TAG_ATM, poiTagForAlias("ATMS"));
+        CHECK_EQUAL(TAG_WEDDING_CHAPEL, poiTagForAlias("wedding halls"));
+        CHECK_EQUAL(TAG_TEMPLE, poiTagForAlias("worship"));
+        CHECK_EQUAL(TAG_FAST_FOOD, poiTagForAlias("Fast Food"));
+        CHECK_EQUAL(TAG_FAST_FOOD, poiTagForAlias("fast food"));
+
+        CHECK_EQUAL(TAG_NONE, poiTagForAlias("no such alias"));
+        CHECK_EQUAL(TAG_NONE, poiTagForAlias(""));
+    } //aliases_resolve
+
+    TEST(tag_names_round_trip) {
+        for(unsigned tag = TAG_NONE + 1; tag < POI_TAG_COUNT; tag++)
+            CHECK_EQUAL(tag, (unsigned) poiTagFromName(poiTagName(tag)));
+
+        CHECK_EQUAL(std::string("<unknown>"), poiTagName(TAG_NONE));
+        CHECK_EQUAL(std::string("<unknown>"), poiTagName(POI_TAG_COUNT));
+        CHECK_EQUAL(TAG_NONE, poiTagFromName("no such tag"));
+    } //tag_names_round_trip
+
+    TEST(food_courts_are_found_by_their_alias) {
+        // The food_court type's tag is named as its alias resolves, so a
+        // search for food courts finds them
+        POITagSet tags;
+        CHECK_EQUAL(POI_FOOD, classifyPOIType("food_court", tags));
+        CHECK(tags[TAG_FOOD_COURT]);
+
+        CHECK_EQUAL(TAG_FOOD_COURT, poiTagForAlias("food court"));
+        CHECK_EQUAL(TAG_FOOD_COURT, poiTagForAlias("Food Court"));
+        CHECK_EQUAL(std::string("food court"), poiTagName(TAG_FOOD_COURT));
+        CHECK_EQUAL(std::string("food court"), tagForAlias("Food Court"));
+        CHECK_EQUAL(TAG_FOOD_COURT, poiTagFromName(tagForAlias("food court")));
+    } //food_courts_are_found_by_their_alias
+
+} //poi_classifier
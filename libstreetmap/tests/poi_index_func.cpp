@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <unittest++/UnitTest++.h>
+
+#include "StreetsDatabaseAPI.h"
+#include "m1.h"
+
+#include "unit_test_util.h"
+
+using ece297test::random_positions;
+
+namespace {
+
+// Every POI (of type, if it isn't empty) by distance from position, then id,
+// as measuring the distance to each
+std::vector<std::pair<double, unsigned> > poisByDistance(LatLon position,
+        const std::string& type = "") {
+    std::vector<std::pair<double, unsigned> > pois;
+    for(unsigned poiID = 0; poiID < getNumberOfPointsOfInterest(); poiID++) {
+        if(type.empty() || getPointOfInterestType(poiID) == type)
+            pois.push_back(std::make_pair(find_distance_between_two_points(position,
+                    getPointOfInterestPosition(poiID)), poiID));
+    }
+    std::sort(pois.begin(), pois.end());
+    return pois;
+}
+
+std::vector<unsigned> nearest(LatLon position, unsigned k, const std::string& type = "") {
+    std::vector<unsigned> poiIDs;
+    for(const std::pair<double, unsigned>& poi : poisByDistance(position, type)) {
+        if(poiIDs.size() == k)
+            break;
+        poiIDs.push_back(poi.second);
+    }
+    return poiIDs;
+}
+
+std::vector<unsigned> within(LatLon position, double radius, const std::string& type = "") {
+    std::vector<unsigned> poiIDs;
+    for(const std::pair<double, unsigned>& poi : poisByDistance(position, type)) {
+        if(poi.first > radius)
+            break;
+        poiIDs.push_back(poi.second);
+    }
+    return poiIDs;
+}
+
+// The types of a few random POIs, and one no POI has
+std::vector<std::string> someTypes(std::mt19937& rng) {
+    std::vector<std::string> types(1, "no such type");
+    for(unsigned i = 0; i < 5 && getNumberOfPointsOfInterest() > 0; i++)
+        types.push_back(getPointOfInterestType(rng() % getNumberOfPointsOfInterest()));
+    return types;
+}
+}
+
+SUITE(poi_index) {
+    TEST(closest_matches_linear_scan) {
+        std::mt19937 rng(16);
+
+        for(LatLon position : random_positions(rng, 200)) {
+            std::vector<unsigned> expected = nearest(position, 1);
+            if(!expected.empty())
+                CHECK_EQUAL(expected[0], find_closest_point_of_interest(position));
+        }
+    } //closest_matches_linear_scan
+
+    TEST(k_nearest_match_linear_scan) {
+        std::mt19937 rng(17);
+        unsigned ks[] = {0, 1, 2, 10, 100, getNumberOfPointsOfInterest() + 1};
+
+        for(LatLon position : random_positions(rng, 50)) {
+            for(unsigned k : ks)
+                CHECK(nearest(position, k) == find_closest_points_of_interest(position, k));
+        }
+    } //k_nearest_match_linear_scan
+
+    TEST(k_nearest_of_type_match_linear_scan) {
+        std::mt19937 rng(18);
+        std::vector<std::string> types = someTypes(rng);
+
+        for(LatLon position : random_positions(rng, 50)) {
+            for(const std::string& type : types) {
+                for(unsigned k : {1u, 5u, 50u})
+                    CHECK(nearest(position, k, type) == find_closest_points_of_interest(position, k, type));
+            }
+        }
+    } //k_nearest_of_type_match_linear_scan
+
+    TEST(within_radius_matches_linear_scan) {
+        std::mt19937 rng(19);
+        std::vector<std::string> types = someTypes(rng);
+
+        for(LatLon position : random_positions(rng, 50)) {
+            for(double radius : {0.0, 100.0, 1000.0, 5000.0}) {
+                CHECK(within(position, radius) == find_points_of_interest_within(position, radius));
+                for(const std::string& type : types)
+                    CHECK(within(position, radius, type) == find_points_of_interest_within(position, radius, type));
+            }
+        }
+    } //within_radius_matches_linear_scan
+
+    TEST(at_a_poi) {
+        std::mt19937 rng(20);
+        unsigned numberOfPOIs = getNumberOfPointsOfInterest();
+
+        for(unsigned i = 0; i < 100 && numberOfPOIs > 0; i++) {
+            unsigned poiID = rng() % numberOfPOIs;
+            LatLon position = getPointOfInterestPosition(poiID);
+
+            // It, or another POI at the same place with a lower id
+            unsigned closest = find_closest_point_of_interest(position);
+            CHECK(closest <= poiID);
+            CHECK_EQUAL(0.0, find_distance_between_two_points(position, getPointOfInterestPosition(closest)));
+
+            std::vector<unsigned> here = find_points_of_interest_within(position, 0.0,
+                    getPointOfInterestType(poiID));
+            CHECK(std::find(here.begin(), here.end(), poiID) != here.end());
+        }
+    } //at_a_poi
+
+} //poi_index
@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <random>
+#include <unittest++/UnitTest++.h>
+
+#include "StreetsDatabaseAPI.h"
+#include "m1.h"
+
+#include "unit_test_util.h"
+
+using ece297test::random_positions;
+
+namespace {
+
+// A bounding box in degrees, as the box index keeps them
+struct Bounds {
+    double minLat, maxLat, minLon, maxLon;
+};
+
+Bounds boundsOf(const std::vector<LatLon>& points) {
+    Bounds bounds = {points[0].lat, points[0].lat, points[0].lon, points[0].lon};
+    for(LatLon point : points) {
+        bounds.minLat = std::min(bounds.minLat, (double) point.lat);
+        bounds.maxLat = std::max(bounds.maxLat, (double) point.lat);
+        bounds.minLon = std::min(bounds.minLon, (double) point.lon);
+        bounds.maxLon = std::max(bounds.maxLon, (double) point.lon);
+    }
+    return bounds;
+}
+
+bool touches(const Bounds& bounds, const Bounds& box) {
+    return bounds.minLat <= box.maxLat && box.minLat <= bounds.maxLat
+            && bounds.minLon <= box.maxLon && box.minLon <= bounds.maxLon;
+}
+
+// The ids of the intersections, street segments, features and points of
+// interest whose bounding boxes touch the box, found by testing every one
+BoxContents linearScan(LatLon corner1, LatLon corner2) {
+    Bounds box = boundsOf({corner1, corner2});
+    BoxContents contents;
+
+    for(unsigned intersectionID = 0; intersectionID < getNumberOfIntersections(); intersectionID++) {
+        if(touches(boundsOf({getIntersectionPosition(intersectionID)}), box))
+            contents.intersections.push_back(intersectionID);
+    }
+
+    for(unsigned segmentID = 0; segmentID < getNumberOfStreetSegments(); segmentID++) {
+        StreetSegmentInfo info = getStreetSegmentInfo(segmentID);
+        const LatLon* curvePoints = getStreetSegmentCurvePoints(segmentID);
+        std::vector<LatLon> points(curvePoints, curvePoints + info.curvePointCount);
+        points.push_back(getIntersectionPosition(info.from));
+        points.push_back(getIntersectionPosition(info.to));
+        if(touches(boundsOf(points), box))
+            contents.streetSegments.push_back(segmentID);
+    }
+
+    for(unsigned featureID = 0; featureID < getNumberOfFeatures(); featureID++) {
+        const LatLon* featurePoints = getFeaturePoints(featureID);
+        std::vector<LatLon> points(featurePoints, featurePoints + getFeaturePointCount(featureID));
+        if(!points.empty() && touches(boundsOf(points), box))
+            contents.features.push_back(featureID);
+    }
+
+    for(unsigned poiID = 0; poiID < getNumberOfPointsOfInterest(); poiID++) {
+        if(touches(boundsOf({getPointOfInterestPosition(poiID)}), box))
+            contents.pointsOfInterest.push_back(poiID);
+    }
+    return contents;
+}
+
+// Boxes of random sizes over the map and a margin around it (see
+// random_positions), so that some lie partly or wholly off the map. The
+// corners are in no particular order.
+std::vector<std::pair<LatLon, LatLon> > randomBoxes(std::mt19937& rng, unsigned count) {
+    std::vector<LatLon> positions = random_positions(rng, 2 * count);
+    std::uniform_real_distribution<float> size(0, 0.2);
+
+    std::vector<std::pair<LatLon, LatLon> > boxes;
+    for(unsigned i = 0; i < count; i++) {
+        LatLon corner1 = positions[2 * i], far = positions[2 * i + 1];
+        float scale = size(rng);
+        LatLon corner2(corner1.lat + (far.lat - corner1.lat) * scale,
+                corner1.lon + (far.lon - corner1.lon) * scale);
+        boxes.push_back(std::make_pair(corner1, corner2));
+    }
+    return boxes;
+}
+}
+
+SUITE(query_box) {
+    TEST(query_box_kinds_match_linear_scan) {
+        std::mt19937 rng(23);
+
+        unsigned found = 0;
+        for(std::pair<LatLon, LatLon> box : randomBoxes(rng, 50)) {
+            BoxContents expected = linearScan(box.first, box.second);
+            found += expected.streetSegments.size();
+
+            CHECK(expected.intersections == query_box_intersections(box.first, box.second));
+            CHECK(expected.streetSegments == query_box_street_segments(box.first, box.second));
+            CHECK(expected.features == query_box_features(box.first, box.second));
+            CHECK(expected.pointsOfInterest == query_box_points_of_interest(box.first, box.second));
+        }
+
+        // Not all of the boxes missed the map
+        CHECK(found > 0);
+    } //query_box_kinds_match_linear_scan
+
+    TEST(query_box_matches_linear_scan) {
+        std::mt19937 rng(24);
+
+        for(std::pair<LatLon, LatLon> box : randomBoxes(rng, 50)) {
+            BoxContents expected = linearScan(box.first, box.second);
+            BoxContents actual = query_box(box.first, box.second);
+
+            CHECK(expected.intersections == actual.intersections);
+            CHECK(expected.streetSegments == actual.streetSegments);
+            CHECK(expected.features == actual.features);
+            CHECK(expected.pointsOfInterest == actual.pointsOfInterest);
+        }
+    } //query_box_matches_linear_scan
+
+    TEST(corner_order_does_not_matter) {
+        std::mt19937 rng(25);
+
+        for(std::pair<LatLon, LatLon> box : randomBoxes(rng, 20)) {
+            LatLon corner3(box.first.lat, box.second.lon);
+            LatLon corner4(box.second.lat, box.first.lon);
+            std::vector<unsigned> segments = query_box_street_segments(box.first, box.second);
+
+            CHECK(segments == query_box_street_segments(box.second, box.first));
+            CHECK(segments == query_box_street_segments(corner3, corner4));
+            CHECK(segments == query_box_street_segments(corner4, corner3));
+        }
+    } //corner_order_does_not_matter
+
+    TEST(whole_map) {
+        BoxContents contents = query_box(LatLon(-90, -180), LatLon(90, 180));
+
+        CHECK_EQUAL(getNumberOfIntersections(), contents.intersections.size());
+        CHECK_EQUAL(getNumberOfStreetSegments(), contents.streetSegments.size());
+        CHECK_EQUAL(getNumberOfPointsOfInterest(), contents.pointsOfInterest.size());
+        CHECK(contents.features.size() <= getNumberOfFeatures());
+    } //whole_map
+
+} //query_box
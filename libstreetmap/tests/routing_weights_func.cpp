@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <climits>
+#include <random>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <unittest++/UnitTest++.h>
+
+#include "StreetsDatabaseAPI.h"
+#include "m1.h"
+#include "m3.h"
+#include "RoutingGraph.h"
+
+#include "unit_test_util.h"
+#include "path_verify.h"
+
+using ece297test::relative_error;
+using ece297test::path_is_legal;
+
+namespace {
+
+// Puts back the speed limit the streets database gives each changed segment
+void restoreSegments(const std::vector<unsigned>& segmentIDs) {
+    std::vector<RoutingGraph::SegmentChange> changes;
+    for(unsigned segmentID : segmentIDs)
+        changes.push_back({segmentID, getStreetSegmentInfo(segmentID).speedLimit, false});
+    RoutingGraph::getInstance().updateWeights(changes);
+}
+
+const double turnTime = 0.25; // minutes, as compute_path_travel_time charges
+
+// Travel time (minutes) of the path plain Dijkstra finds from start to end,
+// or infinity if there is none. Like find_path_between_intersections it
+// keeps one label per intersection and charges a turn when the street
+// changes from the one the label arrived on, but it has no heuristic.
+double dijkstraTravelTime(unsigned start, unsigned end) {
+    const RoutingGraph::Arcs& arcs = RoutingGraph::getInstance().getForward();
+    std::shared_ptr<const RoutingGraph::Weights> weights = RoutingGraph::getInstance().getWeights();
+    unsigned numberOfIntersections = getNumberOfIntersections();
+
+    std::vector<double> time(numberOfIntersections, std::numeric_limits<double>::infinity());
+    std::vector<unsigned> arrivingStreet(numberOfIntersections, UINT_MAX);
+    std::vector<bool> settled(numberOfIntersections, false);
+    typedef std::pair<double, unsigned> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > frontier;
+
+    time[start] = 0.0;
+    frontier.push(Entry(0.0, start));
+    while(!frontier.empty()) {
+        unsigned at = frontier.top().second;
+        frontier.pop();
+        if(settled[at])
+            continue;
+        settled[at] = true;
+        if(at == end)
+            break;
+
+        for(unsigned arc = arcs.begin(at); arc < arcs.end(at); arc++) {
+            unsigned next = arcs.target[arc];
+            double nextTime = time[at] + weights->forwardTravelTime[arc];
+            if(arrivingStreet[at] != UINT_MAX && arrivingStreet[at] != arcs.streetID[arc])
+                nextTime += turnTime;
+            if(!settled[next] && nextTime < time[next]) {
+                time[next] = nextTime;
+                arrivingStreet[next] = arcs.streetID[arc];
+                frontier.push(Entry(nextTime, next));
+            }
+        }
+    }
+
+    return time[end];
+}
+}
+
+SUITE(routing_weights) {
+    TEST(update_publishes_new_snapshot) {
+        unsigned segmentID = getNumberOfStreetSegments() / 2;
+        float speedLimit = getStreetSegmentInfo(segmentID).speedLimit;
+        double travelTime = find_street_segment_travel_time(segmentID);
+
+        std::shared_ptr<const RoutingGraph::Weights> before = RoutingGraph::getInstance().getWeights();
+        RoutingGraph::getInstance().updateWeights({{segmentID, 2 * speedLimit, false}});
+        std::shared_ptr<const RoutingGraph::Weights> after = RoutingGraph::getInstance().getWeights();
+
+        // Readers of the old snapshot keep the old weights
+        CHECK(before != after);
+        CHECK_EQUAL(travelTime, before->segmentTravelTime[segmentID]);
+        CHECK_EQUAL(speedLimit, before->speedLimit[segmentID]);
+
+        CHECK(relative_error(travelTime / 2, find_street_segment_travel_time(segmentID)) < 1e-9);
+        CHECK_EQUAL(2 * speedLimit, after->speedLimit[segmentID]);
+        CHECK(after->maxSpeedLimit >= 2 * speedLimit);
+
+        restoreSegments({segmentID});
+        CHECK(relative_error(travelTime, find_street_segment_travel_time(segmentID)) < 1e-9);
+    } //update_publishes_new_snapshot
+
+    TEST(closed_segments_are_avoided) {
+        std::mt19937 rng(3);
+        unsigned numberOfStreetSegments = getNumberOfStreetSegments();
+
+        for(unsigned i = 0; i < 20; i++) {
+            unsigned segmentID = rng() % numberOfStreetSegments;
+            StreetSegmentInfo info = getStreetSegmentInfo(segmentID);
+            double travelTime = find_street_segment_travel_time(segmentID);
+            if(info.from == info.to)
+                continue;
+
+            RoutingGraph::getInstance().updateWeights({{segmentID, info.speedLimit, true}});
+            CHECK(RoutingGraph::getInstance().getWeights()->closed[segmentID]);
+            CHECK(std::isinf(find_street_segment_travel_time(segmentID)));
+
+            std::vector<unsigned> path = find_path_between_intersections(info.from, info.to);
+            CHECK(std::find(path.begin(), path.end(), segmentID) == path.end());
+            if(!path.empty())
+                CHECK(path_is_legal(info.from, info.to, path));
+
+            restoreSegments({segmentID});
+            CHECK(!RoutingGraph::getInstance().getWeights()->closed[segmentID]);
+            CHECK(relative_error(travelTime, find_street_segment_travel_time(segmentID)) < 1e-9);
+        }
+    } //closed_segments_are_avoided
+
+    TEST(invalid_update_publishes_nothing) {
+        std::shared_ptr<const RoutingGraph::Weights> before = RoutingGraph::getInstance().getWeights();
+
+        CHECK_THROW(RoutingGraph::getInstance().updateWeights({{0, 50, false}, {0, 0, false}}), std::invalid_argument);
+        CHECK_THROW(RoutingGraph::getInstance().updateWeights({{getNumberOfStreetSegments(), 50, false}}), std::out_of_range);
+
+        CHECK(before == RoutingGraph::getInstance().getWeights());
+    } //invalid_update_publishes_nothing
+
+    TEST(paths_use_segments_faster_than_heuristic_bound) {
+        std::mt19937 rng(14);
+        unsigned numberOfIntersections = getNumberOfIntersections();
+        unsigned numberOfStreetSegments = getNumberOfStreetSegments();
+
+        // Make a few streets much faster than any road the heuristic
+        // assumed before, so A* has to find the paths along them
+        std::vector<unsigned> changed;
+        std::vector<RoutingGraph::SegmentChange> changes;
+        for(unsigned street = 0; street < 20; street++) {
+            unsigned streetID = getStreetSegmentInfo(rng() % numberOfStreetSegments).streetID;
+            for(unsigned segmentID : find_street_street_segments(streetID)) {
+                changed.push_back(segmentID);
+                changes.push_back({segmentID, 2000, false});
+            }
+        }
+        RoutingGraph::getInstance().updateWeights(changes);
+
+        for(unsigned i = 0; i < 100; i++) {
+            unsigned start = rng() % numberOfIntersections;
+            unsigned end = rng() % numberOfIntersections;
+
+            double dijkstraTime = dijkstraTravelTime(start, end);
+            std::vector<unsigned> path = find_path_between_intersections(start, end);
+            if(std::isinf(dijkstraTime)) {
+                CHECK(path.empty());
+                continue;
+            }
+
+            // With one label per intersection, the turn penalties can make
+            // either search settle an intersection through a slightly worse
+            // predecessor, so allow a turn's worth of difference. A heuristic
+            // that overestimates misses the fast streets by far more.
+            CHECK(start == end || path_is_legal(start, end, path));
+            CHECK(compute_path_travel_time(path) <= dijkstraTime + turnTime + 1e-6);
+        }
+
+        restoreSegments(changed);
+    } //paths_use_segments_faster_than_heuristic_bound
+
+} //routing_weights
@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <string>
+#include <unittest++/UnitTest++.h>
+
+#include "StreetsDatabaseAPI.h"
+#include "m1.h"
+
+#include "unit_test_util.h"
+
+namespace {
+
+// The intersections of the streets, ascending, without duplicates
+std::vector<unsigned> allIntersections(const std::vector<unsigned>& streetIDs) {
+    std::vector<unsigned> intersections;
+    for(unsigned streetID : streetIDs) {
+        std::vector<unsigned> streetIntersections = find_all_street_intersections(streetID);
+        intersections.insert(intersections.end(), streetIntersections.begin(), streetIntersections.end());
+    }
+    std::sort(intersections.begin(), intersections.end());
+    intersections.erase(std::unique(intersections.begin(), intersections.end()), intersections.end());
+    return intersections;
+}
+
+// The intersections any street of streetIDs1 shares with any street of
+// streetIDs2, ascending. Merging the intersections of every pair of streets,
+// as the lookups did before the street pair index, finds the same ones as
+// this, and a street in both lists (a name paired with itself) gives all
+// of its intersections.
+std::vector<unsigned> mergedIntersections(const std::vector<unsigned>& streetIDs1,
+        const std::vector<unsigned>& streetIDs2) {
+    std::vector<unsigned> intersections1 = allIntersections(streetIDs1);
+    std::vector<unsigned> intersections2 = allIntersections(streetIDs2);
+    std::vector<unsigned> found;
+    std::set_intersection(intersections1.begin(), intersections1.end(),
+            intersections2.begin(), intersections2.end(), std::back_inserter(found));
+    return found;
+}
+
+// Pairs of street names: those meeting at count random intersections, each
+// of those names with itself, and names of random streets that may not meet
+std::vector<std::pair<std::string, std::string> > namePairs(std::mt19937& rng, unsigned count) {
+    std::vector<std::pair<std::string, std::string> > pairs;
+    for(unsigned i = 0; i < count; i++) {
+        std::vector<std::string> names = find_intersection_street_names(rng() % getNumberOfIntersections());
+        for(unsigned first = 0; first < names.size(); first++) {
+            pairs.push_back(std::make_pair(names[first], names[first]));
+            for(unsigned second = first + 1; second < names.size(); second++)
+                pairs.push_back(std::make_pair(names[first], names[second]));
+        }
+
+        pairs.push_back(std::make_pair(getStreetName(rng() % getNumberOfStreets()),
+                getStreetName(rng() % getNumberOfStreets())));
+    }
+    return pairs;
+}
+
+// A word of name, chosen by rng, with its first letter lowered half the time
+std::string partOf(const std::string& name, std::mt19937& rng) {
+    std::vector<std::string> words = separateString(name);
+    std::string part = words[rng() % words.size()];
+    if(!part.empty() && rng() % 2)
+        part[0] = tolower(part[0]);
+    return part;
+}
+}
+
+SUITE(street_pair) {
+    TEST(exact_names_match_merged_intersections) {
+        std::mt19937 rng(22);
+
+        for(const std::pair<std::string, std::string>& names : namePairs(rng, 200)) {
+            std::vector<unsigned> expected = mergedIntersections(
+                    find_street_ids_from_name(names.first),
+                    find_street_ids_from_name(names.second));
+
+            CHECK(expected == find_intersection_ids_from_street_names(names.first, names.second));
+            CHECK(expected == find_intersection_ids_from_street_names(names.second, names.first));
+        }
+    } //exact_names_match_merged_intersections
+
+    TEST(name_with_itself_gives_all_its_intersections) {
+        std::mt19937 rng(23);
+
+        for(unsigned i = 0; i < 100; i++) {
+            std::string name = getStreetName(rng() % getNumberOfStreets());
+            CHECK(allIntersections(find_street_ids_from_name(name))
+                    == find_intersection_ids_from_street_names(name, name));
+        }
+    } //name_with_itself_gives_all_its_intersections
+
+    TEST(parts_of_names_match_merged_intersections) {
+        std::mt19937 rng(24);
+
+        for(const std::pair<std::string, std::string>& names : namePairs(rng, 50)) {
+            std::string part1 = partOf(names.first, rng);
+            std::string part2 = partOf(names.second, rng);
+            std::vector<unsigned> expected = mergedIntersections(
+                    searchStreetByPartOfName(part1), searchStreetByPartOfName(part2));
+
+            CHECK(expected == searchIntersectionByPartsOfName(part1, part2));
+        }
+    } //parts_of_names_match_merged_intersections
+
+    TEST(unknown_names) {
+        std::string name = getStreetName(0);
+
+        CHECK(find_intersection_ids_from_street_names("no such street", name).empty());
+        CHECK(find_intersection_ids_from_street_names(name, "no such street").empty());
+        CHECK(searchIntersectionByPartsOfName("no such street", name).empty());
+    } //unknown_names
+
+} //street_pair
@@ -3,6 +3,11 @@
 #include <vector>
 #include <string>
 #include <cmath>
+#include <algorithm>
+#include <limits>
+#include <random>
+
+#include "StreetsDatabaseAPI.h"
 
 
 #ifndef MAX_VEC_PRINT
@@ -48,6 +53,30 @@ float absolute_error(T A, T B) {
     return fabs(A - B);
 }
 
+//Uniformly random positions over the bounding box of the loaded map's
+//intersections, plus a margin of a tenth of it on each side so that some
+//fall off the map
+inline std::vector<LatLon> random_positions(std::mt19937& rng, unsigned count) {
+    float minLat = std::numeric_limits<float>::max(), maxLat = -minLat;
+    float minLon = minLat, maxLon = maxLat;
+    for(unsigned i = 0; i < getNumberOfIntersections(); i++) {
+        LatLon position = getIntersectionPosition(i);
+        minLat = std::min(minLat, position.lat);
+        maxLat = std::max(maxLat, position.lat);
+        minLon = std::min(minLon, position.lon);
+        maxLon = std::max(maxLon, position.lon);
+    }
+
+    float latMargin = (maxLat - minLat) / 10, lonMargin = (maxLon - minLon) / 10;
+    std::uniform_real_distribution<float> lat(minLat - latMargin, maxLat + latMargin);
+    std::uniform_real_distribution<float> lon(minLon - lonMargin, maxLon + lonMargin);
+
+    std::vector<LatLon> positions;
+    for(unsigned i = 0; i < count; i++)
+        positions.push_back(LatLon(lat(rng), lon(rng)));
+    return positions;
+}
+
 }
 
 #ifdef ECE297_TIME_CONSTRAINT
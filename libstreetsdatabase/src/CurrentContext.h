@@ -0,0 +1,83 @@
+/*
+ * CurrentContext.h
+ *
+ *  Picks which instance of some per-map state T the free-function APIs act on, so that several maps can be loaded at
+ *  once. The current instance for a thread is the one bound to that thread, if any, otherwise the one selected for the
+ *  whole process, otherwise a default instance created on first use. Threads start unbound, so code that hands work to
+ *  other threads binds them to its own instance first.
+ *
+ *  Code that keeps T as part of some larger per-map state installs a selector instead of selecting T directly, so
+ *  unbound threads find T through that state and a switch of maps is published with a single store.
+ */
+
+#ifndef CURRENTCONTEXT_H_
+#define CURRENTCONTEXT_H_
+
+#include <atomic>
+
+template<typename T>class CurrentContext {
+public:
+
+    typedef T* (*Selector)();
+
+    static T& get() {
+        if (T* t = bound())
+            return *t;
+        if (Selector s = selector().load(std::memory_order_acquire))
+            return *s();
+        if (T* t = selected().load(std::memory_order_acquire))
+            return *t;
+        return defaultInstance();
+    }
+
+    static T& defaultInstance() {
+        static T instance;
+        return instance;
+    }
+
+    /// Makes t current for every thread without a binding of its own; nullptr goes back to the default instance
+
+    static void select(T* t) {
+        selected().store(t, std::memory_order_release);
+    }
+
+    /// Makes unbound threads use the (non-null) instance s returns instead of the selected one; nullptr goes back to
+    /// the selected instance
+
+    static void setSelector(Selector s) {
+        selector().store(s, std::memory_order_release);
+    }
+
+    /// Makes t current for the calling thread only; nullptr removes the binding. Returns the previous binding
+
+    static T* bind(T* t) {
+        T* previous = bound();
+        bound() = t;
+        return previous;
+    }
+
+    /// The instance bound to the calling thread, or nullptr
+
+    static T* binding() {
+        return bound();
+    }
+
+private:
+
+    static T*& bound() {
+        static thread_local T* t = nullptr;
+        return t;
+    }
+
+    static std::atomic<T*>& selected() {
+        static std::atomic<T*> t(nullptr);
+        return t;
+    }
+
+    static std::atomic<Selector>& selector() {
+        static std::atomic<Selector> s(nullptr);
+        return s;
+    }
+};
+
+#endif /* CURRENTCONTEXT_H_ */
@@ -59,6 +59,17 @@ public:
         return m_points;
     }
 
+    /// Moves the points out (e.g. into a shared pool), leaving the feature with none
+    std::vector<LatLon> releasePoints() {
+        std::vector<LatLon> pts;
+        pts.swap(m_points);
+        return pts;
+    }
+
+    void points(std::vector<LatLon>&& pts) {
+        m_points = std::move(pts);
+    }
+
     std::pair<OSMID, OSMEntityType> id() const {
         return std::make_pair(m_id, m_osmType);
     }
@@ -0,0 +1,195 @@
+/*
+ * MMapFile.h
+ *
+ *  Helpers shared by the memory-mapped database formats: a read-only file mapping, section layout checks and an
+ *  atomic (write temporary, then rename) section writer.
+ */
+
+#ifndef MMAPFILE_H_
+#define MMAPFILE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// A whole file mapped read-only and shared
+class MappedFile {
+public:
+    MappedFile() {
+    }
+
+    ~MappedFile() {
+        close();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& fn) {
+        close();
+
+        int fd = ::open(fn.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+
+        void* base = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd); // the mapping keeps the file referenced
+
+        if (base == MAP_FAILED)
+            return false;
+
+        m_base = base;
+        m_size = st.st_size;
+        return true;
+    }
+
+    void close() {
+        if (m_base)
+            munmap(m_base, m_size);
+        m_base = nullptr;
+        m_size = 0;
+    }
+
+    bool isOpen() const {
+        return m_base != nullptr;
+    }
+
+    const char* data() const {
+        return static_cast<const char*> (m_base);
+    }
+
+    std::size_t size() const {
+        return m_size;
+    }
+
+    /// Pointer to a section of count T's at offset, or nullptr if it is misaligned or runs past the end of the file
+    template<typename T>const T* section(uint64_t offset, uint64_t count) const {
+        if (offset % alignof(T) != 0 || offset > m_size || count > (m_size - offset) / sizeof(T))
+            return nullptr;
+        return reinterpret_cast<const T*> (data() + offset);
+    }
+
+private:
+    void* m_base = nullptr;
+    std::size_t m_size = 0;
+};
+
+/// Lays out sections one after another, each starting on an 8-byte boundary
+class MMapLayout {
+public:
+    explicit MMapLayout(uint64_t headerSize) : m_offset(headerSize) {
+    }
+
+    template<typename T>uint64_t place(const std::vector<T>& v) {
+        m_offset = alignUp(m_offset);
+        uint64_t at = m_offset;
+        m_offset += v.size() * sizeof(T);
+        return at;
+    }
+
+    uint64_t size() const {
+        return m_offset;
+    }
+
+    static uint64_t alignUp(uint64_t x) {
+        return (x + 7) & ~uint64_t(7);
+    }
+
+private:
+    uint64_t m_offset;
+};
+
+/// Writes the header and sections (in the order they were placed) to a temporary file, then renames it to fn
+/// so a concurrent reader never maps a partial file. Each writer has its own temporary file, so writers of the
+/// same file (e.g. two contexts of one process loading the same map) don't truncate each other's.
+
+class MMapWriter {
+public:
+    explicit MMapWriter(const std::string& fn) : m_fn(fn), m_tmp(tempName(fn)),
+    m_os(m_tmp.c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc) {
+    }
+
+    ~MMapWriter() {
+        if (!m_committed) {
+            m_os.close();
+            std::remove(m_tmp.c_str());
+        }
+    }
+
+    template<typename Header>void header(const Header& h) {
+        m_os.write(reinterpret_cast<const char*> (&h), sizeof(h));
+        m_offset = sizeof(h);
+    }
+
+    template<typename T>void section(const std::vector<T>& v) {
+        static const char zeros[8] = {0};
+
+        m_os.write(zeros, MMapLayout::alignUp(m_offset) - m_offset);
+        m_offset = MMapLayout::alignUp(m_offset);
+        m_os.write(reinterpret_cast<const char*> (v.data()), v.size() * sizeof(T));
+        m_offset += v.size() * sizeof(T);
+    }
+
+    /// Finishes the file; returns false (and leaves no file behind) on any write error or size mismatch
+    bool commit(uint64_t expectedSize) {
+        m_os.close();
+        if (m_os.fail() || m_offset != expectedSize || std::rename(m_tmp.c_str(), m_fn.c_str()) != 0)
+            return false;
+        m_committed = true;
+        return true;
+    }
+
+private:
+    /// fn plus the process id and a count of the writers this process has made
+    static std::string tempName(const std::string& fn) {
+        static std::atomic<unsigned> writers(0);
+        return fn + ".tmp" + std::to_string(getpid()) + "." + std::to_string(writers++);
+    }
+
+    std::string m_fn, m_tmp;
+    std::ofstream m_os;
+    uint64_t m_offset = 0;
+    bool m_committed = false;
+};
+
+/// Interns strings into a pool of null-terminated characters, returning the byte offset of each
+
+class MMapStringPool {
+public:
+    uint32_t add(const std::string& s) {
+        const auto it = m_offsets.find(s);
+        if (it != m_offsets.end())
+            return it->second;
+
+        uint32_t offset = m_chars.size();
+        m_chars.insert(m_chars.end(), s.begin(), s.end());
+        m_chars.push_back('\0');
+        m_offsets.insert(std::make_pair(s, offset));
+        return offset;
+    }
+
+    const std::vector<char>& chars() const {
+        return m_chars;
+    }
+
+private:
+    std::vector<char> m_chars;
+    std::unordered_map<std::string, uint32_t> m_offsets;
+};
+
+#endif /* MMAPFILE_H_ */
@@ -0,0 +1,90 @@
+/*
+ * NameTable.h
+ *
+ *  Interned strings: each distinct string added gets a small integer ID (0, 1, 2, ... in order of first insertion)
+ *  and is stored once. Lookups by ID return a boost::string_view, so comparing or hashing names needs no allocation.
+ */
+
+#ifndef NAMETABLE_H_
+#define NAMETABLE_H_
+
+#include <cstdint>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include <boost/functional/hash.hpp>
+#include <boost/utility/string_view.hpp>
+
+class NameTable {
+public:
+
+    NameTable() {
+    }
+
+    // the index holds views of the stored strings, so a copy re-interns into its own storage
+    NameTable(const NameTable& other) {
+        *this = other;
+    }
+
+    NameTable& operator=(const NameTable& other) {
+        if (this != &other) {
+            clear();
+            for (const std::string& s : other.m_names)
+                intern(s);
+        }
+        return *this;
+    }
+
+    // deque and unordered_map keep their elements in place when moved, so the views stay valid
+    NameTable(NameTable&&) = default;
+    NameTable& operator=(NameTable&&) = default;
+
+    /// Returns the ID of s, adding it if it is new
+    uint32_t intern(boost::string_view s) {
+        const auto it = m_ids.find(s);
+        if (it != m_ids.end())
+            return it->second;
+
+        uint32_t id = m_names.size();
+        m_names.emplace_back(s.data(), s.size());
+        m_ids.insert(std::make_pair(boost::string_view(m_names.back()), id));
+        return id;
+    }
+
+    /// Returns the ID of s, or -1U if it was never added
+    uint32_t find(boost::string_view s) const {
+        const auto it = m_ids.find(s);
+        return it == m_ids.end() ? -1U : it->second;
+    }
+
+    /// Valid until the table is cleared or destroyed
+    boost::string_view name(uint32_t id) const {
+        if (id >= m_names.size())
+            throw std::out_of_range("NameTable: id");
+        return m_names[id];
+    }
+
+    unsigned size() const {
+        return m_names.size();
+    }
+
+    void clear() {
+        m_ids.clear();
+        m_names.clear();
+    }
+
+private:
+
+    struct ViewHash {
+        std::size_t operator()(boost::string_view s) const {
+            return boost::hash_range(s.begin(), s.end());
+        }
+    };
+
+    std::deque<std::string> m_names; // by ID; a deque so that adding names does not move the stored ones
+    std::unordered_map<boost::string_view, uint32_t, ViewHash> m_ids;
+};
+
+#endif /* NAMETABLE_H_ */
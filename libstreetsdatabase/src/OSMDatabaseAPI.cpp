@@ -8,6 +8,10 @@
 #include <fstream>
 #include "OSMDatabaseAPI.h"
 #include "OSMDatabase.hpp"
+#include "OSMDatabaseMMap.h"
+#include "CurrentContext.h"
+#include <mutex>
+#include <stdexcept>
 #include <string>
 #include <utility>
 
@@ -15,71 +19,388 @@
 
 using namespace std;
 
-OSMDatabase osmdb;
+// One loaded OSM database
+
+class OSMDatabaseContext {
+public:
+    OSMDatabase db;
+    OSMDatabaseMMap mapped;
+
+    // When the mapped database is open, get*ByIndex hand out pointers into these stand-in entities. They are built on
+    // first use and hold only IDs (plus node coordinates); getTagCount/getTagPair recognize them by address and read
+    // the tags from the mapping instead.
+    std::mutex mappedEntitiesMutex;
+    vector<OSMNode> mappedNodes;
+    vector<OSMWay> mappedWays;
+    vector<OSMRelation> mappedRelations;
+};
+
+typedef CurrentContext<OSMDatabaseContext> CurrentOSMDatabase;
+
+namespace {
+
+OSMDatabase& osmdb() {
+    return CurrentOSMDatabase::get().db;
+}
+
+OSMDatabaseMMap& mappedOSMDB() {
+    return CurrentOSMDatabase::get().mapped;
+}
+
+const vector<OSMNode>& getMappedNodes() {
+    OSMDatabaseContext& c = CurrentOSMDatabase::get();
+    lock_guard<mutex> lock(c.mappedEntitiesMutex);
+    if (c.mappedNodes.size() != c.mapped.header().nNodes) {
+        c.mappedNodes.reserve(c.mapped.header().nNodes);
+        for (uint64_t i = 0; i < c.mapped.header().nNodes; ++i) {
+            const MMapOSMNode& n = c.mapped.node(i);
+            c.mappedNodes.emplace_back(n.id, n.coords.lat, n.coords.lon);
+        }
+    }
+    return c.mappedNodes;
+}
+
+const vector<OSMWay>& getMappedWays() {
+    OSMDatabaseContext& c = CurrentOSMDatabase::get();
+    lock_guard<mutex> lock(c.mappedEntitiesMutex);
+    if (c.mappedWays.size() != c.mapped.header().nWays) {
+        c.mappedWays.reserve(c.mapped.header().nWays);
+        for (uint64_t i = 0; i < c.mapped.header().nWays; ++i)
+            c.mappedWays.emplace_back(c.mapped.way(i).id);
+    }
+    return c.mappedWays;
+}
+
+const vector<OSMRelation>& getMappedRelations() {
+    OSMDatabaseContext& c = CurrentOSMDatabase::get();
+    lock_guard<mutex> lock(c.mappedEntitiesMutex);
+    if (c.mappedRelations.size() != c.mapped.header().nRelations) {
+        c.mappedRelations.reserve(c.mapped.header().nRelations);
+        for (uint64_t i = 0; i < c.mapped.header().nRelations; ++i)
+            c.mappedRelations.emplace_back(c.mapped.relation(i).id);
+    }
+    return c.mappedRelations;
+}
+
+void clearMappedEntities() {
+    OSMDatabaseContext& c = CurrentOSMDatabase::get();
+    lock_guard<mutex> lock(c.mappedEntitiesMutex);
+    c.mappedNodes = vector<OSMNode>();
+    c.mappedWays = vector<OSMWay>();
+    c.mappedRelations = vector<OSMRelation>();
+}
+
+/// Index of e within v, or -1ULL if e is not one of its elements
+
+template<typename Entity>uint64_t indexIn(const vector<Entity>& v, const OSMEntity* e) {
+    std::less<const OSMEntity*> less;
+    if (v.empty() || less(e, &v.front()) || less(&v.back(), e))
+        return -1ULL;
+    return static_cast<const Entity*> (e) - v.data();
+}
+}
+
+// database contexts
+
+OSMDatabaseContext* createOSMDatabaseContext() {
+    return new OSMDatabaseContext;
+}
+
+void destroyOSMDatabaseContext(OSMDatabaseContext* context) {
+    if (context != &CurrentOSMDatabase::defaultInstance())
+        delete context;
+}
+
+OSMDatabaseContext* getDefaultOSMDatabaseContext() {
+    return &CurrentOSMDatabase::defaultInstance();
+}
+
+void selectOSMDatabaseContext(OSMDatabaseContext* context) {
+    CurrentOSMDatabase::select(context);
+}
+
+void setOSMDatabaseContextSelector(OSMDatabaseContext* (*selector)()) {
+    CurrentOSMDatabase::setSelector(selector);
+}
+
+OSMDatabaseContext* bindOSMDatabaseContext(OSMDatabaseContext* context) {
+    return CurrentOSMDatabase::bind(context);
+}
 
 // load the optional layer-1 OSM database
 
 bool loadOSMDatabaseBIN(const std::string& fn) {
+    mappedOSMDB().close();
+    clearMappedEntities();
+
     ifstream is(fn.c_str(), ios_base::in | ios_base::binary);
 
     boost::archive::binary_iarchive ia(is);
 
-    ia & osmdb;
+    ia & osmdb();
 
     return true;
 }
 
+bool loadOSMDatabaseMMap(const std::string& fn) {
+    osmdb() = OSMDatabase();
+    clearMappedEntities();
+
+    return mappedOSMDB().open(fn);
+}
+
+bool saveOSMDatabaseMMap(const std::string& fn) {
+    if (mappedOSMDB().isOpen())
+        return false;
+
+    return writeOSMDatabaseMMap(osmdb(), fn);
+}
+
 void closeOSMDatabase() {
-    osmdb = OSMDatabase();
+    osmdb() = OSMDatabase();
+    mappedOSMDB().close();
+    clearMappedEntities();
 }
 
 // Query the number of entities in the database
 
 unsigned long long getNumberOfNodes() {
-    return osmdb.nodes().size();
+    if (mappedOSMDB().isOpen())
+        return mappedOSMDB().header().nNodes;
+    return osmdb().nodes().size();
 }
 
 unsigned long long getNumberOfWays() {
-    return osmdb.ways().size();
+    if (mappedOSMDB().isOpen())
+        return mappedOSMDB().header().nWays;
+    return osmdb().ways().size();
 }
 
 unsigned long long getNumberOfRelations() {
-    return osmdb.relations().size();
+    if (mappedOSMDB().isOpen())
+        return mappedOSMDB().header().nRelations;
+    return osmdb().relations().size();
 }
 
 // Query all nodes in the database, by node index
 
 const OSMNode* getNodeByIndex(unsigned idx) {
-    return &osmdb.nodes().at(idx);
+    if (mappedOSMDB().isOpen())
+        return &getMappedNodes().at(idx);
+    return &osmdb().nodes().at(idx);
 }
 
 const OSMWay* getWayByIndex(unsigned idx) {
-    return &osmdb.ways().at(idx);
+    if (mappedOSMDB().isOpen())
+        return &getMappedWays().at(idx);
+    return &osmdb().ways().at(idx);
 }
 
 const OSMRelation* getRelationByIndex(unsigned idx) {
-    return &osmdb.relations().at(idx);
+    if (mappedOSMDB().isOpen())
+        return &getMappedRelations().at(idx);
+    return &osmdb().relations().at(idx);
+}
+
+// Look up an entity index by OSM ID
+
+template<typename Entity>unsigned indexFromID(const vector<Entity>& v, const Entity& (OSMDatabase::*fromID)(unsigned long long) const, OSMID id) {
+    try {
+        return &(osmdb().*fromID)(id) - v.data();
+    } catch (const std::out_of_range&) {
+        return -1U;
+    }
+}
+
+unsigned getNodeIndexFromOSMID(OSMID id) {
+    if (mappedOSMDB().isOpen())
+        return mappedOSMDB().nodeIndex(id);
+    return indexFromID(osmdb().nodes(), &OSMDatabase::nodeFromID, id);
+}
+
+unsigned getWayIndexFromOSMID(OSMID id) {
+    if (mappedOSMDB().isOpen())
+        return mappedOSMDB().wayIndex(id);
+    return indexFromID(osmdb().ways(), &OSMDatabase::wayFromID, id);
+}
+
+unsigned getRelationIndexFromOSMID(OSMID id) {
+    if (mappedOSMDB().isOpen())
+        return mappedOSMDB().relationIndex(id);
+    return indexFromID(osmdb().relations(), &OSMDatabase::relationFromID, id);
+}
+
+// Node refs of a way and members of a relation
+
+unsigned getWayNodeRefCount(const OSMWay* w) {
+    if (mappedOSMDB().isOpen())
+        return mappedOSMDB().way(indexIn(getMappedWays(), w)).nodeRefCount;
+    return w->ndrefs().size();
+}
+
+OSMID getWayNodeRef(const OSMWay* w, unsigned idx) {
+    if (mappedOSMDB().isOpen())
+        return mappedOSMDB().wayNodeRef(indexIn(getMappedWays(), w), idx);
+    return w->ndrefs().at(idx);
+}
+
+unsigned getRelationMemberCount(const OSMRelation* r) {
+    if (mappedOSMDB().isOpen())
+        return mappedOSMDB().relation(indexIn(getMappedRelations(), r)).memberCount;
+    return r->members().size();
+}
+
+OSMRelation::Member getRelationMember(const OSMRelation* r, unsigned idx) {
+    if (mappedOSMDB().isOpen())
+        return mappedOSMDB().relationMember(indexIn(getMappedRelations(), r), idx);
+    return r->members().at(idx);
+}
+
+// The entity type of e, found from which entity vector it points into
+
+enum class TagOwner {
+    Node, Way, Relation
+};
+
+static TagOwner tagOwner(const OSMEntity* e, uint64_t& idx) {
+    if (mappedOSMDB().isOpen()) {
+        if ((idx = indexIn(getMappedWays(), e)) != -1ULL)
+            return TagOwner::Way;
+        else if ((idx = indexIn(getMappedNodes(), e)) != -1ULL)
+            return TagOwner::Node;
+        else if ((idx = indexIn(getMappedRelations(), e)) != -1ULL)
+            return TagOwner::Relation;
+    } else {
+        if ((idx = indexIn(osmdb().ways(), e)) != -1ULL)
+            return TagOwner::Way;
+        else if ((idx = indexIn(osmdb().nodes(), e)) != -1ULL)
+            return TagOwner::Node;
+        else if ((idx = indexIn(osmdb().relations(), e)) != -1ULL)
+            return TagOwner::Relation;
+    }
+    throw std::invalid_argument("OSM entity is not part of the loaded database");
 }
 
 unsigned getTagCount(const OSMEntity* e) {
+    if (mappedOSMDB().isOpen()) {
+        uint64_t i;
+        switch (tagOwner(e, i)) {
+            case TagOwner::Node: return mappedOSMDB().node(i).tagCount;
+            case TagOwner::Way: return mappedOSMDB().way(i).tagCount;
+            case TagOwner::Relation: return mappedOSMDB().relation(i).tagCount;
+        }
+    }
     return e->tags().size();
 }
 
 std::pair<std::string, std::string> getTagPair(const OSMEntity* e, unsigned tagIdx) {
-    const OSMNode* n = nullptr;
-    const OSMWay* w = nullptr;
-    const OSMRelation* r = nullptr;
+    uint64_t i;
+    TagOwner owner = tagOwner(e, i);
+
+    if (mappedOSMDB().isOpen()) {
+        switch (owner) {
+            case TagOwner::Node: return mappedOSMDB().nodeTag(i, tagIdx);
+            case TagOwner::Way: return mappedOSMDB().wayTag(i, tagIdx);
+            case TagOwner::Relation: return mappedOSMDB().relationTag(i, tagIdx);
+        }
+    }
 
     std::pair<unsigned, unsigned> p = e->tags().at(tagIdx);
 
-    if ((n = dynamic_cast<const OSMNode*> (e)))
-        return osmdb.nodeTags().getKeyValue(p);
-    else if ((w = dynamic_cast<const OSMWay*> (e)))
-        return osmdb.wayTags().getKeyValue(p);
-    else if ((r = dynamic_cast<const OSMRelation*> (e)))
-        return osmdb.relationTags().getKeyValue(p);
+    switch (owner) {
+        case TagOwner::Node: return osmdb().nodeTags().getKeyValue(p);
+        case TagOwner::Way: return osmdb().wayTags().getKeyValue(p);
+        case TagOwner::Relation: return osmdb().relationTags().getKeyValue(p);
+    }
+    throw std::logic_error("getTagPair: unknown entity type");
+}
+
+// Typed tag access
+
+unsigned getNodeTagKeyIndex(const std::string& key) {
+    if (mappedOSMDB().isOpen())
+        return mappedOSMDB().nodeKeyIndex(key);
+    return osmdb().nodeTags().getIndexForKeyString(key);
+}
+
+unsigned getWayTagKeyIndex(const std::string& key) {
+    if (mappedOSMDB().isOpen())
+        return mappedOSMDB().wayKeyIndex(key);
+    return osmdb().wayTags().getIndexForKeyString(key);
+}
+
+unsigned getRelationTagKeyIndex(const std::string& key) {
+    if (mappedOSMDB().isOpen())
+        return mappedOSMDB().relationKeyIndex(key);
+    return osmdb().relationTags().getIndexForKeyString(key);
+}
+
+static OSMTagRange entityTags(const OSMEntity* e) {
+    return OSMTagRange(e->tags().data(), e->tags().size());
+}
+
+OSMTagRange getNodeTags(const OSMNode* n) {
+    if (mappedOSMDB().isOpen())
+        return mappedOSMDB().nodeTags(indexIn(getMappedNodes(), n));
+    return entityTags(n);
+}
+
+OSMTagRange getWayTags(const OSMWay* w) {
+    if (mappedOSMDB().isOpen())
+        return mappedOSMDB().wayTags(indexIn(getMappedWays(), w));
+    return entityTags(w);
+}
+
+OSMTagRange getRelationTags(const OSMRelation* r) {
+    if (mappedOSMDB().isOpen())
+        return mappedOSMDB().relationTags(indexIn(getMappedRelations(), r));
+    return entityTags(r);
+}
 
-    assert(false);
+unsigned getNodeTagValueIndex(const OSMNode* n, unsigned keyIdx) {
+    return getNodeTags(n).valueForKey(keyIdx);
 }
 
+unsigned getWayTagValueIndex(const OSMWay* w, unsigned keyIdx) {
+    return getWayTags(w).valueForKey(keyIdx);
+}
+
+unsigned getRelationTagValueIndex(const OSMRelation* r, unsigned keyIdx) {
+    return getRelationTags(r).valueForKey(keyIdx);
+}
 
+boost::string_view getNodeTagKeyString(unsigned keyIdx) {
+    if (mappedOSMDB().isOpen())
+        return mappedOSMDB().nodeKey(keyIdx);
+    return osmdb().nodeTags().getKey(keyIdx);
+}
+
+boost::string_view getNodeTagValueString(unsigned valueIdx) {
+    if (mappedOSMDB().isOpen())
+        return mappedOSMDB().nodeValue(valueIdx);
+    return osmdb().nodeTags().getValue(valueIdx);
+}
+
+boost::string_view getWayTagKeyString(unsigned keyIdx) {
+    if (mappedOSMDB().isOpen())
+        return mappedOSMDB().wayKey(keyIdx);
+    return osmdb().wayTags().getKey(keyIdx);
+}
+
+boost::string_view getWayTagValueString(unsigned valueIdx) {
+    if (mappedOSMDB().isOpen())
+        return mappedOSMDB().wayValue(valueIdx);
+    return osmdb().wayTags().getValue(valueIdx);
+}
+
+boost::string_view getRelationTagKeyString(unsigned keyIdx) {
+    if (mappedOSMDB().isOpen())
+        return mappedOSMDB().relationKey(keyIdx);
+    return osmdb().relationTags().getKey(keyIdx);
+}
+
+boost::string_view getRelationTagValueString(unsigned valueIdx) {
+    if (mappedOSMDB().isOpen())
+        return mappedOSMDB().relationValue(valueIdx);
+    return osmdb().relationTags().getValue(valueIdx);
+}
@@ -3,11 +3,32 @@
 #include "OSMNode.hpp"
 #include "OSMWay.hpp"
 #include "OSMRelation.hpp"
+#include "OSMTagRange.h"
+
+#include <boost/utility/string_view.hpp>
+
+// As with StreetsDatabaseContext, several OSM databases can be loaded at once, each in its own OSMDatabaseContext; the
+// functions below act on the calling thread's current one
+class OSMDatabaseContext;
+OSMDatabaseContext* createOSMDatabaseContext();
+void destroyOSMDatabaseContext(OSMDatabaseContext* context); // the default context is never destroyed
+OSMDatabaseContext* getDefaultOSMDatabaseContext();
+void selectOSMDatabaseContext(OSMDatabaseContext* context);
+void setOSMDatabaseContextSelector(OSMDatabaseContext* (*selector)()); // see setStreetsDatabaseContextSelector
+OSMDatabaseContext* bindOSMDatabaseContext(OSMDatabaseContext* context);
 
 // load the optional layer-1 OSM database
 bool loadOSMDatabaseBIN(const std::string&);
 void closeOSMDatabase();
 
+// load the layer-1 OSM database from a memory-mapped file written by saveOSMDatabaseMMap. Entities returned by
+// get*ByIndex then carry only their OSM ID (and node coordinates); use getTagCount/getTagPair and the ndref/member
+// accessors below rather than the entity's own tags()/ndrefs()/members(), which are empty in this mode
+bool loadOSMDatabaseMMap(const std::string&);
+
+// write the currently-loaded (BIN) OSM database as a memory-mapped file, returning false on failure
+bool saveOSMDatabaseMMap(const std::string&);
+
 // Query the number of entities in the database
 unsigned long long getNumberOfNodes();
 unsigned long long getNumberOfWays();
@@ -18,8 +39,47 @@ const OSMNode* getNodeByIndex(unsigned idx);
 const OSMWay* getWayByIndex(unsigned idx);
 const OSMRelation* getRelationByIndex(unsigned idx);
 
+// Look up an entity index by OSM ID, returning -1U if there is no such entity
+unsigned getNodeIndexFromOSMID(OSMID id);
+unsigned getWayIndexFromOSMID(OSMID id);
+unsigned getRelationIndexFromOSMID(OSMID id);
+
+// Node refs of a way and members of a relation, by index
+unsigned getWayNodeRefCount(const OSMWay* w);
+OSMID getWayNodeRef(const OSMWay* w, unsigned idx);
+unsigned getRelationMemberCount(const OSMRelation* r);
+OSMRelation::Member getRelationMember(const OSMRelation* r, unsigned idx);
+
 // Count number of tags for a given OSMEntity (OSMWay/OSMNode/OSMRelation)
 unsigned getTagCount(const OSMEntity* e);
 
 // Return n'th key-value pair
 std::pair<std::string, std::string> getTagPair(const OSMEntity* e, unsigned idx);
+
+
+// Typed tag access, by index rather than by string. Node, way and relation tags each have their own key and value
+// tables, so an index is only meaningful with the entity type it came from. Looking a key index up once and then
+// scanning entities with get*TagValueIndex or the tag ranges involves no allocation and no type tests on the entity.
+
+// Index of a key, or -1U if no entity of that type uses it
+unsigned getNodeTagKeyIndex(const std::string& key);
+unsigned getWayTagKeyIndex(const std::string& key);
+unsigned getRelationTagKeyIndex(const std::string& key);
+
+// All the (key index, value index) pairs of an entity, sorted by key index. Valid until the database is closed
+OSMTagRange getNodeTags(const OSMNode* n);
+OSMTagRange getWayTags(const OSMWay* w);
+OSMTagRange getRelationTags(const OSMRelation* r);
+
+// Value index of the entity's tag with the given key index (binary search), or -1U if it has no such tag
+unsigned getNodeTagValueIndex(const OSMNode* n, unsigned keyIdx);
+unsigned getWayTagValueIndex(const OSMWay* w, unsigned keyIdx);
+unsigned getRelationTagValueIndex(const OSMRelation* r, unsigned keyIdx);
+
+// Key and value strings by index. Valid until the database is closed
+boost::string_view getNodeTagKeyString(unsigned keyIdx);
+boost::string_view getNodeTagValueString(unsigned valueIdx);
+boost::string_view getWayTagKeyString(unsigned keyIdx);
+boost::string_view getWayTagValueString(unsigned valueIdx);
+boost::string_view getRelationTagKeyString(unsigned keyIdx);
+boost::string_view getRelationTagValueString(unsigned valueIdx);
@@ -0,0 +1,380 @@
+/*
+ * OSMDatabaseMMap.cpp
+ *
+ *  Reader and writer for the memory-mapped OSM database format (see OSMDatabaseMMap.h).
+ */
+
+#include "OSMDatabaseMMap.h"
+#include "OSMDatabase.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+namespace {
+const char mmapMagic[8] = "OSMMMAP";
+
+/// Appends a set of strings to the string table, returning the table index of the first one
+
+uint32_t addStrings(vector<uint32_t>& table, MMapStringPool& pool, const vector<string>& strings) {
+    uint32_t first = table.size();
+    for (const string& s : strings)
+        table.push_back(pool.add(s));
+    return first;
+}
+
+vector<MMapOSMIDIndex> sortedIDIndex(const vector<OSMID>& ids) {
+    vector<MMapOSMIDIndex> v(ids.size());
+    for (uint64_t i = 0; i < ids.size(); ++i)
+        v[i] = MMapOSMIDIndex{ids[i], i};
+    stable_sort(v.begin(), v.end(), [](const MMapOSMIDIndex& lhs, const MMapOSMIDIndex & rhs) {
+        return lhs.id < rhs.id;
+    });
+    return v;
+}
+
+uint64_t findID(const MMapOSMIDIndex* index, uint64_t n, OSMID id) {
+    const MMapOSMIDIndex* it = lower_bound(index, index + n, id, [](const MMapOSMIDIndex& e, OSMID i) {
+        return e.id < i;
+    });
+    return (it == index + n || it->id != id) ? -1ULL : it->index;
+}
+
+/// Checks that every tag range of the entities lies within the tag array
+
+template<typename Entity>bool tagRangesValid(const Entity* e, uint64_t n, uint64_t nTags) {
+    for (uint64_t i = 0; i < n; ++i)
+        if (e[i].firstTag > nTags || e[i].tagCount > nTags - e[i].firstTag)
+            return false;
+    return true;
+}
+
+bool tableValid(uint32_t first, uint32_t count, uint64_t nStrings) {
+    return first <= nStrings && count <= nStrings - first;
+}
+}
+
+bool OSMDatabaseMMap::open(const std::string& fn) {
+    close();
+
+    if (!m_file.open(fn) || m_file.size() < sizeof(MMapOSMHeader))
+        return false;
+
+    const MMapOSMHeader* h = reinterpret_cast<const MMapOSMHeader*> (m_file.data());
+
+    if (memcmp(h->magic, mmapMagic, sizeof(mmapMagic)) != 0 || h->version != version ||
+            h->headerSize != sizeof(MMapOSMHeader) || h->fileSize != m_file.size()) {
+        m_file.close();
+        return false;
+    }
+
+    m_header = h;
+    m_nodes = m_file.section<MMapOSMNode>(h->nodesOffset, h->nNodes);
+    m_ways = m_file.section<MMapOSMWay>(h->waysOffset, h->nWays);
+    m_relations = m_file.section<MMapOSMRelation>(h->relationsOffset, h->nRelations);
+    m_nodeTags = m_file.section<MMapOSMTag>(h->nodeTagsOffset, h->nNodeTags);
+    m_wayTags = m_file.section<MMapOSMTag>(h->wayTagsOffset, h->nWayTags);
+    m_relationTags = m_file.section<MMapOSMTag>(h->relationTagsOffset, h->nRelationTags);
+    m_nodeRefs = m_file.section<OSMID>(h->nodeRefsOffset, h->nNodeRefs);
+    m_members = m_file.section<MMapOSMMember>(h->membersOffset, h->nMembers);
+    m_nodeIDs = m_file.section<MMapOSMIDIndex>(h->nodeIDsOffset, h->nNodes);
+    m_wayIDs = m_file.section<MMapOSMIDIndex>(h->wayIDsOffset, h->nWays);
+    m_relationIDs = m_file.section<MMapOSMIDIndex>(h->relationIDsOffset, h->nRelations);
+    m_strings = m_file.section<uint32_t>(h->stringsOffset, h->nStrings);
+    m_chars = m_file.section<char>(h->charsOffset, h->nChars);
+
+    bool ok = m_nodes && m_ways && m_relations && m_nodeTags && m_wayTags && m_relationTags && m_nodeRefs && m_members &&
+            m_nodeIDs && m_wayIDs && m_relationIDs && m_strings && m_chars && h->nChars > 0 && m_chars[h->nChars - 1] == '\0';
+
+    // tags are decoded without further checks, so validate the ranges they index once here
+    ok = ok && tableValid(h->nodeKeys, h->nNodeKeys, h->nStrings) && tableValid(h->nodeValues, h->nNodeValues, h->nStrings) &&
+            tableValid(h->wayKeys, h->nWayKeys, h->nStrings) && tableValid(h->wayValues, h->nWayValues, h->nStrings) &&
+            tableValid(h->relationKeys, h->nRelationKeys, h->nStrings) &&
+            tableValid(h->relationValues, h->nRelationValues, h->nStrings) && tableValid(h->roles, h->nRoles, h->nStrings);
+
+    ok = ok && tagRangesValid(m_nodes, h->nNodes, h->nNodeTags) && tagRangesValid(m_ways, h->nWays, h->nWayTags) &&
+            tagRangesValid(m_relations, h->nRelations, h->nRelationTags);
+
+    for (uint64_t i = 0; ok && i < h->nStrings; ++i)
+        ok = m_strings[i] < h->nChars;
+
+    if (!ok) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void OSMDatabaseMMap::close() {
+    m_file.close();
+    m_header = nullptr;
+}
+
+const MMapOSMNode& OSMDatabaseMMap::node(uint64_t idx) const {
+    if (idx >= m_header->nNodes)
+        throw std::out_of_range("OSMDatabaseMMap: node index");
+    return m_nodes[idx];
+}
+
+const MMapOSMWay& OSMDatabaseMMap::way(uint64_t idx) const {
+    if (idx >= m_header->nWays)
+        throw std::out_of_range("OSMDatabaseMMap: way index");
+    return m_ways[idx];
+}
+
+const MMapOSMRelation& OSMDatabaseMMap::relation(uint64_t idx) const {
+    if (idx >= m_header->nRelations)
+        throw std::out_of_range("OSMDatabaseMMap: relation index");
+    return m_relations[idx];
+}
+
+uint64_t OSMDatabaseMMap::nodeIndex(OSMID id) const {
+    return findID(m_nodeIDs, m_header->nNodes, id);
+}
+
+uint64_t OSMDatabaseMMap::wayIndex(OSMID id) const {
+    return findID(m_wayIDs, m_header->nWays, id);
+}
+
+uint64_t OSMDatabaseMMap::relationIndex(OSMID id) const {
+    return findID(m_relationIDs, m_header->nRelations, id);
+}
+
+const char* OSMDatabaseMMap::tableString(uint32_t table, uint32_t tableSize, uint32_t i) const {
+    if (i >= tableSize)
+        throw std::out_of_range("OSMDatabaseMMap: string index");
+    return m_chars + m_strings[table + i];
+}
+
+std::pair<std::string, std::string> OSMDatabaseMMap::tag(const MMapOSMTag* tags, uint64_t first, uint32_t count, unsigned tagIdx,
+        uint32_t keys, uint32_t nKeys, uint32_t values, uint32_t nValues) const {
+    if (tagIdx >= count)
+        throw std::out_of_range("OSMDatabaseMMap: tag index");
+    const MMapOSMTag& t = tags[first + tagIdx];
+    return std::make_pair(std::string(tableString(keys, nKeys, t.key)), std::string(tableString(values, nValues, t.value)));
+}
+
+std::pair<std::string, std::string> OSMDatabaseMMap::nodeTag(uint64_t idx, unsigned tagIdx) const {
+    const MMapOSMNode& n = node(idx);
+    return tag(m_nodeTags, n.firstTag, n.tagCount, tagIdx, m_header->nodeKeys, m_header->nNodeKeys,
+            m_header->nodeValues, m_header->nNodeValues);
+}
+
+std::pair<std::string, std::string> OSMDatabaseMMap::wayTag(uint64_t idx, unsigned tagIdx) const {
+    const MMapOSMWay& w = way(idx);
+    return tag(m_wayTags, w.firstTag, w.tagCount, tagIdx, m_header->wayKeys, m_header->nWayKeys,
+            m_header->wayValues, m_header->nWayValues);
+}
+
+std::pair<std::string, std::string> OSMDatabaseMMap::relationTag(uint64_t idx, unsigned tagIdx) const {
+    const MMapOSMRelation& r = relation(idx);
+    return tag(m_relationTags, r.firstTag, r.tagCount, tagIdx, m_header->relationKeys, m_header->nRelationKeys,
+            m_header->relationValues, m_header->nRelationValues);
+}
+
+OSMTagRange OSMDatabaseMMap::nodeTags(uint64_t idx) const {
+    const MMapOSMNode& n = node(idx);
+    return OSMTagRange(m_nodeTags + n.firstTag, n.tagCount);
+}
+
+OSMTagRange OSMDatabaseMMap::wayTags(uint64_t idx) const {
+    const MMapOSMWay& w = way(idx);
+    return OSMTagRange(m_wayTags + w.firstTag, w.tagCount);
+}
+
+OSMTagRange OSMDatabaseMMap::relationTags(uint64_t idx) const {
+    const MMapOSMRelation& r = relation(idx);
+    return OSMTagRange(m_relationTags + r.firstTag, r.tagCount);
+}
+
+unsigned OSMDatabaseMMap::keyIndex(uint32_t keys, uint32_t nKeys, boost::string_view key) const {
+    for (uint32_t i = 0; i < nKeys; ++i)
+        if (key == tableString(keys, nKeys, i))
+            return i;
+    return -1U;
+}
+
+unsigned OSMDatabaseMMap::nodeKeyIndex(boost::string_view key) const {
+    return keyIndex(m_header->nodeKeys, m_header->nNodeKeys, key);
+}
+
+unsigned OSMDatabaseMMap::wayKeyIndex(boost::string_view key) const {
+    return keyIndex(m_header->wayKeys, m_header->nWayKeys, key);
+}
+
+unsigned OSMDatabaseMMap::relationKeyIndex(boost::string_view key) const {
+    return keyIndex(m_header->relationKeys, m_header->nRelationKeys, key);
+}
+
+boost::string_view OSMDatabaseMMap::nodeKey(unsigned keyIdx) const {
+    return tableString(m_header->nodeKeys, m_header->nNodeKeys, keyIdx);
+}
+
+boost::string_view OSMDatabaseMMap::nodeValue(unsigned valueIdx) const {
+    return tableString(m_header->nodeValues, m_header->nNodeValues, valueIdx);
+}
+
+boost::string_view OSMDatabaseMMap::wayKey(unsigned keyIdx) const {
+    return tableString(m_header->wayKeys, m_header->nWayKeys, keyIdx);
+}
+
+boost::string_view OSMDatabaseMMap::wayValue(unsigned valueIdx) const {
+    return tableString(m_header->wayValues, m_header->nWayValues, valueIdx);
+}
+
+boost::string_view OSMDatabaseMMap::relationKey(unsigned keyIdx) const {
+    return tableString(m_header->relationKeys, m_header->nRelationKeys, keyIdx);
+}
+
+boost::string_view OSMDatabaseMMap::relationValue(unsigned valueIdx) const {
+    return tableString(m_header->relationValues, m_header->nRelationValues, valueIdx);
+}
+
+OSMID OSMDatabaseMMap::wayNodeRef(uint64_t idx, unsigned refIdx) const {
+    const MMapOSMWay& w = way(idx);
+    if (refIdx >= w.nodeRefCount || w.firstNodeRef + refIdx >= m_header->nNodeRefs)
+        throw std::out_of_range("OSMDatabaseMMap: node ref index");
+    return m_nodeRefs[w.firstNodeRef + refIdx];
+}
+
+OSMRelation::Member OSMDatabaseMMap::relationMember(uint64_t idx, unsigned memberIdx) const {
+    const MMapOSMRelation& r = relation(idx);
+    if (memberIdx >= r.memberCount || r.firstMember + memberIdx >= m_header->nMembers)
+        throw std::out_of_range("OSMDatabaseMMap: member index");
+    const MMapOSMMember& m = m_members[r.firstMember + memberIdx];
+    return OSMRelation::Member{m.id, static_cast<OSMRelation::MemberType> (m.type), m.role};
+}
+
+bool writeOSMDatabaseMMap(const OSMDatabase& db, const std::string& fn) {
+    MMapOSMHeader h = MMapOSMHeader();
+    memcpy(h.magic, mmapMagic, sizeof(mmapMagic));
+    h.version = OSMDatabaseMMap::version;
+    h.headerSize = sizeof(MMapOSMHeader);
+
+    h.nNodes = db.nodes().size();
+    h.nWays = db.ways().size();
+    h.nRelations = db.relations().size();
+    h.boundsMin = db.bounds().first;
+    h.boundsMax = db.bounds().second;
+
+    // one string table holds every key/value/role set; tags keep their per-type indices into it
+    MMapStringPool pool;
+    vector<uint32_t> strings;
+
+    h.nodeKeys = addStrings(strings, pool, db.nodeTags().keys());
+    h.nNodeKeys = db.nodeTags().keys().size();
+    h.nodeValues = addStrings(strings, pool, db.nodeTags().values());
+    h.nNodeValues = db.nodeTags().values().size();
+    h.wayKeys = addStrings(strings, pool, db.wayTags().keys());
+    h.nWayKeys = db.wayTags().keys().size();
+    h.wayValues = addStrings(strings, pool, db.wayTags().values());
+    h.nWayValues = db.wayTags().values().size();
+    h.relationKeys = addStrings(strings, pool, db.relationTags().keys());
+    h.nRelationKeys = db.relationTags().keys().size();
+    h.relationValues = addStrings(strings, pool, db.relationTags().values());
+    h.nRelationValues = db.relationTags().values().size();
+    h.roles = addStrings(strings, pool, db.relationRoles().values());
+    h.nRoles = db.relationRoles().values().size();
+
+    if (pool.chars().empty())
+        pool.add("");
+
+    vector<MMapOSMNode> nodes(h.nNodes);
+    vector<MMapOSMTag> nodeTags;
+    vector<OSMID> ids(h.nNodes);
+    for (uint64_t i = 0; i < h.nNodes; ++i) {
+        const OSMNode& n = db.nodes()[i];
+        MMapOSMNode& r = nodes[i];
+        r.id = ids[i] = n.id();
+        r.coords = n.coords();
+        r.firstTag = nodeTags.size();
+        r.tagCount = n.tags().size();
+        for (const auto& t : n.tags())
+            nodeTags.push_back(MMapOSMTag{t.first, t.second});
+    }
+    const vector<MMapOSMIDIndex> nodeIDs = sortedIDIndex(ids);
+
+    vector<MMapOSMWay> ways(h.nWays);
+    vector<MMapOSMTag> wayTags;
+    vector<OSMID> nodeRefs;
+    ids.resize(h.nWays);
+    for (uint64_t i = 0; i < h.nWays; ++i) {
+        const OSMWay& w = db.ways()[i];
+        MMapOSMWay& r = ways[i];
+        r.id = ids[i] = w.id();
+        r.firstTag = wayTags.size();
+        r.tagCount = w.tags().size();
+        r.firstNodeRef = nodeRefs.size();
+        r.nodeRefCount = w.ndrefs().size();
+        for (const auto& t : w.tags())
+            wayTags.push_back(MMapOSMTag{t.first, t.second});
+        nodeRefs.insert(nodeRefs.end(), w.ndrefs().begin(), w.ndrefs().end());
+    }
+    const vector<MMapOSMIDIndex> wayIDs = sortedIDIndex(ids);
+
+    vector<MMapOSMRelation> relations(h.nRelations);
+    vector<MMapOSMTag> relationTags;
+    vector<MMapOSMMember> members;
+    ids.resize(h.nRelations);
+    for (uint64_t i = 0; i < h.nRelations; ++i) {
+        const OSMRelation& rel = db.relations()[i];
+        MMapOSMRelation& r = relations[i];
+        r.id = ids[i] = rel.id();
+        r.firstTag = relationTags.size();
+        r.tagCount = rel.tags().size();
+        r.firstMember = members.size();
+        r.memberCount = rel.members().size();
+        for (const auto& t : rel.tags())
+            relationTags.push_back(MMapOSMTag{t.first, t.second});
+        for (const OSMRelation::Member& m : rel.members())
+            members.push_back(MMapOSMMember{m.id, static_cast<uint32_t> (m.type), m.role});
+    }
+    const vector<MMapOSMIDIndex> relationIDs = sortedIDIndex(ids);
+
+    h.nNodeTags = nodeTags.size();
+    h.nWayTags = wayTags.size();
+    h.nRelationTags = relationTags.size();
+    h.nNodeRefs = nodeRefs.size();
+    h.nMembers = members.size();
+    h.nStrings = strings.size();
+    h.nChars = pool.chars().size();
+
+    // lay the sections out in the order they are written
+    MMapLayout layout(sizeof(MMapOSMHeader));
+    h.nodesOffset = layout.place(nodes);
+    h.waysOffset = layout.place(ways);
+    h.relationsOffset = layout.place(relations);
+    h.nodeTagsOffset = layout.place(nodeTags);
+    h.wayTagsOffset = layout.place(wayTags);
+    h.relationTagsOffset = layout.place(relationTags);
+    h.nodeRefsOffset = layout.place(nodeRefs);
+    h.membersOffset = layout.place(members);
+    h.nodeIDsOffset = layout.place(nodeIDs);
+    h.wayIDsOffset = layout.place(wayIDs);
+    h.relationIDsOffset = layout.place(relationIDs);
+    h.stringsOffset = layout.place(strings);
+    h.charsOffset = layout.place(pool.chars());
+    h.fileSize = layout.size();
+
+    MMapWriter writer(fn);
+    writer.header(h);
+    writer.section(nodes);
+    writer.section(ways);
+    writer.section(relations);
+    writer.section(nodeTags);
+    writer.section(wayTags);
+    writer.section(relationTags);
+    writer.section(nodeRefs);
+    writer.section(members);
+    writer.section(nodeIDs);
+    writer.section(wayIDs);
+    writer.section(relationIDs);
+    writer.section(strings);
+    writer.section(pool.chars());
+
+    return writer.commit(h.fileSize);
+}
@@ -0,0 +1,203 @@
+/*
+ * OSMDatabaseMMap.h
+ *
+ *  Flat, offset-based on-disk form of the layer-1 OSM database.
+ *
+ *  Nodes, ways and relations are fixed-size records holding their OSM ID and a range into shared arrays of tag pairs
+ *  (key index, value index), node refs and relation members. Each entity type also has an array of (OSM ID, index)
+ *  sorted by ID, which replaces the ID hash maps of OSMDatabase with a binary search. Key/value/role strings are offsets
+ *  into a pool of null-terminated characters, so tags are only turned into std::strings when somebody asks for them.
+ *
+ *  Like StreetsDatabaseMMap, the layout is native-endian and meant to be read back on the machine that wrote it.
+ */
+
+#ifndef OSMDATABASEMMAP_H_
+#define OSMDATABASEMMAP_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include <boost/utility/string_view.hpp>
+
+#include "LatLon.h"
+#include "MMapFile.h"
+#include "OSMEntityType.h"
+#include "OSMRelation.hpp"
+#include "OSMTagRange.h"
+
+class OSMDatabase;
+
+struct MMapOSMHeader {
+    char magic[8]; // "OSMMMAP\0"
+    uint32_t version;
+    uint32_t headerSize;
+
+    uint64_t nNodes;
+    uint64_t nWays;
+    uint64_t nRelations;
+    uint64_t nNodeTags; // tag pairs over all nodes
+    uint64_t nWayTags;
+    uint64_t nRelationTags;
+    uint64_t nNodeRefs;
+    uint64_t nMembers;
+    uint64_t nStrings; // entries in the string table (offsets into the pool)
+    uint64_t nChars;
+
+    // ranges of the string table holding each set of strings
+    uint32_t nodeKeys, nNodeKeys;
+    uint32_t nodeValues, nNodeValues;
+    uint32_t wayKeys, nWayKeys;
+    uint32_t wayValues, nWayValues;
+    uint32_t relationKeys, nRelationKeys;
+    uint32_t relationValues, nRelationValues;
+    uint32_t roles, nRoles;
+
+    LatLon boundsMin, boundsMax;
+
+    // byte offsets of each section from the start of the file
+    uint64_t nodesOffset;
+    uint64_t waysOffset;
+    uint64_t relationsOffset;
+    uint64_t nodeTagsOffset;
+    uint64_t wayTagsOffset;
+    uint64_t relationTagsOffset;
+    uint64_t nodeRefsOffset;
+    uint64_t membersOffset;
+    uint64_t nodeIDsOffset;
+    uint64_t wayIDsOffset;
+    uint64_t relationIDsOffset;
+    uint64_t stringsOffset;
+    uint64_t charsOffset;
+    uint64_t fileSize;
+};
+
+struct MMapOSMNode {
+    OSMID id;
+    LatLon coords;
+    uint64_t firstTag;
+    uint32_t tagCount;
+    uint32_t padding;
+};
+
+struct MMapOSMWay {
+    OSMID id;
+    uint64_t firstTag;
+    uint64_t firstNodeRef;
+    uint32_t tagCount;
+    uint32_t nodeRefCount;
+};
+
+struct MMapOSMRelation {
+    OSMID id;
+    uint64_t firstTag;
+    uint64_t firstMember;
+    uint32_t tagCount;
+    uint32_t memberCount;
+};
+
+struct MMapOSMMember {
+    OSMID id;
+    uint32_t type; // OSMRelation::MemberType
+    uint32_t role; // index into the role strings
+};
+
+struct MMapOSMIDIndex {
+    OSMID id;
+    uint64_t index;
+};
+
+/** Read-only view of a memory-mapped OSM database file.
+ *
+ * Entity indices are the same as in the OSMDatabase the file was written from.
+ */
+
+class OSMDatabaseMMap {
+public:
+    static const uint32_t version = 1;
+
+    OSMDatabaseMMap() {
+    }
+
+    ~OSMDatabaseMMap() {
+        close();
+    }
+
+    OSMDatabaseMMap(const OSMDatabaseMMap&) = delete;
+    OSMDatabaseMMap& operator=(const OSMDatabaseMMap&) = delete;
+
+    /// Maps the file read-only; returns false (leaving the object closed) if it is missing, truncated or of another version
+    bool open(const std::string& fn);
+    void close();
+
+    bool isOpen() const {
+        return m_file.isOpen();
+    }
+
+    const MMapOSMHeader& header() const {
+        return *m_header;
+    }
+
+    const MMapOSMNode& node(uint64_t idx) const;
+    const MMapOSMWay& way(uint64_t idx) const;
+    const MMapOSMRelation& relation(uint64_t idx) const;
+
+    /// Binary search of the sorted ID arrays, returning -1ULL if absent
+    uint64_t nodeIndex(OSMID id) const;
+    uint64_t wayIndex(OSMID id) const;
+    uint64_t relationIndex(OSMID id) const;
+
+    /// Tag pairs of an entity, resolved to strings only here
+    std::pair<std::string, std::string> nodeTag(uint64_t idx, unsigned tagIdx) const;
+    std::pair<std::string, std::string> wayTag(uint64_t idx, unsigned tagIdx) const;
+    std::pair<std::string, std::string> relationTag(uint64_t idx, unsigned tagIdx) const;
+
+    /// Tag pairs of an entity as indices, pointing into the mapping
+    OSMTagRange nodeTags(uint64_t idx) const;
+    OSMTagRange wayTags(uint64_t idx) const;
+    OSMTagRange relationTags(uint64_t idx) const;
+
+    /// Index of a key string among the keys of an entity type (first occurrence), or -1U; a linear scan of the keys
+    unsigned nodeKeyIndex(boost::string_view key) const;
+    unsigned wayKeyIndex(boost::string_view key) const;
+    unsigned relationKeyIndex(boost::string_view key) const;
+
+    /// Key/value strings by index, valid while the file is open
+    boost::string_view nodeKey(unsigned keyIdx) const;
+    boost::string_view nodeValue(unsigned valueIdx) const;
+    boost::string_view wayKey(unsigned keyIdx) const;
+    boost::string_view wayValue(unsigned valueIdx) const;
+    boost::string_view relationKey(unsigned keyIdx) const;
+    boost::string_view relationValue(unsigned valueIdx) const;
+
+    OSMID wayNodeRef(uint64_t idx, unsigned refIdx) const;
+    OSMRelation::Member relationMember(uint64_t idx, unsigned memberIdx) const;
+
+private:
+    MappedFile m_file;
+
+    const MMapOSMHeader* m_header = nullptr;
+    const MMapOSMNode* m_nodes = nullptr;
+    const MMapOSMWay* m_ways = nullptr;
+    const MMapOSMRelation* m_relations = nullptr;
+    const MMapOSMTag* m_nodeTags = nullptr;
+    const MMapOSMTag* m_wayTags = nullptr;
+    const MMapOSMTag* m_relationTags = nullptr;
+    const OSMID* m_nodeRefs = nullptr;
+    const MMapOSMMember* m_members = nullptr;
+    const MMapOSMIDIndex* m_nodeIDs = nullptr;
+    const MMapOSMIDIndex* m_wayIDs = nullptr;
+    const MMapOSMIDIndex* m_relationIDs = nullptr;
+    const uint32_t* m_strings = nullptr;
+    const char* m_chars = nullptr;
+
+    const char* tableString(uint32_t table, uint32_t tableSize, uint32_t i) const;
+    std::pair<std::string, std::string> tag(const MMapOSMTag* tags, uint64_t first, uint32_t count, unsigned tagIdx,
+            uint32_t keys, uint32_t nKeys, uint32_t values, uint32_t nValues) const;
+    unsigned keyIndex(uint32_t keys, uint32_t nKeys, boost::string_view key) const;
+};
+
+/// Writes db to fn in the format above
+bool writeOSMDatabaseMMap(const OSMDatabase& db, const std::string& fn);
+
+#endif /* OSMDATABASEMMAP_H_ */
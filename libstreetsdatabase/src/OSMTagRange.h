@@ -0,0 +1,68 @@
+/*
+ * OSMTagRange.h
+ *
+ *  The tags of one OSM entity as (key index, value index) pairs, without resolving them to strings. Indices refer to the
+ *  key/value strings of the entity's own type (node, way and relation tags each have their own tables). The pairs are
+ *  sorted by key index, so a key is found with a binary search.
+ */
+
+#ifndef OSMTAGRANGE_H_
+#define OSMTAGRANGE_H_
+
+#include <cstdint>
+#include <utility>
+
+struct MMapOSMTag {
+    uint32_t key; // indices into the key/value strings of the owning entity type
+    uint32_t value;
+};
+
+/// Points either at the tags of a loaded OSMEntity or at a run of tags in the memory-mapped database
+
+class OSMTagRange {
+public:
+
+    OSMTagRange() {
+    }
+
+    OSMTagRange(const std::pair<unsigned, unsigned>* tags, unsigned count) : m_pairs(tags), m_count(count) {
+    }
+
+    OSMTagRange(const MMapOSMTag* tags, unsigned count) : m_mapped(tags), m_count(count) {
+    }
+
+    unsigned size() const {
+        return m_count;
+    }
+
+    /// Key/value indices of the i'th tag (not range checked)
+
+    unsigned key(unsigned i) const {
+        return m_pairs ? m_pairs[i].first : m_mapped[i].key;
+    }
+
+    unsigned value(unsigned i) const {
+        return m_pairs ? m_pairs[i].second : m_mapped[i].value;
+    }
+
+    /// Value index for key index ki, or -1U if the entity has no such tag
+
+    unsigned valueForKey(unsigned ki) const {
+        unsigned lo = 0, hi = m_count;
+        while (lo < hi) {
+            unsigned mid = lo + (hi - lo) / 2;
+            if (key(mid) < ki)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return (lo == m_count || key(lo) != ki) ? -1U : value(lo);
+    }
+
+private:
+    const std::pair<unsigned, unsigned>* m_pairs = nullptr;
+    const MMapOSMTag* m_mapped = nullptr;
+    unsigned m_count = 0;
+};
+
+#endif /* OSMTAGRANGE_H_ */
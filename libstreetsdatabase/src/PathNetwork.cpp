@@ -98,6 +98,8 @@ PathNetwork buildNetwork(const OSMDatabase& db, const OSMEntityFilter<OSMWay>& w
     unsigned v_oneway_reversible = db.wayTags().getIndexForValueString("reversible");
     unsigned v_oneway_no = db.wayTags().getIndexForValueString("no");
 
+    unsigned k_highway = db.wayTags().getIndexForKeyString("highway");
+
     unsigned nOnewayForward = 0, nOnewayBackward = 0, nOnewayReversible = 0, nBidir = 0, nUnknown = 0;
     unsigned nWays = 0;
 
@@ -158,6 +160,9 @@ PathNetwork buildNetwork(const OSMDatabase& db, const OSMEntityFilter<OSMWay>& w
             speed = it->second;
         }
 
+        unsigned v_highway = k_highway == -1U ? -1U : w.getValueForKey(k_highway);
+        RoadClass roadClass = v_highway == -1U ? RoadClass::Other : roadClassFromHighwayTag(db.wayTags().getValue(v_highway));
+
         // assume bidirectional if not specified
 
         OneWayType oneway = Unknown;
@@ -245,6 +250,7 @@ PathNetwork buildNetwork(const OSMDatabase& db, const OSMEntityFilter<OSMWay>& w
                         G[e].oneWay = EdgeProperties::Bidir;
 
                     G[e].maxspeed = speed;
+                    G[e].roadClass = roadClass;
 
                     nCurvePoints += curvePoints.size();
 
@@ -28,6 +28,7 @@
 
 
 #include <boost/graph/adjacency_list.hpp>
+#include <boost/serialization/version.hpp>
 
 #include "OSMEntity.hpp"
 #include "OSMNode.hpp"
@@ -37,6 +38,7 @@
 #include "OSMEntityFilter.hpp"
 
 #include "OSMDatabase.hpp"
+#include "RoadClass.h"
 
 /** Specialization to pick out roads */
 
@@ -80,7 +82,7 @@ private:
 };
 
 struct EdgeProperties {
-    std::vector<LatLon> curvePoints;
+    std::vector<LatLon> curvePoints; // moved to the point pool of StreetsDatabase once loaded
     unsigned long long wayOSMID = -1U;
 
     unsigned streetVectorIndex = -1U;
@@ -93,14 +95,20 @@ struct EdgeProperties {
 
     Oneway oneWay = Bidir;
 
+    RoadClass roadClass = RoadClass::None; // from the way's highway tag; None in databases saved before version 1
+
 private:
     friend boost::serialization::access;
 
     template<class Archive>void serialize(Archive& ar, const unsigned ver) {
         ar & curvePoints & wayOSMID & streetVectorIndex & maxspeed & oneWay;
+        if (ver >= 1)
+            ar & roadClass;
     }
 };
 
+BOOST_CLASS_VERSION(EdgeProperties, 1)
+
 typedef boost::adjacency_list<
 boost::vecS, // outedgelist
 boost::vecS, // vertex list
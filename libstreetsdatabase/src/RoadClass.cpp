@@ -0,0 +1,54 @@
+/*
+ * RoadClass.cpp
+ */
+
+#include "RoadClass.h"
+
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// needs to be kept in sync with the RoadClass enum
+const vector<string> roadClassNames{
+    "<unknown-road-class>",
+    "motorway",
+    "motorway_link",
+    "trunk",
+    "trunk_link",
+    "primary",
+    "primary_link",
+    "secondary",
+    "secondary_link",
+    "tertiary",
+    "tertiary_link",
+    "unclassified",
+    "residential",
+    "service",
+    "<other-road-class>"
+};
+
+RoadClass roadClassFromHighwayTag(const string& value) {
+    static const unordered_map<string, RoadClass> classes{
+        {"motorway", RoadClass::Motorway},
+        {"motorway_link", RoadClass::MotorwayLink},
+        {"trunk", RoadClass::Trunk},
+        {"trunk_link", RoadClass::TrunkLink},
+        {"primary", RoadClass::Primary},
+        {"primary_link", RoadClass::PrimaryLink},
+        {"secondary", RoadClass::Secondary},
+        {"secondary_link", RoadClass::SecondaryLink},
+        {"tertiary", RoadClass::Tertiary},
+        {"tertiary_link", RoadClass::TertiaryLink},
+        {"unclassified", RoadClass::Unclassified},
+        {"residential", RoadClass::Residential},
+        {"service", RoadClass::Service}
+    };
+
+    const auto it = classes.find(value);
+    return it == classes.end() ? RoadClass::Other : it->second;
+}
+
+const string& asString(RoadClass c) {
+    return roadClassNames.at((unsigned) c);
+}
@@ -0,0 +1,37 @@
+/*
+ * RoadClass.h
+ *
+ *  Road class of a street segment, from the OSM highway=* tag of its way. Stored as one byte per segment so that users
+ *  of the streets database do not need the OSM database to tell motorways from residential streets.
+ */
+
+#ifndef ROADCLASS_H_
+#define ROADCLASS_H_
+
+#include <cstdint>
+#include <string>
+
+enum class RoadClass : uint8_t {
+    None = 0, // not known (the way was not found, or the database predates road classes)
+    Motorway,
+    MotorwayLink,
+    Trunk,
+    TrunkLink,
+    Primary,
+    PrimaryLink,
+    Secondary,
+    SecondaryLink,
+    Tertiary,
+    TertiaryLink,
+    Unclassified,
+    Residential,
+    Service,
+    Other // any other highway=* value, or no highway tag
+};
+
+/// Maps the value of a highway=* tag to its class
+RoadClass roadClassFromHighwayTag(const std::string& value);
+
+const std::string& asString(RoadClass c);
+
+#endif /* ROADCLASS_H_ */
@@ -7,12 +7,129 @@
 
 #include "StreetsDatabase.h"
 
+#include <set>
+#include <sstream>
+
 void StreetsDatabase::buildStreetSegmentVector() {
     m_streetSegmentVector.clear();
     m_streetSegmentVector.reserve(num_edges(m_roadNetwork));
+    m_hasRoadClasses = true;
 
     for (const auto e : edges(m_roadNetwork)) {
         m_roadNetwork[e].streetSegmentVectorIndex = m_streetSegmentVector.size();
         m_streetSegmentVector.push_back(e);
+        m_hasRoadClasses &= m_roadNetwork[e].roadClass != RoadClass::None;
+    }
+}
+
+void StreetsDatabase::roadClasses(const std::vector<RoadClass>& classes) {
+    if (classes.size() != m_streetSegmentVector.size())
+        throw std::invalid_argument("StreetsDatabase: road class count");
+
+    for (unsigned i = 0; i < classes.size(); ++i)
+        m_roadNetwork[m_streetSegmentVector[i]].roadClass = classes[i];
+
+    m_hasRoadClasses = true;
+}
+
+void StreetsDatabase::poolCurvePoints() {
+    std::size_t n = 0;
+    for (const auto e : m_streetSegmentVector)
+        n += m_roadNetwork[e].curvePoints.size();
+
+    m_points.clear();
+    m_points.reserve(n);
+    m_streetSegmentPoints.resize(m_streetSegmentVector.size());
+    m_featurePoints.clear();
+
+    for (unsigned i = 0; i < m_streetSegmentVector.size(); ++i) {
+        std::vector<LatLon> pts;
+        pts.swap(m_roadNetwork[m_streetSegmentVector[i]].curvePoints);
+
+        m_streetSegmentPoints[i].first = m_points.size();
+        m_streetSegmentPoints[i].count = pts.size();
+        m_points.insert(m_points.end(), pts.begin(), pts.end());
+    }
+
+    m_nCurvePoints = m_points.size();
+}
+
+void StreetsDatabase::poolFeaturePoints() {
+    // the points of any features pooled before (which have been replaced) are dropped
+    std::size_t n = m_nCurvePoints;
+    for (const Feature& f : m_features)
+        n += f.pointCount();
+
+    std::vector<LatLon> pool;
+    pool.reserve(n);
+    pool.insert(pool.end(), m_points.begin(), m_points.begin() + m_nCurvePoints);
+
+    m_featurePoints.resize(m_features.size());
+    for (unsigned i = 0; i < m_features.size(); ++i) {
+        const std::vector<LatLon> pts = m_features[i].releasePoints();
+
+        m_featurePoints[i].first = pool.size();
+        m_featurePoints[i].count = pts.size();
+        pool.insert(pool.end(), pts.begin(), pts.end());
     }
+
+    m_points.swap(pool);
+}
+
+void StreetsDatabase::unpoolPoints() {
+    for (unsigned i = 0; i < m_streetSegmentPoints.size(); ++i) {
+        const PointRange& r = m_streetSegmentPoints[i];
+        m_roadNetwork[m_streetSegmentVector[i]].curvePoints.assign(
+                m_points.begin() + r.first, m_points.begin() + r.first + r.count);
+    }
+
+    for (unsigned i = 0; i < m_featurePoints.size(); ++i) {
+        const PointRange& r = m_featurePoints[i];
+        m_features[i].points(std::vector<LatLon>(m_points.begin() + r.first, m_points.begin() + r.first + r.count));
+    }
+
+    m_points.clear();
+    m_streetSegmentPoints.clear();
+    m_featurePoints.clear();
+    m_nCurvePoints = 0;
+}
+
+std::string StreetsDatabase::buildIntersectionName(unsigned intersectionID) const {
+    if (intersectionID >= num_vertices(m_roadNetwork))
+        throw std::out_of_range("StreetsDatabase: intersectionID");
+
+    std::set<unsigned> streetIDs;
+
+    for (const auto e : out_edges(PathNetwork::vertex_descriptor(intersectionID), m_roadNetwork))
+        streetIDs.insert(m_roadNetwork[e].streetVectorIndex);
+
+    auto it = streetIDs.begin();
+    std::stringstream ss;
+
+    if (it != streetIDs.end())
+        ss << m_streets.at(*(it++));
+
+    for (; it != streetIDs.end(); ++it)
+        ss << " & " << m_streets.at(*it);
+
+    return ss.str();
+}
+
+void StreetsDatabase::buildNames() {
+    m_names.clear();
+
+    m_streetNameIDs.resize(m_streets.size());
+    for (unsigned i = 0; i < m_streets.size(); ++i)
+        m_streetNameIDs[i] = m_names.intern(m_streets[i]);
+
+    m_poiNameIDs.resize(m_pois.size());
+    m_poiTypeIDs.resize(m_pois.size());
+    for (unsigned i = 0; i < m_pois.size(); ++i) {
+        m_poiNameIDs[i] = m_names.intern(m_pois[i].name());
+        m_poiTypeIDs[i] = m_names.intern(m_pois[i].type());
+    }
+
+    m_intersectionNameIDs.resize(num_vertices(m_roadNetwork));
+    for (unsigned i = 0; i < m_intersectionNameIDs.size(); ++i)
+        m_intersectionNameIDs[i] = m_names.intern(buildIntersectionName(i));
 }
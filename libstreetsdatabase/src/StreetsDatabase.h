@@ -10,11 +10,16 @@
 
 #include "PathNetwork.hpp"
 
+#include <cstdint>
+#include <stdexcept>
 #include <vector>
 #include <string>
 
+#include <boost/serialization/split_member.hpp>
+
 #include "POI.hpp"
 #include "Feature.h"
+#include "NameTable.h"
 
 #include <utility>
 
@@ -30,6 +35,8 @@ public:
     StreetsDatabase(const PathNetwork& roads_, std::vector<std::string> streets_)
     : m_roadNetwork(roads_), m_streets(streets_) {
         buildStreetSegmentVector();
+        poolCurvePoints();
+        buildNames();
     }
 
     const PathNetwork& roads() const {
@@ -68,18 +75,82 @@ public:
 
     void pois(std::vector<POI>&& p) {
         m_pois = std::move(p);
+        buildNames();
     }
 
     void features(std::vector<Feature>&& f) {
         m_features = std::move(f);
+        poolFeaturePoints();
+    }
+
+    /// Interned street, POI and intersection names; the IDs below index names()
+
+    const NameTable& names() const {
+        return m_names;
+    }
+
+    uint32_t streetNameID(unsigned streetID) const {
+        return m_streetNameIDs.at(streetID);
+    }
+
+    uint32_t poiNameID(unsigned poiID) const {
+        return m_poiNameIDs.at(poiID);
+    }
+
+    uint32_t poiTypeID(unsigned poiID) const {
+        return m_poiTypeIDs.at(poiID);
+    }
+
+    uint32_t intersectionNameID(unsigned intersectionID) const {
+        return m_intersectionNameIDs.at(intersectionID);
+    }
+
+    /// The name of an intersection: the distinct names of the streets meeting there, by street ID, joined by " & "
+    std::string buildIntersectionName(unsigned intersectionID) const;
+
+    /// Curve points of street segments and points of features, held in the shared point pool (see below)
+
+    unsigned streetSegmentCurvePointCount(unsigned streetSegmentID) const {
+        return m_streetSegmentPoints.at(streetSegmentID).count;
+    }
+
+    const LatLon* streetSegmentCurvePoints(unsigned streetSegmentID) const {
+        return m_points.data() + m_streetSegmentPoints.at(streetSegmentID).first;
+    }
+
+    LatLon streetSegmentCurvePoint(unsigned streetSegmentID, unsigned idx) const {
+        return pooledPoint(m_streetSegmentPoints.at(streetSegmentID), idx);
+    }
+
+    unsigned featurePointCount(unsigned featureID) const {
+        return m_featurePoints.at(featureID).count;
     }
 
+    const LatLon* featurePoints(unsigned featureID) const {
+        return m_points.data() + m_featurePoints.at(featureID).first;
+    }
+
+    LatLon featurePoint(unsigned featureID, unsigned idx) const {
+        return pooledPoint(m_featurePoints.at(featureID), idx);
+    }
+
+    /// True if every street segment has a road class (false for databases saved before road classes were added)
+
+    bool hasRoadClasses() const {
+        return m_hasRoadClasses;
+    }
+
+    /// Sets the road class of every street segment, indexed by street segment ID
+
+    void roadClasses(const std::vector<RoadClass>& classes);
+
 private:
 
     // the road network
     PathNetwork m_roadNetwork; // connectivity graph for roads
     std::vector<std::string> m_streets; // street names (not necessarily unique)
     std::vector<PathNetwork::edge_descriptor> m_streetSegmentVector; // map streetSeg index -> graph edge
+    bool m_hasRoadClasses = false;
 
     void buildStreetSegmentVector();
 
@@ -89,12 +160,60 @@ private:
     // features
     std::vector<Feature> m_features;
 
+    // Point pool: the curve points of every street segment (in street segment order) followed by the points of every
+    // feature, in one array. The graph edges and features keep no points of their own once pooled; this saves a heap
+    // block per segment and feature and keeps geometry scans sequential.
+
+    struct PointRange {
+        uint32_t first = 0;
+        uint32_t count = 0;
+    };
+
+    std::vector<LatLon> m_points;
+    std::vector<PointRange> m_streetSegmentPoints; // by street segment ID
+    std::vector<PointRange> m_featurePoints; // by feature ID
+    std::size_t m_nCurvePoints = 0; // leading part of m_points holding curve points
+
+    LatLon pooledPoint(const PointRange& r, unsigned idx) const {
+        if (idx >= r.count)
+            throw std::out_of_range("StreetsDatabase: point idx");
+        return m_points[r.first + idx];
+    }
+
+    // names
+    NameTable m_names;
+    std::vector<uint32_t> m_streetNameIDs;
+    std::vector<uint32_t> m_poiNameIDs;
+    std::vector<uint32_t> m_poiTypeIDs;
+    std::vector<uint32_t> m_intersectionNameIDs;
+
+    void buildNames();
+
+    void poolCurvePoints();
+    void poolFeaturePoints();
+
+    /// Returns the pooled points to the graph edges and features, as the archive format stores them with their owners
+    void unpoolPoints();
+
     // serialization support
 
-    template<class Archive>void serialize(Archive& ar, const unsigned) {
+    template<class Archive>void save(Archive& ar, const unsigned) const {
+        // the copied graph has its own edges, so the edge descriptors must be rebuilt before unpooling into them
+        StreetsDatabase unpooled(*this);
+        unpooled.buildStreetSegmentVector();
+        unpooled.unpoolPoints();
+        ar & unpooled.m_roadNetwork & unpooled.m_streets & unpooled.m_pois & unpooled.m_features;
+    }
+
+    template<class Archive>void load(Archive& ar, const unsigned) {
         ar & m_roadNetwork & m_streets & m_pois & m_features;
         buildStreetSegmentVector();
+        poolCurvePoints();
+        poolFeaturePoints();
+        buildNames();
     }
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
     friend boost::serialization::access;
 };
 
@@ -7,6 +7,8 @@
 
 #include "StreetsDatabaseAPI.h"
 #include "StreetsDatabase.h"
+#include "StreetsDatabaseMMap.h"
+#include "CurrentContext.h"
 
 #include <string>
 #include <fstream>
@@ -16,10 +18,58 @@
 #include <boost/graph/adj_list_serialize.hpp>
 #include <boost/archive/binary_iarchive.hpp>
 
-StreetsDatabase streetsDB;
-
 using namespace std;
 
+// One loaded streets database
+
+class StreetsDatabaseContext {
+public:
+    StreetsDatabase db;
+
+    // when open, every query below is answered from the mapped file instead of db
+    StreetsDatabaseMMap mapped;
+};
+
+typedef CurrentContext<StreetsDatabaseContext> CurrentStreetsDatabase;
+
+namespace {
+
+StreetsDatabase& streetsDB() {
+    return CurrentStreetsDatabase::get().db;
+}
+
+StreetsDatabaseMMap& mappedStreetsDB() {
+    return CurrentStreetsDatabase::get().mapped;
+}
+}
+
+// database contexts
+
+StreetsDatabaseContext* createStreetsDatabaseContext() {
+    return new StreetsDatabaseContext;
+}
+
+void destroyStreetsDatabaseContext(StreetsDatabaseContext* context) {
+    if (context != &CurrentStreetsDatabase::defaultInstance())
+        delete context;
+}
+
+StreetsDatabaseContext* getDefaultStreetsDatabaseContext() {
+    return &CurrentStreetsDatabase::defaultInstance();
+}
+
+void selectStreetsDatabaseContext(StreetsDatabaseContext* context) {
+    CurrentStreetsDatabase::select(context);
+}
+
+void setStreetsDatabaseContextSelector(StreetsDatabaseContext* (*selector)()) {
+    CurrentStreetsDatabase::setSelector(selector);
+}
+
+StreetsDatabaseContext* bindStreetsDatabaseContext(StreetsDatabaseContext* context) {
+    return CurrentStreetsDatabase::bind(context);
+}
+
 // load the layer-2 streets database
 
 bool loadStreetsDatabaseBIN(const std::string fn) {
@@ -27,37 +77,66 @@ bool loadStreetsDatabaseBIN(const std::string fn) {
     if (!is.good())
         return false;
 
+    mappedStreetsDB().close();
+
     boost::archive::binary_iarchive ia(is);
 
-    ia & streetsDB;
+    ia & streetsDB();
+
+    return true;
+}
+
+bool loadStreetsDatabaseMMap(const std::string fn) {
+    if (!mappedStreetsDB().open(fn))
+        return false;
 
+    streetsDB() = StreetsDatabase();
     return true;
 }
 
+bool saveStreetsDatabaseMMap(const std::string fn) {
+    return writeStreetsDatabaseMMap(fn);
+}
+
+bool saveStreetsDatabaseMMap(const std::string fn, const std::vector<RoadClass>& roadClasses) {
+    return writeStreetsDatabaseMMap(fn, &roadClasses);
+}
+
 void closeStreetDatabase() {
-    streetsDB = StreetsDatabase();
+    mappedStreetsDB().close();
+    streetsDB() = StreetsDatabase();
 }
 
 // aggregate queries
 
 unsigned getNumberOfStreets() {
-    return streetsDB.streets().size();
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().numberOfStreets();
+    return streetsDB().streets().size();
 }
 
 unsigned getNumberOfStreetSegments() {
-    return num_edges(streetsDB.roads());
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().numberOfStreetSegments();
+    return num_edges(streetsDB().roads());
 }
 
 unsigned getNumberOfIntersections() {
-    return num_vertices(streetsDB.roads());
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().numberOfIntersections();
+    return num_vertices(streetsDB().roads());
 }
 
 unsigned getNumberOfPointsOfInterest() {
-    return streetsDB.getNumberOfPOIs();
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().numberOfPOIs();
+    return streetsDB().getNumberOfPOIs();
 }
 
 unsigned getNumberOfFeatures() {
-    return streetsDB.getNumberOfFeatures();
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().numberOfFeatures();
+    return streetsDB().getNumberOfFeatures();
 }
 
 
@@ -65,47 +144,39 @@ unsigned getNumberOfFeatures() {
 // Intersection information
 
 std::string getIntersectionName(unsigned intersectionID) {
-    std::set<unsigned> streetIDs;
-
-    const auto& G = streetsDB.roads();
-    const auto v = streetsDB.intersection(intersectionID);
-
-    for (const auto e : out_edges(v, G))
-        streetIDs.insert(G[e].streetVectorIndex);
-
-    auto it = streetIDs.begin();
-    stringstream ss;
-
-    if (it != streetIDs.end())
-        ss << streetsDB.streets().at(*(it++));
-
-    for (; it != streetIDs.end(); ++it)
-        ss << " & " << streetsDB.streets().at(*it);
-
-    return ss.str();
+    return getIntersectionNameView(intersectionID).to_string();
 }
 
 LatLon getIntersectionPosition(unsigned intersectionID) {
-    return (streetsDB.roads())[streetsDB.intersection(intersectionID)].latlon;
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().intersection(intersectionID).latlon;
+    return (streetsDB().roads())[streetsDB().intersection(intersectionID)].latlon;
 }
 
 OSMID getIntersectionOSMNodeID(unsigned intersectionID) {
-    return (streetsDB.roads())[streetsDB.intersection(intersectionID)].osmid;
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().intersection(intersectionID).osmid;
+    return (streetsDB().roads())[streetsDB().intersection(intersectionID)].osmid;
 }
 
 
 //number of street segments at an intersection
 
 unsigned getIntersectionStreetSegmentCount(unsigned intersectionID) {
-    return out_degree(streetsDB.intersection(intersectionID), streetsDB.roads());
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().intersection(intersectionID).segmentCount;
+    return out_degree(streetsDB().intersection(intersectionID), streetsDB().roads());
 }
 
 // find the street segments at an intersection. idx is from
 // 0..streetSegmentCount-1 (at this intersection)
 
 unsigned getIntersectionStreetSegment(unsigned intersectionID, unsigned idx) {
-    const auto& G = streetsDB.roads();
-    const auto u = streetsDB.intersection(intersectionID);
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().intersectionStreetSegment(intersectionID, idx);
+
+    const auto& G = streetsDB().roads();
+    const auto u = streetsDB().intersection(intersectionID);
 
     const auto Es = out_edges(u, G);
 
@@ -125,10 +196,13 @@ unsigned getIntersectionStreetSegment(unsigned intersectionID, unsigned idx) {
 // return info struct for the requested street segment
 
 StreetSegmentInfo getStreetSegmentInfo(unsigned streetSegmentID) {
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().streetSegmentInfo(streetSegmentID);
+
     StreetSegmentInfo info;
 
-    const PathNetwork& G = streetsDB.roads();
-    const auto e = streetsDB.streetSegment(streetSegmentID);
+    const PathNetwork& G = streetsDB().roads();
+    const auto e = streetsDB().streetSegment(streetSegmentID);
 
     info.from = source(e, G);
     info.to = target(e, G);
@@ -144,18 +218,46 @@ StreetSegmentInfo getStreetSegmentInfo(unsigned streetSegmentID) {
     info.wayOSMID = G[e].wayOSMID;
     info.streetID = G[e].streetVectorIndex;
     info.speedLimit = G[e].maxspeed;
-    info.curvePointCount = G[e].curvePoints.size();
+    info.curvePointCount = streetsDB().streetSegmentCurvePointCount(streetSegmentID);
 
     return info;
 }
 
+bool hasStreetSegmentRoadClasses() {
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().hasRoadClasses();
+    return streetsDB().hasRoadClasses();
+}
+
+RoadClass getStreetSegmentRoadClass(unsigned streetSegmentID) {
+    if (mappedStreetsDB().isOpen())
+        return static_cast<RoadClass> (mappedStreetsDB().streetSegment(streetSegmentID).roadClass);
+
+    const PathNetwork& G = streetsDB().roads();
+    return G[streetsDB().streetSegment(streetSegmentID)].roadClass;
+}
+
+bool setStreetSegmentRoadClasses(const std::vector<RoadClass>& classes) {
+    if (mappedStreetsDB().isOpen())
+        return false;
+
+    streetsDB().roadClasses(classes);
+    return true;
+}
+
 //fetch the latlon of the idx'th curve point
 
 LatLon getStreetSegmentCurvePoint(unsigned streetSegmentID, unsigned idx) {
-    const PathNetwork& G = streetsDB.roads();
-    const auto e = streetsDB.streetSegment(streetSegmentID);
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().streetSegmentCurvePoint(streetSegmentID, idx);
+
+    return streetsDB().streetSegmentCurvePoint(streetSegmentID, idx);
+}
 
-    return G[e].curvePoints.at(idx);
+const LatLon* getStreetSegmentCurvePoints(unsigned streetSegmentID) {
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().streetSegmentCurvePoints(streetSegmentID);
+    return streetsDB().streetSegmentCurvePoints(streetSegmentID);
 }
 
 
@@ -164,7 +266,60 @@ LatLon getStreetSegmentCurvePoint(unsigned streetSegmentID, unsigned idx) {
 // Street information
 
 std::string getStreetName(unsigned streetID) {
-    return streetsDB.streets().at(streetID); // throws exception if out of bounds
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().streetName(streetID);
+    return streetsDB().streets().at(streetID); // throws exception if out of bounds
+}
+
+
+
+//------------------------------------------------
+// Interned names
+
+unsigned getStreetNameID(unsigned streetID) {
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().streetNameOffset(streetID);
+    return streetsDB().streetNameID(streetID);
+}
+
+unsigned getPointOfInterestNameID(unsigned pointOfInterestID) {
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().poi(pointOfInterestID).name;
+    return streetsDB().poiNameID(pointOfInterestID);
+}
+
+unsigned getPointOfInterestTypeID(unsigned pointOfInterestID) {
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().poi(pointOfInterestID).type;
+    return streetsDB().poiTypeID(pointOfInterestID);
+}
+
+unsigned getIntersectionNameID(unsigned intersectionID) {
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().intersection(intersectionID).name;
+    return streetsDB().intersectionNameID(intersectionID);
+}
+
+boost::string_view getNameView(unsigned nameID) {
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().poolString(nameID);
+    return streetsDB().names().name(nameID);
+}
+
+boost::string_view getStreetNameView(unsigned streetID) {
+    return getNameView(getStreetNameID(streetID));
+}
+
+boost::string_view getPointOfInterestNameView(unsigned pointOfInterestID) {
+    return getNameView(getPointOfInterestNameID(pointOfInterestID));
+}
+
+boost::string_view getPointOfInterestTypeView(unsigned pointOfInterestID) {
+    return getNameView(getPointOfInterestTypeID(pointOfInterestID));
+}
+
+boost::string_view getIntersectionNameView(unsigned intersectionID) {
+    return getNameView(getIntersectionNameID(intersectionID));
 }
 
 
@@ -173,21 +328,29 @@ std::string getStreetName(unsigned streetID) {
 // Points of interest
 
 std::string getPointOfInterestType(unsigned pointOfInterestID) {
-    return streetsDB.poi(pointOfInterestID).type();
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().poolString(mappedStreetsDB().poi(pointOfInterestID).type);
+    return streetsDB().poi(pointOfInterestID).type();
 }
 
 std::string getPointOfInterestName(unsigned pointOfInterestID) {
-    return streetsDB.poi(pointOfInterestID).name();
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().poolString(mappedStreetsDB().poi(pointOfInterestID).name);
+    return streetsDB().poi(pointOfInterestID).name();
 
 }
 
 LatLon getPointOfInterestPosition(unsigned pointOfInterestID) {
-    return streetsDB.poi(pointOfInterestID).pos();
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().poi(pointOfInterestID).pos;
+    return streetsDB().poi(pointOfInterestID).pos();
 
 }
 
 OSMID getPointOfInterestOSMNodeID(unsigned pointOfInterestID) {
-    return streetsDB.poi(pointOfInterestID).osmNodeID();
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().poi(pointOfInterestID).osmid;
+    return streetsDB().poi(pointOfInterestID).osmNodeID();
 }
 
 
@@ -196,28 +359,46 @@ OSMID getPointOfInterestOSMNodeID(unsigned pointOfInterestID) {
 // Natural features
 
 FeatureType getFeatureType(unsigned featureID) {
-    return streetsDB.feature(featureID).type();
+    if (mappedStreetsDB().isOpen())
+        return (FeatureType) mappedStreetsDB().feature(featureID).type;
+    return streetsDB().feature(featureID).type();
 }
 
 const string& getFeatureName(unsigned featureID) {
-    return streetsDB.feature(featureID).name();
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().featureName(featureID);
+    return streetsDB().feature(featureID).name();
 }
 
 OSMID getFeatureOSMID(unsigned featureID) {
-    return streetsDB.feature(featureID).id().first;
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().feature(featureID).osmid;
+    return streetsDB().feature(featureID).id().first;
 
 }
 
 OSMEntityType getFeatureOSMEntityType(unsigned featureID) {
-    return streetsDB.feature(featureID).id().second;
+    if (mappedStreetsDB().isOpen())
+        return (OSMEntityType) mappedStreetsDB().feature(featureID).osmType;
+    return streetsDB().feature(featureID).id().second;
 }
 
 unsigned getFeaturePointCount(unsigned featureID) {
-    return streetsDB.feature(featureID).pointCount();
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().feature(featureID).pointCount;
+    return streetsDB().featurePointCount(featureID);
 
 }
 
 LatLon getFeaturePoint(unsigned featureID, unsigned idx) {
-    return streetsDB.feature(featureID).point(idx);
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().featurePoint(featureID, idx);
+    return streetsDB().featurePoint(featureID, idx);
+}
+
+const LatLon* getFeaturePoints(unsigned featureID) {
+    if (mappedStreetsDB().isOpen())
+        return mappedStreetsDB().featurePoints(featureID);
+    return streetsDB().featurePoints(featureID);
 }
 
@@ -1,10 +1,13 @@
 #pragma once //protects against multiple inclusions of this header file
 
 #include <string>
+#include <vector>
+#include <boost/utility/string_view.hpp>
 #include "LatLon.h"
 
 #include "Feature.h"
 #include "OSMEntityType.h"
+#include "RoadClass.h"
 
 typedef unsigned long long OSMID;
 
@@ -21,8 +24,36 @@ struct StreetSegmentInfo {
 
 
 
+// Several streets databases can be loaded at once, each held by its own StreetsDatabaseContext. Every function below
+// acts on the current context of the calling thread: the one bound to the thread by bindStreetsDatabaseContext, if any,
+// otherwise the one selected for the whole process by selectStreetsDatabaseContext, otherwise the default context.
+// Passing nullptr to either removes the binding/selection. bind returns the thread's previous binding
+class StreetsDatabaseContext;
+StreetsDatabaseContext* createStreetsDatabaseContext();
+void destroyStreetsDatabaseContext(StreetsDatabaseContext* context); // the default context is never destroyed
+StreetsDatabaseContext* getDefaultStreetsDatabaseContext();
+void selectStreetsDatabaseContext(StreetsDatabaseContext* context);
+// Once a selector is set (nullptr unsets it), threads without a binding use the context it returns rather than the
+// selected one. This lets a caller that selects the streets database together with other per-map state publish the
+// whole selection through one pointer of its own.
+void setStreetsDatabaseContextSelector(StreetsDatabaseContext* (*selector)());
+StreetsDatabaseContext* bindStreetsDatabaseContext(StreetsDatabaseContext* context);
+
 // load the layer-2 streets database
 bool loadStreetsDatabaseBIN(std::string);
+
+// load the layer-2 streets database from its memory-mapped form (see StreetsDatabaseMMap.h),
+// returns false if the file is missing or was written by an incompatible version
+bool loadStreetsDatabaseMMap(std::string);
+
+// write the currently loaded streets database in memory-mapped form, for loadStreetsDatabaseMMap
+bool saveStreetsDatabaseMMap(std::string);
+
+// as above, but storing roadClasses (indexed by street segment ID) as the road classes. This is how classes
+// derived after loading a memory-mapped database without them get saved, since that database is read-only.
+// The file is replaced atomically, so it may be the one currently mapped.
+bool saveStreetsDatabaseMMap(std::string, const std::vector<RoadClass>& roadClasses);
+
 void closeStreetDatabase();
 
 // aggregate queries
@@ -60,6 +91,20 @@ StreetSegmentInfo getStreetSegmentInfo(unsigned streetSegmentID);
 //fetch the latlon of the idx'th curve point
 LatLon getStreetSegmentCurvePoint(unsigned streetSegmentID, unsigned idx);
 
+//all curvePointCount curve points of a street segment, stored contiguously
+//(valid until the database is closed)
+const LatLon* getStreetSegmentCurvePoints(unsigned streetSegmentID);
+
+//road class (from the OSM highway tag) of a segment. Databases saved before road classes
+//were added have none (RoadClass::None) until they are set with setStreetSegmentRoadClasses
+bool hasStreetSegmentRoadClasses();
+RoadClass getStreetSegmentRoadClass(unsigned streetSegmentID);
+
+//set the road class of every segment (indexed by street segment ID), e.g. as derived from the
+//OSM database; saveStreetsDatabaseMMap then stores them. Returns false for a memory-mapped database,
+//whose classes can only be changed by saving the file again with saveStreetsDatabaseMMap(fn, classes).
+bool setStreetSegmentRoadClasses(const std::vector<RoadClass>& classes);
+
 
 
 //------------------------------------------------
@@ -69,6 +114,27 @@ std::string getStreetName(unsigned streetID);
 
 
 
+//------------------------------------------------
+// Interned names
+// Street names, POI names and types and intersection names are stored once per distinct string. Each has a name ID:
+// two names are equal exactly when their IDs are (IDs are not necessarily consecutive). The views point into the
+// database and are valid until it is closed, so these do not allocate.
+// Throws std::out_of_range exception if an ID is out of range
+
+unsigned getStreetNameID(unsigned streetID);
+unsigned getPointOfInterestNameID(unsigned pointOfInterestID);
+unsigned getPointOfInterestTypeID(unsigned pointOfInterestID);
+unsigned getIntersectionNameID(unsigned intersectionID);
+
+boost::string_view getNameView(unsigned nameID);
+
+boost::string_view getStreetNameView(unsigned streetID);
+boost::string_view getPointOfInterestNameView(unsigned pointOfInterestID);
+boost::string_view getPointOfInterestTypeView(unsigned pointOfInterestID);
+boost::string_view getIntersectionNameView(unsigned intersectionID); // precomputed getIntersectionName
+
+
+
 //------------------------------------------------
 // Points of interest
 
@@ -88,3 +154,4 @@ OSMID getFeatureOSMID(unsigned featureID);
 OSMEntityType getFeatureOSMEntityType(unsigned featureID);
 unsigned getFeaturePointCount(unsigned featureID);
 LatLon getFeaturePoint(unsigned featureID, unsigned idx);
+const LatLon* getFeaturePoints(unsigned featureID); // all getFeaturePointCount points, as for curve points
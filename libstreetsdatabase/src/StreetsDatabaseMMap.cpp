@@ -0,0 +1,301 @@
+/*
+ * StreetsDatabaseMMap.cpp
+ *
+ *  Reader and writer for the memory-mapped streets database format (see StreetsDatabaseMMap.h).
+ */
+
+#include "StreetsDatabaseMMap.h"
+#include "StreetsDatabaseAPI.h"
+
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+const char mmapMagic[8] = "STRMMAP";
+}
+
+bool StreetsDatabaseMMap::open(const std::string& fn) {
+    close();
+
+    if (!m_file.open(fn) || m_file.size() < sizeof(MMapStreetsHeader))
+        return false;
+
+    const MMapStreetsHeader* h = reinterpret_cast<const MMapStreetsHeader*> (m_file.data());
+
+    if (memcmp(h->magic, mmapMagic, sizeof(mmapMagic)) != 0 || h->version != version ||
+            h->headerSize != sizeof(MMapStreetsHeader) || h->fileSize != m_file.size()) {
+        m_file.close();
+        return false;
+    }
+
+    m_header = h;
+    m_intersections = m_file.section<MMapIntersection>(h->intersectionsOffset, h->nIntersections);
+    m_intersectionSegments = m_file.section<uint32_t>(h->intersectionSegmentsOffset, h->nIntersectionSegments);
+    m_streetSegments = m_file.section<MMapStreetSegment>(h->streetSegmentsOffset, h->nStreetSegments);
+    m_curvePoints = m_file.section<LatLon>(h->curvePointsOffset, h->nCurvePoints);
+    m_streets = m_file.section<uint32_t>(h->streetsOffset, h->nStreets);
+    m_pois = m_file.section<MMapPOI>(h->poisOffset, h->nPOIs);
+    m_features = m_file.section<MMapFeature>(h->featuresOffset, h->nFeatures);
+    m_featurePoints = m_file.section<LatLon>(h->featurePointsOffset, h->nFeaturePoints);
+    m_chars = m_file.section<char>(h->charsOffset, h->nChars);
+
+    if (!m_intersections || !m_intersectionSegments || !m_streetSegments || !m_curvePoints || !m_streets ||
+            !m_pois || !m_features || !m_featurePoints || !m_chars || h->nChars == 0 || m_chars[h->nChars - 1] != '\0' ||
+            !validRecords()) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+namespace {
+
+/// True if [first, first + count) lies within an array of size n; widened so the sum cannot wrap
+bool inRange(uint32_t first, uint32_t count, uint64_t n) {
+    return uint64_t(first) + count <= n;
+}
+}
+
+bool StreetsDatabaseMMap::validRecords() const {
+    const MMapStreetsHeader& h = *m_header;
+
+    for (unsigned i = 0; i < h.nIntersections; ++i) {
+        const MMapIntersection& r = m_intersections[i];
+        if (!inRange(r.firstSegment, r.segmentCount, h.nIntersectionSegments) || r.name >= h.nChars)
+            return false;
+    }
+
+    for (uint64_t k = 0; k < h.nIntersectionSegments; ++k)
+        if (m_intersectionSegments[k] >= h.nStreetSegments)
+            return false;
+
+    for (unsigned s = 0; s < h.nStreetSegments; ++s) {
+        const MMapStreetSegment& r = m_streetSegments[s];
+        if (r.from >= h.nIntersections || r.to >= h.nIntersections || r.streetID >= h.nStreets ||
+                !inRange(r.firstCurvePoint, r.curvePointCount, h.nCurvePoints) ||
+                r.roadClass > static_cast<uint8_t> (RoadClass::Other))
+            return false;
+    }
+
+    for (unsigned s = 0; s < h.nStreets; ++s)
+        if (m_streets[s] >= h.nChars)
+            return false;
+
+    for (unsigned p = 0; p < h.nPOIs; ++p)
+        if (m_pois[p].name >= h.nChars || m_pois[p].type >= h.nChars)
+            return false;
+
+    for (unsigned f = 0; f < h.nFeatures; ++f) {
+        const MMapFeature& r = m_features[f];
+        if (r.name >= h.nChars || r.type > Stream || r.osmType > Relation ||
+                !inRange(r.firstPoint, r.pointCount, h.nFeaturePoints))
+            return false;
+    }
+
+    return true;
+}
+
+void StreetsDatabaseMMap::close() {
+    m_file.close();
+    m_header = nullptr;
+    m_featureNames.clear();
+}
+
+const MMapIntersection& StreetsDatabaseMMap::intersection(unsigned intersectionID) const {
+    if (intersectionID >= m_header->nIntersections)
+        throw std::out_of_range("StreetsDatabaseMMap: intersectionID");
+    return m_intersections[intersectionID];
+}
+
+unsigned StreetsDatabaseMMap::intersectionStreetSegment(unsigned intersectionID, unsigned idx) const {
+    const MMapIntersection& i = intersection(intersectionID);
+    if (idx >= i.segmentCount)
+        throw std::out_of_range("getIntersectionStreetSegment: idx");
+    return m_intersectionSegments[i.firstSegment + idx];
+}
+
+const MMapStreetSegment& StreetsDatabaseMMap::streetSegment(unsigned streetSegmentID) const {
+    if (streetSegmentID >= m_header->nStreetSegments)
+        throw std::out_of_range("StreetsDatabaseMMap: streetSegmentID");
+    return m_streetSegments[streetSegmentID];
+}
+
+StreetSegmentInfo StreetsDatabaseMMap::streetSegmentInfo(unsigned streetSegmentID) const {
+    const MMapStreetSegment& s = streetSegment(streetSegmentID);
+    StreetSegmentInfo info;
+
+    info.wayOSMID = s.wayOSMID;
+    info.from = s.from;
+    info.to = s.to;
+    info.oneWay = s.oneWay;
+    info.curvePointCount = s.curvePointCount;
+    info.speedLimit = s.speedLimit;
+    info.streetID = s.streetID;
+
+    return info;
+}
+
+LatLon StreetsDatabaseMMap::streetSegmentCurvePoint(unsigned streetSegmentID, unsigned idx) const {
+    const MMapStreetSegment& s = streetSegment(streetSegmentID);
+    if (idx >= s.curvePointCount)
+        throw std::out_of_range("StreetsDatabaseMMap: curve point idx");
+    return m_curvePoints[s.firstCurvePoint + idx];
+}
+
+const char* StreetsDatabaseMMap::streetName(unsigned streetID) const {
+    if (streetID >= m_header->nStreets)
+        throw std::out_of_range("StreetsDatabaseMMap: streetID");
+    return m_chars + m_streets[streetID];
+}
+
+const MMapPOI& StreetsDatabaseMMap::poi(unsigned poiID) const {
+    if (poiID >= m_header->nPOIs)
+        throw std::out_of_range("StreetsDatabaseMMap: poiID");
+    return m_pois[poiID];
+}
+
+const MMapFeature& StreetsDatabaseMMap::feature(unsigned featureID) const {
+    if (featureID >= m_header->nFeatures)
+        throw std::out_of_range("StreetsDatabaseMMap: featureID");
+    return m_features[featureID];
+}
+
+const std::string& StreetsDatabaseMMap::featureName(unsigned featureID) const {
+    feature(featureID); // range check
+
+    std::lock_guard<std::mutex> lock(m_featureNamesMutex);
+    if (m_featureNames.empty()) {
+        m_featureNames.reserve(m_header->nFeatures);
+        for (unsigned f = 0; f < m_header->nFeatures; ++f)
+            m_featureNames.emplace_back(m_chars + m_features[f].name);
+    }
+    return m_featureNames[featureID];
+}
+
+LatLon StreetsDatabaseMMap::featurePoint(unsigned featureID, unsigned idx) const {
+    const MMapFeature& f = feature(featureID);
+    if (idx >= f.pointCount)
+        throw std::out_of_range("StreetsDatabaseMMap: feature point idx");
+    return m_featurePoints[f.firstPoint + idx];
+}
+
+bool writeStreetsDatabaseMMap(const std::string& fn, const std::vector<RoadClass>* roadClassesOverride) {
+    if (roadClassesOverride && roadClassesOverride->size() != getNumberOfStreetSegments())
+        return false;
+
+    MMapStreetsHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, mmapMagic, sizeof(mmapMagic));
+    h.version = StreetsDatabaseMMap::version;
+    h.headerSize = sizeof(MMapStreetsHeader);
+
+    h.nIntersections = getNumberOfIntersections();
+    h.nStreetSegments = getNumberOfStreetSegments();
+    h.nStreets = getNumberOfStreets();
+    h.nPOIs = getNumberOfPointsOfInterest();
+    h.nFeatures = getNumberOfFeatures();
+
+    const bool roadClasses = roadClassesOverride || hasStreetSegmentRoadClasses();
+    if (roadClasses)
+        h.flags |= MMapHasRoadClasses;
+
+    MMapStringPool pool;
+    pool.add("");
+
+    vector<MMapIntersection> intersections(h.nIntersections);
+    vector<uint32_t> intersectionSegments;
+    for (unsigned i = 0; i < h.nIntersections; ++i) {
+        MMapIntersection& r = intersections[i]; // value-initialized, so the padding is zero
+        r.osmid = getIntersectionOSMNodeID(i);
+        r.latlon = getIntersectionPosition(i);
+        r.firstSegment = intersectionSegments.size();
+        r.segmentCount = getIntersectionStreetSegmentCount(i);
+        r.name = pool.add(getIntersectionName(i));
+        for (unsigned s = 0; s < r.segmentCount; ++s)
+            intersectionSegments.push_back(getIntersectionStreetSegment(i, s));
+    }
+
+    vector<MMapStreetSegment> segments(h.nStreetSegments);
+    vector<LatLon> curvePoints;
+    for (unsigned s = 0; s < h.nStreetSegments; ++s) {
+        const StreetSegmentInfo info = getStreetSegmentInfo(s);
+        MMapStreetSegment& r = segments[s];
+        memset(&r, 0, sizeof(r));
+        r.wayOSMID = info.wayOSMID;
+        r.from = info.from;
+        r.to = info.to;
+        r.streetID = info.streetID;
+        r.firstCurvePoint = curvePoints.size();
+        r.curvePointCount = info.curvePointCount;
+        r.speedLimit = info.speedLimit;
+        r.oneWay = info.oneWay;
+        if (roadClassesOverride)
+            r.roadClass = static_cast<uint8_t> ((*roadClassesOverride)[s]);
+        else
+            r.roadClass = static_cast<uint8_t> (roadClasses ? getStreetSegmentRoadClass(s) : RoadClass::None);
+        for (unsigned c = 0; c < info.curvePointCount; ++c)
+            curvePoints.push_back(getStreetSegmentCurvePoint(s, c));
+    }
+
+    vector<uint32_t> streets(h.nStreets);
+    for (unsigned s = 0; s < h.nStreets; ++s)
+        streets[s] = pool.add(getStreetName(s));
+
+    vector<MMapPOI> pois(h.nPOIs);
+    for (unsigned p = 0; p < h.nPOIs; ++p) {
+        pois[p].osmid = getPointOfInterestOSMNodeID(p);
+        pois[p].pos = getPointOfInterestPosition(p);
+        pois[p].name = pool.add(getPointOfInterestName(p));
+        pois[p].type = pool.add(getPointOfInterestType(p));
+    }
+
+    vector<MMapFeature> features(h.nFeatures);
+    vector<LatLon> featurePoints;
+    for (unsigned f = 0; f < h.nFeatures; ++f) {
+        MMapFeature& r = features[f];
+        memset(&r, 0, sizeof(r));
+        r.osmid = getFeatureOSMID(f);
+        r.type = getFeatureType(f);
+        r.osmType = getFeatureOSMEntityType(f);
+        r.name = pool.add(getFeatureName(f));
+        r.firstPoint = featurePoints.size();
+        r.pointCount = getFeaturePointCount(f);
+        for (unsigned c = 0; c < r.pointCount; ++c)
+            featurePoints.push_back(getFeaturePoint(f, c));
+    }
+
+    h.nIntersectionSegments = intersectionSegments.size();
+    h.nCurvePoints = curvePoints.size();
+    h.nFeaturePoints = featurePoints.size();
+    h.nChars = pool.chars().size();
+
+    // lay the sections out in the order they are written
+    MMapLayout layout(sizeof(MMapStreetsHeader));
+    h.intersectionsOffset = layout.place(intersections);
+    h.intersectionSegmentsOffset = layout.place(intersectionSegments);
+    h.streetSegmentsOffset = layout.place(segments);
+    h.curvePointsOffset = layout.place(curvePoints);
+    h.streetsOffset = layout.place(streets);
+    h.poisOffset = layout.place(pois);
+    h.featuresOffset = layout.place(features);
+    h.featurePointsOffset = layout.place(featurePoints);
+    h.charsOffset = layout.place(pool.chars());
+    h.fileSize = layout.size();
+
+    MMapWriter writer(fn);
+    writer.header(h);
+    writer.section(intersections);
+    writer.section(intersectionSegments);
+    writer.section(segments);
+    writer.section(curvePoints);
+    writer.section(streets);
+    writer.section(pois);
+    writer.section(features);
+    writer.section(featurePoints);
+    writer.section(pool.chars());
+
+    return writer.commit(h.fileSize);
+}
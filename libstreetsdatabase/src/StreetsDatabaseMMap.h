@@ -0,0 +1,222 @@
+/*
+ * StreetsDatabaseMMap.h
+ *
+ *  Flat, offset-based on-disk form of the layer-2 streets database.
+ *
+ *  The file is a fixed header followed by plain arrays (intersections, per-intersection segment lists, street segments,
+ *  curve points, streets, POIs, features, feature points) and a pool of null-terminated strings. Every cross-reference
+ *  is an array index or a byte offset into the string pool, so the file can be mmap'ed read-only and queried in place;
+ *  opening a map costs page faults rather than a boost deserialization, and processes on the same host share the pages.
+ *
+ *  The layout is native-endian and only meant to be read back on the machine (architecture) that wrote it.
+ */
+
+#ifndef STREETSDATABASEMMAP_H_
+#define STREETSDATABASEMMAP_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <stdexcept>
+
+#include "LatLon.h"
+#include "Feature.h"
+#include "MMapFile.h"
+#include "OSMEntityType.h"
+#include "RoadClass.h"
+
+struct StreetSegmentInfo;
+
+/// On-disk records. All are POD with explicit padding so the layout does not depend on compiler packing.
+
+struct MMapStreetsHeader {
+    char magic[8]; // "STRMMAP\0"
+    uint32_t version;
+    uint32_t headerSize; // sizeof(MMapStreetsHeader) when written; guards against layout changes
+
+    uint32_t nIntersections;
+    uint32_t nStreetSegments;
+    uint32_t nStreets;
+    uint32_t nPOIs;
+    uint32_t nFeatures;
+    uint32_t flags; // MMapStreetsFlags
+
+    uint64_t nIntersectionSegments; // total length of the per-intersection segment lists
+    uint64_t nCurvePoints;
+    uint64_t nFeaturePoints;
+    uint64_t nChars; // size of the string pool
+
+    // byte offsets of each section from the start of the file
+    uint64_t intersectionsOffset;
+    uint64_t intersectionSegmentsOffset;
+    uint64_t streetSegmentsOffset;
+    uint64_t curvePointsOffset;
+    uint64_t streetsOffset;
+    uint64_t poisOffset;
+    uint64_t featuresOffset;
+    uint64_t featurePointsOffset;
+    uint64_t charsOffset;
+    uint64_t fileSize;
+};
+
+enum MMapStreetsFlags : uint32_t {
+    MMapHasRoadClasses = 1 // MMapStreetSegment::roadClass is set
+};
+
+struct MMapIntersection {
+    OSMID osmid;
+    LatLon latlon;
+    uint32_t firstSegment; // index into the intersection segment list
+    uint32_t segmentCount;
+    uint32_t name; // string pool offset
+    uint32_t padding;
+};
+
+struct MMapStreetSegment {
+    OSMID wayOSMID;
+    uint32_t from, to; // already oriented as getStreetSegmentInfo reports them
+    uint32_t streetID;
+    uint32_t firstCurvePoint;
+    uint32_t curvePointCount;
+    float speedLimit;
+    uint8_t oneWay;
+    uint8_t roadClass; // RoadClass
+    uint8_t padding[6];
+};
+
+struct MMapPOI {
+    OSMID osmid;
+    LatLon pos;
+    uint32_t name; // string pool offsets
+    uint32_t type;
+};
+
+struct MMapFeature {
+    OSMID osmid;
+    uint32_t type; // FeatureType
+    uint32_t osmType; // OSMEntityType
+    uint32_t name; // string pool offset
+    uint32_t firstPoint;
+    uint32_t pointCount;
+    uint32_t padding;
+};
+
+/** Read-only view of a memory-mapped streets database file.
+ *
+ * Accessors mirror StreetsDatabaseAPI.h and throw std::out_of_range on bad IDs/indices, like the boost-loaded database.
+ */
+
+class StreetsDatabaseMMap {
+public:
+    static const uint32_t version = 3;
+
+    StreetsDatabaseMMap() {
+    }
+
+    ~StreetsDatabaseMMap() {
+        close();
+    }
+
+    StreetsDatabaseMMap(const StreetsDatabaseMMap&) = delete;
+    StreetsDatabaseMMap& operator=(const StreetsDatabaseMMap&) = delete;
+
+    /// Maps the file read-only; returns false (leaving the object closed) if it is missing, truncated, of another
+    /// version, or has a record whose index, range or string offset points outside its section
+    bool open(const std::string& fn);
+    void close();
+
+    bool isOpen() const {
+        return m_file.isOpen();
+    }
+
+    unsigned numberOfIntersections() const {
+        return m_header->nIntersections;
+    }
+
+    unsigned numberOfStreetSegments() const {
+        return m_header->nStreetSegments;
+    }
+
+    unsigned numberOfStreets() const {
+        return m_header->nStreets;
+    }
+
+    unsigned numberOfPOIs() const {
+        return m_header->nPOIs;
+    }
+
+    unsigned numberOfFeatures() const {
+        return m_header->nFeatures;
+    }
+
+    bool hasRoadClasses() const {
+        return m_header->flags & MMapHasRoadClasses;
+    }
+
+    const MMapIntersection& intersection(unsigned intersectionID) const;
+    unsigned intersectionStreetSegment(unsigned intersectionID, unsigned idx) const;
+    const char* intersectionName(unsigned intersectionID) const {
+        return m_chars + intersection(intersectionID).name;
+    }
+
+    const MMapStreetSegment& streetSegment(unsigned streetSegmentID) const;
+    StreetSegmentInfo streetSegmentInfo(unsigned streetSegmentID) const;
+    LatLon streetSegmentCurvePoint(unsigned streetSegmentID, unsigned idx) const;
+
+    const LatLon* streetSegmentCurvePoints(unsigned streetSegmentID) const {
+        return m_curvePoints + streetSegment(streetSegmentID).firstCurvePoint;
+    }
+
+    const char* streetName(unsigned streetID) const;
+
+    const MMapPOI& poi(unsigned poiID) const;
+
+    const MMapFeature& feature(unsigned featureID) const;
+    const std::string& featureName(unsigned featureID) const;
+    LatLon featurePoint(unsigned featureID, unsigned idx) const;
+
+    const LatLon* featurePoints(unsigned featureID) const {
+        return m_featurePoints + feature(featureID).firstPoint;
+    }
+
+    /// The pool holds each distinct string once, so offsets double as name IDs
+
+    uint32_t streetNameOffset(unsigned streetID) const {
+        streetName(streetID); // range check
+        return m_streets[streetID];
+    }
+
+    const char* poolString(uint32_t offset) const {
+        if (offset >= m_header->nChars)
+            throw std::out_of_range("StreetsDatabaseMMap: string offset");
+        return m_chars + offset;
+    }
+
+private:
+    /// Checks every cross-reference once, so the accessors can index the sections after checking only the ID
+    bool validRecords() const;
+
+    MappedFile m_file;
+
+    const MMapStreetsHeader* m_header = nullptr;
+    const MMapIntersection* m_intersections = nullptr;
+    const uint32_t* m_intersectionSegments = nullptr;
+    const MMapStreetSegment* m_streetSegments = nullptr;
+    const LatLon* m_curvePoints = nullptr;
+    const uint32_t* m_streets = nullptr;
+    const MMapPOI* m_pois = nullptr;
+    const MMapFeature* m_features = nullptr;
+    const LatLon* m_featurePoints = nullptr;
+    const char* m_chars = nullptr;
+
+    // getFeatureName returns a reference, so feature names are materialized on first use
+    mutable std::mutex m_featureNamesMutex;
+    mutable std::vector<std::string> m_featureNames;
+};
+
+/// Writes the streets database currently loaded through StreetsDatabaseAPI.h to fn in the format above. If
+/// roadClassesOverride is given (one per street segment) it is stored in place of the database's own road classes.
+bool writeStreetsDatabaseMMap(const std::string& fn, const std::vector<RoadClass>* roadClassesOverride = nullptr);
+
+#endif /* STREETSDATABASEMMAP_H_ */
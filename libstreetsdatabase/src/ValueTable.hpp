@@ -8,14 +8,18 @@
 #ifndef VALUETABLE_HPP_
 #define VALUETABLE_HPP_
 
+#include <algorithm>
 #include <string>
 #include <functional>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 #include <boost/serialization/serialization.hpp>
 #include <boost/serialization/vector.hpp>
 
 /** Wrapper on a vector of strings with a restricted interface to permit insertion only.
- * The container does not guarantee uniqueness, and values are in insertion order (not sorted) so inverse-lookup is linear time.
+ * The container does not guarantee uniqueness, and values are in insertion order (not sorted). Inverse lookup goes through
+ * a hash index built on first use (and not serialized), so it is constant time after one linear pass.
  */
 
 class ValueTable {
@@ -24,6 +28,7 @@ public:
 
     unsigned addValue(const std::string v) {
         values_.push_back(v);
+        index_.add(v, values_.size() - 1);
         return values_.size() - 1;
     }
 
@@ -39,14 +44,11 @@ public:
         return vi < values_.size();
     }
 
-    /// Linear-time search for the index of a string value value within the table, returning -1U if not found
+    /// Index of the first occurrence of a string value within the table, returning -1U if not found.
+    /// Builds the hash index on the first call; safe to call concurrently.
 
     unsigned getIndexOfValue(const std::string v) const {
-        auto it = find(values_.begin(), values_.end(), v);
-        if (it == values_.end())
-            return -1U;
-        else
-            return it - values_.begin();
+        return index_.find(values_, v);
     }
 
     /// Function object which takes an unsigned index and returns the corresponding string
@@ -67,8 +69,61 @@ private:
     /// Vector of all strings in insertion order (unsorted)
     std::vector<std::string> values_;
 
+    /// Hash index from each value to the index of its first occurrence, built lazily
+
+    class Index {
+    public:
+
+        Index() {
+        }
+
+        // a copy builds its own index when first used
+
+        Index(const Index&) {
+        }
+
+        Index& operator=(const Index&) {
+            reset();
+            return *this;
+        }
+
+        unsigned find(const std::vector<std::string>& values, const std::string& v) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!built_) {
+                map_.reserve(values.size());
+                for (unsigned i = 0; i < values.size(); ++i)
+                    map_.insert(std::make_pair(values[i], i)); // keeps the first occurrence
+                built_ = true;
+            }
+
+            const auto it = map_.find(v);
+            return it == map_.end() ? -1U : it->second;
+        }
+
+        void add(const std::string& v, unsigned i) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (built_)
+                map_.insert(std::make_pair(v, i));
+        }
+
+        void reset() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            map_.clear();
+            built_ = false;
+        }
+
+    private:
+        std::mutex mutex_;
+        bool built_ = false;
+        std::unordered_map<std::string, unsigned> map_;
+    };
+
+    mutable Index index_;
+
     template<class Archive>void serialize(Archive& ar, const unsigned ver) {
         ar & values_;
+        if (Archive::is_loading::value)
+            index_.reset();
     }
     friend class boost::serialization::access;
 };
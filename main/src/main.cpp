@@ -3,13 +3,24 @@
 #include "mapping_constants.h"
 #include "m1.h"
 #include "m2.h"
+#include "MapContext.h"
+#include "MapPreloader.h"
+#include <memory>
 #include <string>
+#include <utility>
 
 using namespace std;
 
-int main() {
+int main(int argc, char** argv) {
     bool loadSuccess;
     
+    // --timings reports how long each stage of loading a map took
+    bool showLoadTimings = false;
+    for(int arg = 1; arg < argc; arg++) {
+        if(string(argv[arg]) == "--timings")
+            showLoadTimings = true;
+    }
+    
     // map file names for loading
     const unsigned numOfMaps = 7;
     const string CAIRO      = "cairo_egypt";
@@ -20,6 +31,23 @@ int main() {
     const string ST_HELENA  = "saint_helena";
     const string TORONTO    = "toronto";
     
+    // in menu order
+    const string cityNames[numOfMaps] = {CAIRO, HAMILTON, LONDON, MOSCOW, NEWYORK, ST_HELENA, TORONTO};
+    const string mapDirectory = "/cad2/ece297s/public/maps/";
+    
+    // The city being shown, kept loaded in case it is picked again, and the
+    // one shown before it, kept on standby since it is the one most often
+    // picked next. Older cities are freed, so at most these two and the
+    // preloaded one are resident.
+    unique_ptr<MapContext> shownCity;
+    unsigned shownCityNumber = 0;
+    unique_ptr<MapContext> previousCity;
+    unsigned previousCityNumber = 0;
+    
+    // While a map is shown, the next city (in menu order) is also loaded in
+    // the background, so picking it is instant too
+    MapPreloader preloader;
+    
     // map parser
     do {
         cout 
@@ -79,18 +107,61 @@ int main() {
         else if(input == 6) cityName = ST_HELENA;
         else if(input == 7) cityName = TORONTO;
         
-        // Set the map file name
-        string mapFileName = "/cad2/ece297s/public/maps/" + cityName + ".streets.bin";
-        loadSuccess = load_map(mapFileName);
+        // Load the map, unless it is already shown, was shown before it or
+        // was preloaded
+        string mapFileName = mapDirectory + cityName + ".streets.bin";
+        if(shownCity && shownCityNumber == input) {
+            loadSuccess = true;
+        }
+        else if(previousCity && previousCityNumber == input) {
+            MapContext::select(*previousCity);
+            swap(shownCity, previousCity);
+            swap(shownCityNumber, previousCityNumber);
+            loadSuccess = true;
+        }
+        else {
+            unique_ptr<MapContext> city = preloader.take(mapFileName);
+            if(city) {
+                loadSuccess = true;
+            }
+            else {
+                city.reset(new MapContext);
+                loadSuccess = city->load(mapFileName);
+            }
+            
+            if(showLoadTimings) {
+                for(auto& stage : city->getLoadMapTimings())
+                    cout << "    " << stage.first << ": " << stage.second << " s" << endl;
+            }
+            
+            // The city shown before the previous one can only be freed once
+            // it isn't selected
+            if(loadSuccess) {
+                MapContext::select(*city);
+                previousCity = move(shownCity);
+                previousCityNumber = shownCityNumber;
+                shownCity = move(city);
+                shownCityNumber = input;
+            }
+        }
         
         // Open up the map
         if(loadSuccess) {
+            // Unless the next city is already resident as the previous one
+            unsigned nextCity = input % numOfMaps;
+            if(!previousCity || previousCityNumber != nextCity + 1)
+                preloader.preload(mapDirectory + cityNames[nextCity] + ".streets.bin");
+            
             draw_map();
         }
-        
-        close_map();
     } while(loadSuccess); // Continue drawing maps until user exits program
     
+    // Free the maps (whose kd trees need ANN) before closing ANN
+    preloader.clear();
+    MapContext::select(MapContext::getDefault());
+    shownCity.reset();
+    previousCity.reset();
+    
     annClose(); // Necessary cleanup for external kd_tree 
 
 }
\ No newline at end of file